@@ -0,0 +1,166 @@
+/* ========== Pin Status ========== */
+// Renders /api/pins and the live pin levels pushed on /pin-status/events.
+// The table is fetched again when the device reports a pin state change;
+// without EventSource the page falls back to polling, answered with 304
+// while the pin state is unchanged.
+
+const PIN_ATTACHED = 1;
+const PIN_BROKEN = 2;
+const PIN_RESERVED = 4;
+const PIN_CONFIGURED = 8;
+
+const CAP_EXISTS = 0x0001;
+const PIN_COLUMNS = [
+	['ADC', 0x0008 | 0x0010],
+	['Touch', 0x0020],
+	['RTC / Deep Sleep', 0x0080],
+	['PWM', 0x0100],
+	['Strapping', 0x0040],
+	['Input Only', 0x0004],
+];
+const PIN_MODES = [
+	['mode-undefined', 'UNDEFINED'],
+	['mode-input', 'INPUT'],
+	['mode-output', 'OUTPUT'],
+];
+const PIN_REFRESH_MS = 2000;
+
+let pinStatusTag = null;
+const pinLevels = new Map();
+
+function pinStatus(caps, state, ref) {
+	const blocked = state & (PIN_BROKEN | PIN_RESERVED);
+	const inUse = !blocked && ref !== 0;
+	if (!(caps & CAP_EXISTS)) {
+		return ['status-not-configured', 'NOT PRESENT'];
+	}
+	if (!(state & PIN_CONFIGURED)) {
+		return inUse
+			? ['status-used', 'IN USE']
+			: ['status-not-configured', 'NOT CONFIGURED'];
+	}
+	if (blocked) {
+		return ['status-broken', state & PIN_BROKEN ? 'BROKEN' : 'RESERVED'];
+	}
+	if (state & PIN_ATTACHED || inUse) {
+		return ['status-used', inUse ? 'IN USE' : 'USED'];
+	}
+	return ['status-available', 'AVAILABLE'];
+}
+
+function pinCell(text, className) {
+	const cell = document.createElement('td');
+	if (className) {
+		cell.className = className;
+	}
+	cell.textContent = text;
+	return cell;
+}
+
+function renderPinHeader() {
+	const row = document.getElementById('pin-header');
+	const titles = ['Pin #', 'GPIO', 'Status', 'Level', 'Mode', 'Pin Type'];
+	PIN_COLUMNS.forEach((column) => titles.push(column[0]));
+	titles.push('UI Ref');
+	titles.forEach((title) => {
+		const th = document.createElement('th');
+		th.textContent = title;
+		row.appendChild(th);
+	});
+}
+
+function renderPins(data) {
+	document.getElementById('pin-board').textContent = data.board;
+	document.getElementById('pin-total').textContent = data.pins.length;
+
+	const body = document.getElementById('pin-rows');
+	const rows = document.createDocumentFragment();
+	data.pins.forEach(([gpio, caps, state, ref, mode, type]) => {
+		const row = document.createElement('tr');
+		const status = pinStatus(caps, state, ref);
+		const configured = state & PIN_CONFIGURED;
+		const pinMode = configured
+			? PIN_MODES[mode] || PIN_MODES[0]
+			: ['mode-undefined', 'NOT CONFIGURED'];
+		const blocked = state & (PIN_BROKEN | PIN_RESERVED);
+
+		row.appendChild(pinCell(gpio, 'pin-number'));
+		row.appendChild(pinCell(gpio, 'pin-number'));
+		row.appendChild(pinCell(status[1], status[0]));
+		const level = pinCell('-', 'level');
+		level.id = 'level-' + gpio;
+		row.appendChild(level);
+		row.appendChild(pinCell(pinMode[1], pinMode[0]));
+		row.appendChild(pinCell(configured ? type : 'None', 'pin-type'));
+		PIN_COLUMNS.forEach((column) => {
+			const flag = caps & column[1];
+			row.appendChild(
+				pinCell(flag ? 'YES' : 'NO', flag ? 'flag-yes' : 'flag-no')
+			);
+		});
+		row.appendChild(pinCell(blocked ? 'BLOCKED' : ref || '-'));
+		rows.appendChild(row);
+	});
+	body.replaceChildren(rows);
+	pinLevels.forEach((value, gpio) => showLevel(gpio));
+}
+
+function showLevel(gpio) {
+	const cell = document.getElementById('level-' + gpio);
+	if (!cell) {
+		return;
+	}
+	const value = pinLevels.get(gpio);
+	if (value === undefined) {
+		cell.textContent = '-';
+		cell.className = 'level';
+	} else if (value === 0 || value === 1) {
+		cell.textContent = value ? 'HIGH' : 'LOW';
+		cell.className = value ? 'level level-high' : 'level level-low';
+	} else {
+		cell.textContent = value;
+		cell.className = 'level';
+	}
+}
+
+// {"t": ms, "p": [[gpio, value], ...]}, a null value stops the pin
+function applyLevels(diff) {
+	diff.p.forEach(([gpio, value]) => {
+		if (value === null) {
+			pinLevels.delete(gpio);
+		} else {
+			pinLevels.set(gpio, value);
+		}
+		showLevel(gpio);
+	});
+}
+
+async function refreshPins() {
+	try {
+		const response = await fetch('/api/pins', { cache: 'no-cache' });
+		if (!response.ok) {
+			return;
+		}
+		// A revalidated 304 arrives here as the cached 200 with the same tag
+		const tag = response.headers.get('ETag');
+		if (tag !== null && tag === pinStatusTag) {
+			return;
+		}
+		pinStatusTag = tag;
+		renderPins(await response.json());
+	} catch (error) {
+		console.error('Pin status refresh failed', error);
+	}
+}
+
+renderPinHeader();
+refreshPins();
+if (window.EventSource) {
+	const events = new EventSource('/pin-status/events');
+	events.addEventListener('levels', (event) =>
+		applyLevels(JSON.parse(event.data))
+	);
+	events.addEventListener('pins', refreshPins);
+} else {
+	setInterval(refreshPins, PIN_REFRESH_MS);
+}
@@ -537,6 +537,33 @@ function closeModal() {
 	}
 }
 
+/**
+ * Poll the board until a configuration load job finishes
+ * @param {number} jobId - Job id returned by /api/config/load
+ */
+async function waitForConfigJob(jobId) {
+	for (;;) {
+		const response = await fetch('/api/config/status?job=' + jobId);
+		if (!response.ok) {
+			throw new Error(`Error HTTP: ${response.status}`);
+		}
+
+		const status = await response.json();
+		if (status.stage === 'done') {
+			return status;
+		}
+		if (status.stage === 'failed') {
+			throw new Error(status.error || 'Error al cargar configuración');
+		}
+
+		showStatus(
+			`⏳ Cargando configuración (${status.stage} ${status.done}/${status.total})...`,
+			'loading'
+		);
+		await new Promise((resolve) => setTimeout(resolve, 250));
+	}
+}
+
 async function loadProject(projectId) {
 	// Buscar el proyecto en los datos actuales o en todos los proyectos
 	let project = projects.find((p) => p.id === projectId);
@@ -583,6 +610,8 @@ async function loadProject(projectId) {
 		const result = await response.json();
 
 		if (result.success) {
+			// The board loads the configuration from its main loop
+			await waitForConfigJob(result.job);
 			showStatus('🎉 Configuración cargada: ' + project.name, 'success');
 
 			// Log detalles de la configuración enviada
@@ -168,12 +168,123 @@ String ESPinner_Path = "espinners";
 #define PROJECTS_STATUS_LABEL "Status"
 #define PROJECTS_STATUS_VALUE "Ready"
 
+// Staged project loading run from loop(). Each iteration works on the load
+// job until the budget is spent, so runners keep stepping during a load.
+#ifndef CONFIG_LOAD_BUDGET_MS
+#define CONFIG_LOAD_BUDGET_MS 5
+#endif
+
+// Pin errors reported at most for a rejected project
+#ifndef PIN_VALIDATION_MAX_ERRORS
+#define PIN_VALIDATION_MAX_ERRORS 16
+#endif
+
+// Runtime state checkpoints. Providers are sampled every interval; a value
+// still moving is written once it changed by its threshold.
+#ifndef CHECKPOINT_INTERVAL_MS
+#define CHECKPOINT_INTERVAL_MS 500
+#endif
+#ifndef STEPPER_CHECKPOINT_STEPS
+#define STEPPER_CHECKPOINT_STEPS 50
+#endif
+#ifndef DC_CHECKPOINT_SPEED
+#define DC_CHECKPOINT_SPEED 8
+#endif
+
+// Cooperative scheduler of loop(). Motion tasks run between all other
+// tasks; the rest run earliest deadline first while the pass budget lasts.
+#ifndef SCHEDULER_MAX_TASKS
+#define SCHEDULER_MAX_TASKS 16
+#endif
+#ifndef SCHEDULER_PASS_BUDGET_US
+#define SCHEDULER_PASS_BUDGET_US 5000
+#endif
+
+// Latency histograms of the scheduler tasks, the network stages and every
+// stepper, dumped with 'P' and served at /api/perf. A stage costs two cycle
+// counter reads per run and about 500 bytes of RAM, too much for ESP8266.
+#ifndef LOOP_PROFILER_ENABLED
+#if defined(ESP8266)
+#define LOOP_PROFILER_ENABLED 0
+#else
+#define LOOP_PROFILER_ENABLED 1
+#endif
+#endif
+#ifndef LOOP_PROFILER_MAX_STAGES
+#if LOOP_PROFILER_ENABLED
+#define LOOP_PROFILER_MAX_STAGES 32
+#else
+#define LOOP_PROFILER_MAX_STAGES 1
+#endif
+#endif
+
+// Timer wheel of the controller, stepper and NeoPixel tickers. Every ticker
+// holds one timer of the pool for its whole life; ESPinners created with the
+// pool exhausted are refused and counted in the 'T' serial report.
+#ifndef TIMER_WHEEL_MAX_TIMERS
+#define TIMER_WHEEL_MAX_TIMERS 32
+#endif
+
+// Steppers on a FreeRTOS task pinned to core 0 next to WiFi, below the WiFi
+// and TCP/IP tasks in priority, so loop() keeps all of core 1. It sleeps one
+// tick every slice while moving so the core 0 idle task runs. ESP32 only;
+// elsewhere loop() runs them.
+#ifndef MOTION_TASK_ENABLED
+#define MOTION_TASK_ENABLED 0
+#endif
+#ifndef MOTION_TASK_CORE
+#define MOTION_TASK_CORE 0
+#endif
+#ifndef MOTION_TASK_PRIORITY
+#define MOTION_TASK_PRIORITY 3
+#endif
+#ifndef MOTION_TASK_SLICE_US
+#define MOTION_TASK_SLICE_US 4000
+#endif
+
+// Live pin levels of /pin-status. Attached pins are sampled every interval
+// while a page listens. The buffer holds one diff with every pin of the
+// board.
+#ifndef PIN_TELEMETRY_INTERVAL_MS
+#define PIN_TELEMETRY_INTERVAL_MS 50
+#endif
+#ifndef PIN_TELEMETRY_BUFFER
+#define PIN_TELEMETRY_BUFFER 768
+#endif
+
 // ----------------------------------------//
 // --------------- Modules ----------------//
 // ----------------------------------------//
 
 #define MOD_CAPACITY 10
 
+// Build switches per module. Set to 0 (e.g. -D ESPALLON_MOD_TFT=0) to leave
+// a module out of the firmware. GPIO is always built.
+#ifndef ESPALLON_MOD_STEPPER
+#define ESPALLON_MOD_STEPPER 1
+#endif
+#ifndef ESPALLON_MOD_NEOPIXEL
+#define ESPALLON_MOD_NEOPIXEL 1
+#endif
+#ifndef ESPALLON_MOD_DC
+#define ESPALLON_MOD_DC 1
+#endif
+#ifndef ESPALLON_MOD_RFID
+#define ESPALLON_MOD_RFID 1
+#endif
+#ifndef ESPALLON_MOD_MPU
+#define ESPALLON_MOD_MPU 1
+#endif
+#ifndef ESPALLON_MOD_ENCODER
+#define ESPALLON_MOD_ENCODER 1
+#endif
+#ifndef ESPALLON_MOD_TFT
+#define ESPALLON_MOD_TFT 1
+#endif
+#ifndef ESPALLON_MOD_LCD
+#define ESPALLON_MOD_LCD 1
+#endif
+
 #define ESPINNERTYPE_LABEL "ESPinnerType"
 #define ESPINNERTYPE_VALUE "VOID"
 #define ESPINNERID_LABEL "ESPinnerID"
@@ -277,6 +388,26 @@ String ESPinner_Path = "espinners";
 #define STEPPER_STEPSREV_MAX_VALUE 10000
 
 #define STEPPER_MAX_STEPPERS 8
+// Commands waiting for a stepper at most, see MotionCommandQueue
+#define STEPPER_COMMAND_QUEUE_SIZE 16
+// Aggregate step rate of the moving steppers, steps/s. Moves over it are
+// clamped (STEPPER_ADMISSION_CLAMP 1) or reported. 0 measures it at boot on
+// the task running the steppers (StepperRunner::calibrateCapacity()); a
+// rate set here skips the measurement.
+#ifndef STEPPER_STEP_CAPACITY
+#define STEPPER_STEP_CAPACITY 0
+#endif
+#ifndef STEPPER_ADMISSION_CLAMP
+#define STEPPER_ADMISSION_CLAMP 1
+#endif
+// Part of the measured rate admitted: the calibration times the stepping
+// code alone, the pin writes and the rest of the loop need the remainder
+#ifndef STEPPER_CAPACITY_SHARE
+#define STEPPER_CAPACITY_SHARE 0.5f
+#endif
+// Time of one calibration trial, us, and highest per stepper speed tried
+#define STEPPER_CALIBRATION_TRIAL_US 20000
+#define STEPPER_CALIBRATION_MAX_SPEED 20000
 #define STEPPER_ACTIONS_INTERVAL_MS 200
 #define STEPPER_DEFAULT_MAX_SPEED 1000
 #define STEPPER_DEFAULT_ACCELERATION 500
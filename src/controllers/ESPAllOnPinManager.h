@@ -4,6 +4,7 @@
 #include "../utils.h"
 
 #include "../models/ESP_Boards.h"
+#include "../models/PinStateTable.h"
 #include <PinManager.h>
 
 /** Mapping of pin types to their string representations */
@@ -35,27 +36,80 @@ const std::map<PinType, const char *> pinTypeNames = {
  * functionality and integration with the ESPUI library. It manages pin
  * assignments, tracks pin usage, and provides validation for pin operations.
  *
+ * Pin state lives in a fixed size PinStateTable indexed by GPIO, so
+ * conflict checks are O(1) and never allocate.
+ *
  * The class implements the Singleton pattern to ensure only one instance
  * manages the pins throughout the application lifecycle.
  */
 
 class ESPAllOnPinManager : public PinManager<ESP_BoardConf, ESP_PinMode> {
+	typedef PinManager<ESP_BoardConf, ESP_PinMode> BasePinManager;
+
+	/** PINOUT entry of every GPIO, nullptr when the board does not list it */
+	const ESP_PinMode *pinConfigs[ESP_BoardConf::NUM_PINS];
+
+	static int pinNumber(const ESP_PinMode &gpio) { return gpio.pin; }
+	template <typename T> static int pinNumber(T pin) {
+		return static_cast<int>(pin);
+	}
+
+	/** Mirrors the base attached state into the table once a call returns */
+	struct AttachedSync {
+		ESPAllOnPinManager &manager;
+		int pin;
+		~AttachedSync() {
+			manager.pinCurrentStatus.setAttached(
+				pin, manager.BasePinManager::isPinAttached(pin));
+		}
+	};
 
   public:
-	/** Map relating PIN with Selector Reference in ESPAllOn GUI < uint16_t PIN,
-	 * uint16_ t SELECTOR_ID>
+	/** State of every PIN: attached, broken and reserved flags, capabilities
+	 * and the Selector Reference in ESPAllOn GUI bound to it
 	 */
-	std::map<uint16_t, uint16_t> pinCurrentStatus;
+	PinStateTable<ESP_BoardConf::NUM_PINS> pinCurrentStatus;
 
 	/**
-	 * Marks all broken pins as occupied with a special value (10000)
-	 * to prevent them from being used in the system.
+	 * Indexes the board PINOUT by GPIO and blocks broken pins so they can not
+	 * be used in the system.
 	 */
 	ESPAllOnPinManager() {
+		for (size_t i = 0; i < ESP_BoardConf::NUM_PINS; i++) {
+			pinConfigs[i] = nullptr;
+		}
+		for (size_t i = 0; i < ESP_BoardConf::INITIAL_PINS; i++) {
+			const ESP_PinMode &config = ESP_BoardConf::PINOUT[i];
+			if (!pinCurrentStatus.inRange(config.pin)) {
+				continue;
+			}
+			pinConfigs[config.pin] = &config;
+			uint8_t flags = PIN_CAP_CONFIGURED;
+			if (config.mode == GPIOMode::Input) {
+				flags |= PIN_CAP_INPUT;
+			} else if (config.mode == GPIOMode::Output) {
+				flags |= PIN_CAP_OUTPUT;
+			}
+			if (config.canDeepSleep) {
+				flags |= PIN_CAP_DEEPSLEEP;
+			}
+			if (config.canUseWithWiFi) {
+				flags |= PIN_CAP_WIFI;
+			}
+			if (config.isTouchGPIO) {
+				flags |= PIN_CAP_TOUCH;
+			}
+			pinCurrentStatus.setCapabilities(config.pin, flags);
+		}
 		for (const auto &config : ESP_BoardConf::PINOUT) {
 			if (config.isBroken) {
-				// Broken Pins should be occupied in list
-				pinCurrentStatus[config.pin] = 10000;
+				pinCurrentStatus.setBroken(config.pin, true);
+			}
+		}
+		// Flash pins of the chip, whatever the PINOUT lists
+		for (uint8_t pin = 0; pin < ESP_BoardConf::NUM_PINS; pin++) {
+			if (boardPinHas(pin, BOARD_CAP_FLASH)) {
+				pinCurrentStatus.setBroken(pin, true);
 			}
 		}
 	}
@@ -70,25 +124,56 @@ class ESPAllOnPinManager : public PinManager<ESP_BoardConf, ESP_PinMode> {
 	}
 
 	/**
-	 * Gets reference to the PIN mapping
-	 * @return Reference to the map containing pin-to-selector relationships
+	 * Gets reference to the PIN state table
+	 * @return Reference to the table containing pin-to-selector relationships
+	 */
+	PinStateTable<ESP_BoardConf::NUM_PINS> &getPINMap() {
+		return pinCurrentStatus;
+	}
+
+	/**
+	 * Board configuration of a GPIO
+	 * @return PINOUT entry, nullptr if the board does not list the GPIO
+	 */
+	const ESP_PinMode *getPinConfig(int pin) const {
+		return pinCurrentStatus.inRange(pin) ? pinConfigs[pin] : nullptr;
+	}
+
+	/**
+	 * Attaches a pin in the base PinManager and mirrors it in the table
+	 */
+	template <typename GPIO>
+	auto attach(GPIO gpio) -> decltype(BasePinManager::attach(gpio)) {
+		AttachedSync sync{*this, pinNumber(gpio)};
+		return BasePinManager::attach(gpio);
+	}
+
+	/**
+	 * Detaches a pin in the base PinManager and mirrors it in the table. The
+	 * UI control bound to the pin is released with it.
+	 */
+	template <typename GPIO>
+	auto detach(GPIO gpio) -> decltype(BasePinManager::detach(gpio)) {
+		AttachedSync sync{*this, pinNumber(gpio)};
+		pinCurrentStatus.clearControlRef(pinNumber(gpio));
+		return BasePinManager::detach(gpio);
+	}
+
+	/**
+	 * Reserves a pin for internal use (buses, boot straps...) so it can not
+	 * be selected
 	 */
-	std::map<uint16_t, uint16_t> &getPINMap() { return pinCurrentStatus; }
+	void reservePin(uint8_t pin) { pinCurrentStatus.setReserved(pin, true); }
+	void releasePin(uint8_t pin) { pinCurrentStatus.setReserved(pin, false); }
 
 	/**
 	 * Gets the current pin number for a given reference ID
 	 * @param ref Reference ID to search for
 	 * @return Pin number if found, 0 otherwise
 	 */
-	uint16_t getCurrentReference(uint8_t ref) {
-		for (auto &relation : pinCurrentStatus) {
-			if (relation.second == ref) {
-				uint8_t currentPin = relation.first;
-				return currentPin;
-				break;
-			}
-		}
-		return 0;
+	uint16_t getCurrentReference(uint16_t ref) const {
+		int pin = pinCurrentStatus.getControlPin(ref);
+		return pin < 0 ? 0 : pin;
 	}
 
 	/**
@@ -102,10 +187,9 @@ class ESPAllOnPinManager : public PinManager<ESP_BoardConf, ESP_PinMode> {
 			setPinControlRelation(ESPin.pin, ref);
 			ESPAllOnPinManager::attach(ESPin.pin);
 		} else {
+			// Detaching the older Pin removes its ref relation
 			ESPAllOnPinManager::detach(sel);
 			ESPAllOnPinManager::attach(ESPin);
-			// Remove ref relation with older Pin
-			pinCurrentStatus.erase(sel);
 			setPinControlRelation(ESPin.pin, ref);
 		}
 	}
@@ -113,7 +197,17 @@ class ESPAllOnPinManager : public PinManager<ESP_BoardConf, ESP_PinMode> {
 	/**
 	 * Debug function to print current pin status
 	 */
-	void debugCurrentStatus() { debugMap(pinCurrentStatus); }
+	void debugCurrentStatus() {
+		for (uint16_t pin = 0; pin < ESP_BoardConf::NUM_PINS; pin++) {
+			if (pinCurrentStatus.isBlocked(pin)) {
+				DUMP("  Pin: ", pin);
+				DUMPSLN(" -> BLOCKED");
+			} else if (pinCurrentStatus.getControlRef(pin) != 0) {
+				DUMP("  Pin: ", pin);
+				DUMPLN(" -> Ref: ", pinCurrentStatus.getControlRef(pin));
+			}
+		}
+	}
 
 	/**
 	 * Sets the relationship between a pin and its UI control reference
@@ -121,7 +215,15 @@ class ESPAllOnPinManager : public PinManager<ESP_BoardConf, ESP_PinMode> {
 	 * @param espuiControlRef UI control reference ID
 	 */
 	void setPinControlRelation(uint8_t pin, uint16_t espuiControlRef) {
-		pinCurrentStatus[pin] = espuiControlRef;
+		pinCurrentStatus.setControlRef(pin, espuiControlRef);
+	}
+
+	/**
+	 * Removes the UI control reference bound to a pin
+	 * @param pin Pin number
+	 */
+	void clearPinControlRelation(uint8_t pin) {
+		pinCurrentStatus.clearControlRef(pin);
 	}
 };
 
@@ -175,8 +277,9 @@ void DUMP_PINOUT() {
 bool isNumericAndInRange(const String value, uint16_t ref) {
 	int val = value.toInt();
 	// ESPAllOnPinManager::getInstance().debugCurrentStatus();
-	uint16_t pinRef = ESPAllOnPinManager::getInstance().pinCurrentStatus[val];
-	if (val == 0 || pinRef == 10000) {
+	const auto &pinState = ESPAllOnPinManager::getInstance().pinCurrentStatus;
+	if (val <= 0 || val >= PINSIZE || !boardPinUsable(val) ||
+		pinState.isBlocked(val)) {
 		return false;
 	}
 
@@ -194,8 +297,7 @@ bool isNumericAndInRange(const String value, uint16_t ref) {
 				return false;
 			}
 			// Review if Pin is already occupied in ESPinner_PinManager
-			bool is_gpio_attached =
-				ESPAllOnPinManager::getInstance().isPinAttached(val);
+			bool is_gpio_attached = pinState.isAttached(val);
 			if (!is_gpio_attached && val > 0 && val < PINSIZE) {
 				return true;
 			}
@@ -207,115 +309,4 @@ bool isNumericAndInRange(const String value, uint16_t ref) {
 	return false;
 }
 
-/**
- * Validates all pins in a configuration array
- * @param configArray JsonArray containing ESPinner configurations
- * @param errorMsg Output parameter for error message
- * @return true if all pins are valid, false otherwise
- */
-static bool validatePinsInConfig(JsonArray configArray, String &errorMsg) {
-	for (JsonVariant config : configArray) {
-		JsonObject obj = config.as<JsonObject>();
-		String espinnerType = obj["ESPinner_Mod"].as<String>();
-		String espinnerID = obj["ID"].as<String>();
-
-		// Check common pin fields based on ESPinner type
-		std::vector<String> pinsToCheck;
-
-		if (espinnerType == "ESPINNER_STEPPER") {
-			if (obj.containsKey("STEP"))
-				pinsToCheck.push_back("STEP");
-			if (obj.containsKey("DIR"))
-				pinsToCheck.push_back("DIR");
-			if (obj.containsKey("EN"))
-				pinsToCheck.push_back("EN");
-			if (obj.containsKey("CS"))
-				pinsToCheck.push_back("CS");
-			if (obj.containsKey("DIAG0"))
-				pinsToCheck.push_back("DIAG0");
-		} else if (espinnerType == "ESPINNER_GPIO") {
-			if (obj.containsKey("GPIO"))
-				pinsToCheck.push_back("GPIO");
-		} else if (espinnerType == "ESPINNER_DC") {
-			if (obj.containsKey("GPIOA"))
-				pinsToCheck.push_back("GPIOA");
-			if (obj.containsKey("GPIOB"))
-				pinsToCheck.push_back("GPIOB");
-		} else if (espinnerType == "ESPINNER_NEOPIXEL") {
-			if (obj.containsKey("GPIO"))
-				pinsToCheck.push_back("GPIO");
-		} else if (espinnerType == "ESPINNER_ENCODER") {
-			if (obj.containsKey("CLK"))
-				pinsToCheck.push_back("CLK");
-			if (obj.containsKey("DT"))
-				pinsToCheck.push_back("DT");
-			if (obj.containsKey("SW"))
-				pinsToCheck.push_back("SW");
-		}
-
-		// Validate each pin
-		for (const String &pinField : pinsToCheck) {
-			if (!obj.containsKey(pinField))
-				continue;
-
-			int pinNumber = obj[pinField].as<int>();
-
-			// Check if pin is 0 (invalid)
-			if (pinNumber == 0) {
-				errorMsg = "ESPinner '" + espinnerID + "': Pin field '" +
-						   pinField + "' has invalid value 0";
-				DUMPLN("Validation error: ", errorMsg);
-				return false;
-			}
-
-			// Check if pin is out of range for the board
-			if (pinNumber < 0 || pinNumber >= ESP_BoardConf::NUM_PINS) {
-				errorMsg =
-					"ESPinner '" + espinnerID + "': Pin " + String(pinNumber) +
-					" (" + pinField + ") is out of range (0-" +
-					String(ESP_BoardConf::NUM_PINS - 1) + ") for this board";
-				DUMPLN("Validation error: ", errorMsg);
-				return false;
-			}
-
-			// Get the pin configuration directly from board configuration
-			ESP_PinMode pinConfig =
-				ESPAllOnPinManager::getInstance().getGPIO(pinNumber);
-
-			// Check if pin is broken according to board configuration
-			if (pinConfig.isBroken) {
-				errorMsg = "ESPinner '" + espinnerID + "': Pin " +
-						   String(pinNumber) + " (" + pinField +
-						   ") is marked as BROKEN in board configuration";
-				DUMPLN("Validation error: ", errorMsg);
-				return false;
-			}
-
-			// Check if pin is OK using PinManager validation
-			if (!ESPAllOnPinManager::getInstance().isPinOK(pinNumber)) {
-				errorMsg =
-					"ESPinner '" + espinnerID + "': Pin " + String(pinNumber) +
-					" (" + pinField +
-					") is not valid for this board (isPinOK check failed)";
-				DUMPLN("Validation error: ", errorMsg);
-				return false;
-			}
-
-			// Optional: Check if pin is already reserved (status 10000)
-			uint16_t pinStatus =
-				ESPAllOnPinManager::getInstance().pinCurrentStatus[pinNumber];
-			if (pinStatus == 10000) {
-				errorMsg = "ESPinner '" + espinnerID + "': Pin " +
-						   String(pinNumber) + " (" + pinField +
-						   ") is reserved or internally marked as broken";
-				DUMPLN("Validation error: ", errorMsg);
-				return false;
-			}
-		}
-	}
-
-	DUMPSLN("All pins validated successfully");
-	return true;
-}
-
 #endif
\ No newline at end of file
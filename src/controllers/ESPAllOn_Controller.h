@@ -1,7 +1,7 @@
 #ifndef _ESPALLON_CONTROLLER_H
 #define _ESPALLON_CONTROLLER_H
 
-#include <TickerFree.h>
+#include "./WheelTicker.h"
 
 /** @brief Callback function type for state change events */
 using StateChangeCallback = void (*)(status_t previousState,
@@ -10,10 +10,10 @@ using StateChangeCallback = void (*)(status_t previousState,
 /**
  *
  * ESPALLON_Controller provides a foundation for all controllers in the system,
- * inheriting from TickerFree to provide periodic execution capabilities and
- * state management functionality.
+ * inheriting from WheelTicker to provide periodic execution capabilities and
+ * state management functionality. Ticks fire from the timer wheel of the loop.
  */
-class ESPALLON_Controller : public TickerFree<> {
+class ESPALLON_Controller : public WheelTicker {
   public:
 	status_t currentState;	///< Current state of the controller
 	status_t previousState; ///< Previous state of the controller
@@ -27,7 +27,7 @@ class ESPALLON_Controller : public TickerFree<> {
 	 * Constructor initializes the ticker with default interval
 	 * Sets up a 100ms ticker interval and binds the tick() method
 	 */
-	ESPALLON_Controller() : TickerFree<>([this]() { this->tick(); }, 100) {}
+	ESPALLON_Controller() : WheelTicker([this]() { this->tick(); }, 100) {}
 
 	/**
 	 * Virtual function for connection tick handling
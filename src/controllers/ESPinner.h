@@ -2,6 +2,7 @@
 #define _ESPINNER_H
 #define NVS
 
+#include "../manager/CheckpointService.h"
 #include <ESPUI.h>
 #include <Persistance.h>
 
@@ -27,14 +28,31 @@ struct ESPinner_Module {
 
 const ESPinner_Module mods[] = {{ESPinner_Mod::VOID, VOID_LABEL},
 								{ESPinner_Mod::GPIO, GPIO_LABEL},
+#if ESPALLON_MOD_STEPPER
 								{ESPinner_Mod::Stepper, STEPPER_LABEL},
+#endif
+#if ESPALLON_MOD_NEOPIXEL
 								{ESPinner_Mod::NeoPixel, NEOPIXEL_LABEL},
+#endif
+#if ESPALLON_MOD_DC
 								{ESPinner_Mod::DC, DC_LABEL},
+#endif
+#if ESPALLON_MOD_RFID
 								{ESPinner_Mod::RFID, RFID_LABEL},
+#endif
+#if ESPALLON_MOD_MPU
 								{ESPinner_Mod::MPU, MPU_LABEL},
+#endif
+#if ESPALLON_MOD_ENCODER
 								{ESPinner_Mod::Encoder, ENCODER_LABEL},
+#endif
+#if ESPALLON_MOD_TFT
 								{ESPinner_Mod::TFT, TFT_LABEL},
-								{ESPinner_Mod::LCD, LCD_LABEL}};
+#endif
+#if ESPALLON_MOD_LCD
+								{ESPinner_Mod::LCD, LCD_LABEL},
+#endif
+};
 
 /**
  * Abstract interface for all ESPinner modules
@@ -78,8 +96,9 @@ class IESPinner {
  */
 class ESPinner : public IESPinner, public IJSONSerializable {
   public:
-	ESPinner_Mod mod; // Module type of this ESPinner
-	String ID;		  // Unique identifier for this ESPinner instance
+	ESPinner_Mod mod;	   // Module type of this ESPinner
+	String ID;			   // Unique identifier for this ESPinner instance
+	uint16_t panelRef = 0; // UI panel holding the configuration controls
 
 	/**
 	 * Factory method to create ESPinner instances based on type string
@@ -127,15 +146,50 @@ class ESPinner : public IESPinner, public IJSONSerializable {
 	 * @return Current unique identifier
 	 */
 	String getID() { return ID; }
+
+	/**
+	 * Sets the UI panel holding this ESPinner configuration
+	 * @param ref UI reference of the panel
+	 */
+	void setPanelRef(uint16_t ref) { panelRef = ref; }
+
+	/**
+	 * Gets the UI panel holding this ESPinner configuration
+	 * @return UI reference of the panel or 0 if not shown
+	 */
+	uint16_t getPanelRef() { return panelRef; }
+
+	/**
+	 * Runtime state of this ESPinner that is checkpointed across resets
+	 * @return Provider or nullptr if the module keeps no runtime state
+	 */
+	virtual ICheckpointProvider *getCheckpointProvider() { return nullptr; }
 };
 
+#include "mods/ESPinner_GPIO/ESPinner_GPIO.h"
+
+#if ESPALLON_MOD_DC
 #include "mods/ESPinner_DC/ESPinner_DC.h"
+#endif
+#if ESPALLON_MOD_ENCODER
 #include "mods/ESPinner_Encoder/ESPinner_Encoder.h"
-#include "mods/ESPinner_GPIO/ESPinner_GPIO.h"
+#endif
+#if ESPALLON_MOD_LCD
 #include "mods/ESPinner_LCD/ESPinner_LCD.h"
+#endif
+#if ESPALLON_MOD_MPU
 #include "mods/ESPinner_MPU/ESPinner_MPU.h"
+#endif
+#if ESPALLON_MOD_NEOPIXEL
 #include "mods/ESPinner_NeoPixel/ESPinner_NeoPixel.h"
+#endif
+#if ESPALLON_MOD_RFID
 #include "mods/ESPinner_RFID/ESPinner_RFID.h"
+#endif
+#if ESPALLON_MOD_STEPPER
 #include "mods/ESPinner_Stepper/ESPinner_Stepper.h"
+#endif
+#if ESPALLON_MOD_TFT
 #include "mods/ESPinner_TFT/ESPinner_TFT.h"
+#endif
 #endif
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef _ESPALLON_PERF_H
+#define _ESPALLON_PERF_H
+
+#include "../../manager/LoopProfiler.h"
+#include "../../utils.h"
+#include <ArduinoJson.h>
+#include <ESPUI.h>
+
+/**
+ * ESPAllOnPerf serves the loop profiler histograms as /api/perf
+ *
+ * One entry per stage: scheduler tasks, network stages, steppers and
+ * NeoPixels, with sample count and p50/p99/max in us. A request with
+ * ?reset=1 clears the histograms after answering; the clear is applied by
+ * the tasks recording them, never from the web server task.
+ */
+class ESPAllOnPerf {
+  public:
+	/**
+	 * Registers the perf endpoint with the ESPUI web server
+	 * This should be called after ESPUI.begin()
+	 */
+	static void registerPerfEndpoint() {
+		ESPUI.server->on("/api/perf", HTTP_GET, handlePerfRequest);
+		DUMPLN("Perf endpoint registered at: ", "/api/perf");
+	}
+
+  private:
+	/**
+	 * HTTP request handler for the perf endpoint
+	 * @param request AsyncWebServerRequest object
+	 */
+	static void handlePerfRequest(AsyncWebServerRequest *request) {
+		LoopProfiler &profiler = getLoopProfiler();
+		JsonDocument doc;
+		doc["enabled"] = LOOP_PROFILER_ENABLED != 0;
+		JsonArray stages = doc["stages"].to<JsonArray>();
+		for (size_t i = 0; i < profiler.size(); i++) {
+			const LatencyHistogram &histogram = profiler.getHistogram(i);
+			JsonObject stage = stages.add<JsonObject>();
+			stage["name"] = profiler.getName(i);
+			stage["samples"] = histogram.getSamples();
+			stage["p50"] = profiler.toMicros(histogram.percentile(50));
+			stage["p99"] = profiler.toMicros(histogram.percentile(99));
+			stage["max"] = profiler.toMicros(histogram.getMax());
+		}
+
+		String response;
+		serializeJson(doc, response);
+		request->send(200, "application/json", response);
+
+		if (request->hasParam("reset")) {
+			profiler.reset();
+		}
+	}
+};
+
+#endif
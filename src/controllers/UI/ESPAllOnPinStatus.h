@@ -2,237 +2,267 @@
 #define _ESPALLON_PIN_STATUS_H
 
 #include "../../utils.h"
+#include "../../manager/PinTelemetry.h"
 #include "../ESPAllOnPinManager.h"
+#include "WebAssets.h"
+#include <ArduinoJson.h>
 #include <ESPUI.h>
 
+#if defined(ESP32)
+#include <soc/gpio_reg.h>
+#include <soc/soc_caps.h>
+#endif
+
+#ifndef USE_LITTLEFS_MODE
+#include "dataPinStatusHTML.h"
+#endif
+
 /**
- * ESPAllOnPinStatus provides web endpoint functionality to display
- * comprehensive pin configuration and status information in a formatted
- * HTML table. It creates a dedicated web page accessible via /pin-status
- * that shows real-time pin usage, configuration, and board-specific details.
+ * ESPAllOnPinStatus provides the /pin-status page and the /api/pins JSON
+ * snapshot it renders.
+ *
+ * The page is static (LittleFS or PROGMEM) and polls /api/pins. The
+ * snapshot is built only when the pin manager generation changes and is
+ * tagged with an ETag from that generation, so polling an unchanged board
+ * is answered with 304 Not Modified and no rendering.
+ *
+ * Pin levels are pushed live over Server-Sent Events on /pin-status/events:
+ * update() samples the attached pins while a page listens and sends the
+ * pins that changed as a "levels" diff (see PinTelemetry). A "pins" event
+ * tells the page the pin state changed and /api/pins must be fetched again.
  */
 class ESPAllOnPinStatus {
   public:
+	/** Pin state bits of a snapshot row, mirrored in pin-status.js */
+	enum PinSnapshotState : uint8_t {
+		PIN_STATE_ATTACHED = 1,
+		PIN_STATE_BROKEN = 2,
+		PIN_STATE_RESERVED = 4,
+		PIN_STATE_CONFIGURED = 8
+	};
+
+	struct PinSnapshot {
+		String json;
+		String etag;
+		uint32_t generation = 0;
+		bool valid = false;
+	};
+
 	/**
-	 * Registers the pin status endpoint with the ESPUI web server
-	 * This should be called after ESPUI.begin() to add the custom endpoint
+	 * Registers the pin status endpoints with the ESPUI web server
+	 * This should be called after ESPUI.begin() to add the custom endpoints
 	 */
 	static void registerPinStatusEndpoint() {
+		getEvents().onConnect([](AsyncEventSourceClient *client) {
+			// Runs on the network task, the next update() resends all levels
+			resendLevels = true;
+		});
+		// Before /pin-status: handlers match by prefix in insertion order
+		ESPUI.server->addHandler(&getEvents());
 		ESPUI.server->on("/pin-status", HTTP_GET, handlePinStatusRequest);
+		ESPUI.server->on("/api/pins", HTTP_GET, handlePinsAPIRequest);
+#ifdef USE_LITTLEFS_MODE
+		ESPUI.server->on("/pin-status.css", HTTP_GET,
+						 [](AsyncWebServerRequest *request) {
+							 sendWebAsset(request, "/pin-status.css",
+										  "text/css");
+						 });
+		ESPUI.server->on("/pin-status.js", HTTP_GET,
+						 [](AsyncWebServerRequest *request) {
+							 sendWebAsset(request, "/pin-status.js",
+										  "application/javascript");
+						 });
+#endif
 		DUMPLN("Pin Status endpoint registered at: ", "/pin-status");
 	}
 
-  private:
 	/**
-	 * HTTP request handler for the pin status endpoint
-	 * @param request AsyncWebServerRequest object
+	 * Samples the pin levels and pushes the changes, called from loop()
+	 * Does nothing while no page is listening.
+	 * @param now Current time in ms
 	 */
-	static void handlePinStatusRequest(AsyncWebServerRequest *request) {
-		auto *res = request->beginResponseStream("text/html");
+	static void update(uint32_t now) {
+		AsyncEventSource &events = getEvents();
+		if (events.count() == 0) {
+			return;
+		}
+		PinTelemetry<ESP_BoardConf::NUM_PINS> &telemetry = getTelemetry();
+		const auto &pinState = ESPAllOnPinManager::getInstance().getPINMap();
+		uint32_t generation = pinState.generation();
+		if (generation != watchedGeneration) {
+			watchedGeneration = generation;
+			syncWatchedPins();
+			events.send(String(generation).c_str(), "pins");
+		}
+		if (resendLevels) {
+			resendLevels = false;
+			telemetry.invalidate();
+		}
+		if (telemetry.update(now) == 0) {
+			return;
+		}
+		char diff[PIN_TELEMETRY_BUFFER];
+		if (telemetry.format(diff, sizeof(diff), now) > 0) {
+			events.send(diff, "levels");
+		}
+	}
 
-		// 1) Header and CSS from PROGMEM (no to heap)
-		res->print(
-			F("<!DOCTYPE html><html lang='en'><head><meta charset='UTF-8'>"
-			  "<meta name='viewport' "
-			  "content='width=device-width,initial-scale=1.0'>"
-			  "<title>ESP Pin Status - ESPAllOn</title>"));
+	/**
+	 * Gets the pin snapshot, rebuilt only if the pin state changed since
+	 * @return Snapshot with its JSON body and ETag
+	 */
+	static const PinSnapshot &getPinSnapshot() {
+		static PinSnapshot snapshot;
+		ESPAllOnPinManager &pm = ESPAllOnPinManager::getInstance();
+		// Read before building: a change made meanwhile leaves the snapshot
+		// one generation behind and the next request rebuilds it
+		uint32_t generation = pm.getPINMap().generation();
+		if (snapshot.valid && snapshot.generation == generation) {
+			return snapshot;
+		}
 
-#ifdef USE_LITTLEFS_MODE
-		// Use external CSS file when LittleFS is enabled
-		res->print(F("<link rel='stylesheet' href='/pin-status.css'>"));
-#else
-		// Embed minimal CSS when LittleFS is disabled
-		res->print(F(
-			"<style>"
-			":root{--bg:#f5f5f5;--card:#fff;--text:#333;--muted:#6c757d;--"
-			"border:#ddd;--primary:#007bff;--success:#28a745;--info:#17a2b8;--"
-			"danger:#dc3545;--warning:#ffc107;--even:#f8f9fa;--hover:#e9ecef}*{"
-			"box-sizing:border-box}html,body{margin:0;padding:0;font-family:"
-			"Arial,sans-serif;background:var(--bg);color:var(--text)}."
-			"container{max-width:1200px;margin:0 "
-			"auto;background:var(--card);padding:20px;border-radius:8px;box-"
-			"shadow:0 2px 10px rgba(0,0,0,.1)}h1{text-align:center;margin:0 0 "
-			"20px;color:var(--text)}.info-section{background:var(--hover);"
-			"padding:15px;border-radius:5px;margin-bottom:20px}.info-section "
-			"p{margin:5px "
-			"0}table{width:100%;border-collapse:collapse;margin:20px "
-			"0;font-size:14px}th,td{padding:8px "
-			"12px;text-align:left;border:1px solid "
-			"var(--border)}th{background:var(--muted);color:#fff;font-weight:"
-			"700}tr:nth-child(even){background:var(--even)}tr:hover{background:"
-			"var(--hover)}.pin-number{font-weight:700;text-align:center}."
-			"status-used,.status-available,.status-broken,.status-not-"
-			"configured,.mode-input,.mode-output,.mode-undefined{text-align:"
-			"center;border-radius:3px}.status-used,.mode-output{background:var("
-			"--success);color:#fff}.status-available{background:var(--info);"
-			"color:#fff}.status-broken{background:var(--danger);color:#fff}."
-			"status-not-configured{background:#87ceeb;color:#333}.mode-input{"
-			"background:var(--warning);color:#212529}.mode-undefined{"
-			"background:var(--muted);color:#fff}.flag-yes{color:var(--success);"
-			"font-weight:700}.flag-no{color:var(--danger)}.pin-type{font-"
-			"family:monospace;font-size:12px}.legend{margin:20px "
-			"0;padding:15px;background:var(--even);border-radius:5px}.legend "
-			"h3{margin:0 0 10px}.legend-item{display:inline-block;margin:5px "
-			"10px}.legend-color{display:inline-block;width:20px;height:20px;"
-			"margin-right:5px;vertical-align:middle;border-radius:3px}.legend-"
-			"color.in-use{background:var(--success)}.legend-color.available{"
-			"background:var(--info)}.legend-color.broken{background:var(--"
-			"danger)}.legend-color.not-configured{background:#87ceeb}.actions{"
-			"text-align:center;margin:20px 0}.actions button{padding:10px "
-			"20px;margin:0 "
-			"10px;background:var(--primary);color:#fff;border:0;border-radius:"
-			"5px;cursor:pointer;font-size:16px}.actions "
-			"button:hover{background:#0056b3}@media(max-width:768px){."
-			"container{padding:10px}table{font-size:12px}th,td{padding:4px "
-			"6px}}"
-			"</style>"));
-#endif
+		JsonDocument doc;
+		doc["board"] = BoardPins::name();
+		doc["generation"] = generation;
+		JsonArray pins = doc["pins"].to<JsonArray>();
+		const auto &pinState = pm.getPINMap();
+		for (uint8_t gpio = 0; gpio < ESP_BoardConf::NUM_PINS; ++gpio) {
+			const ESP_PinMode *cfg = pm.getPinConfig(gpio);
+			uint8_t state = 0;
+			if (pinState.isAttached(gpio)) {
+				state |= PIN_STATE_ATTACHED;
+			}
+			if (pinState.isBroken(gpio)) {
+				state |= PIN_STATE_BROKEN;
+			}
+			if (pinState.isReserved(gpio)) {
+				state |= PIN_STATE_RESERVED;
+			}
+			if (cfg) {
+				state |= PIN_STATE_CONFIGURED;
+			}
+			uint8_t mode = 0;
+			if (cfg && cfg->mode == GPIOMode::Input) {
+				mode = 1;
+			} else if (cfg && cfg->mode == GPIOMode::Output) {
+				mode = 2;
+			}
 
-		res->print(F("</head><body><div class='container'>"
-					 "<h1>ESP Pin Configuration & Status</h1><div "
-					 "class='info-section'>"));
+			// [gpio, capabilities, state, UI ref, mode, pin type]
+			JsonArray row = pins.add<JsonArray>();
+			row.add(gpio);
+			row.add(boardCapabilities(gpio));
+			row.add(state);
+			row.add(pinState.getControlRef(gpio));
+			row.add(mode);
+			row.add(cfg ? getPinTypeName(cfg->type) : "");
+		}
 
-#ifdef ESP32
-		res->print(F("<p><strong>Board:</strong> ESP32</p>"));
-#else
-		res->print(F("<p><strong>Board:</strong> ESP8266</p>"));
-#endif
+		snapshot.json = "";
+		serializeJson(doc, snapshot.json);
+		snapshot.etag = "\"" + String(getBootTag(), HEX) + "-" +
+						String(generation) + "\"";
+		snapshot.generation = generation;
+		snapshot.valid = true;
+		return snapshot;
+	}
 
-		res->printf("<p><strong>Total Pins:</strong> %u</p>",
-					(unsigned)ESP_BoardConf::NUM_PINS);
-		res->print(F(
-			"<div class='actions'><button "
-			"onclick='location.reload()'>Refresh</button>"
-			"<button onclick='location.href=\"/\"'>Back to Main</button></div>"
-			"</div>")); // info-section
-
-		// 2) Table by rows (no large String)
-		res->print(F("<table><thead><tr>"
-					 "<th>Pin #</th><th>GPIO</th><th>Status</th><th>Mode</th>"
-					 "<th>Pin Type</th>"
-#if defined(ESP32) || defined(ESP8266)
-					 "<th>Deep Sleep</th><th>WiFi Safe</th><th>Touch GPIO</th>"
-#endif
-					 "<th>UI Ref</th></tr></thead><tbody>"));
+  private:
+	static volatile bool resendLevels;
+	static uint32_t watchedGeneration;
+	static std::bitset<ESP_BoardConf::NUM_PINS> outputPins;
 
-		auto &pm = ESPAllOnPinManager::getInstance();
+	static AsyncEventSource &getEvents() {
+		static AsyncEventSource events("/pin-status/events");
+		return events;
+	}
+
+	static PinTelemetry<ESP_BoardConf::NUM_PINS> &getTelemetry() {
+		static PinTelemetry<ESP_BoardConf::NUM_PINS> telemetry(readPinLevel);
+		return telemetry;
+	}
+
+	/**
+	 * Watches exactly the attached pins and caches which ones are outputs
+	 */
+	static void syncWatchedPins() {
+		ESPAllOnPinManager &pm = ESPAllOnPinManager::getInstance();
+		const auto &pinState = pm.getPINMap();
 		for (uint8_t gpio = 0; gpio < ESP_BoardConf::NUM_PINS; ++gpio) {
+			bool attached = pinState.isAttached(gpio);
+			getTelemetry().watch(gpio, attached);
+			outputPins.set(gpio, attached && pm.getGPIO(gpio).mode ==
+												 GPIOMode::Output);
+		}
+	}
 
-			const ESP_PinMode *cfg = nullptr;
-			for (size_t i = 0; i < (size_t)ESP_BoardConf::INITIAL_PINS; ++i) {
-				if (ESP_BoardConf::PINOUT[i].pin == gpio) {
-					cfg = &ESP_BoardConf::PINOUT[i];
-					break;
-				}
+	/**
+	 * Reads a pin without reconfiguring it
+	 * ESP32 digitalRead() samples the input register, which reads 0 for a
+	 * pin driven as output, so outputs are read from the output register.
+	 */
+	static int32_t readPinLevel(uint8_t pin) {
+#if defined(ESP32)
+		if (outputPins[pin]) {
+#if SOC_GPIO_PIN_COUNT > 32
+			if (pin >= 32) {
+				return (REG_READ(GPIO_OUT1_REG) >> (pin - 32)) & 1;
 			}
+#endif
+			return (REG_READ(GPIO_OUT_REG) >> pin) & 1;
+		}
+#endif
+		return digitalRead(pin);
+	}
 
-			bool attached = pm.isPinAttached(gpio);
-			bool broken = cfg ? cfg->isBroken : false;
-
-			// uiRef (no operator[] to avoid inserting keys and save heap)
-			uint16_t uiRef = 0;
-			const auto &mapRef = pm.getPINMap();
-			auto it = mapRef.find(gpio);
-			if (it != mapRef.end())
-				uiRef = it->second;
-
-			const char *statusClass;
-			const char *statusText;
-
-			// Check if pin has UI reference (is being used in UI)
-			bool hasUIRef = (uiRef != 0 && uiRef != 10000);
-
-			if (!cfg) {
-				if (hasUIRef) {
-					statusClass = "status-used";
-					statusText = "IN USE";
-				} else {
-					statusClass = "status-not-configured";
-					statusText = "NOT CONFIGURED";
-				}
-			} else if (broken) {
-				statusClass = "status-broken";
-				statusText = "BROKEN";
-			} else if (attached || hasUIRef) {
-				statusClass = "status-used";
-				statusText = hasUIRef ? "IN USE" : "USED";
-			} else {
-				statusClass = "status-available";
-				statusText = "AVAILABLE";
-			}
+	/**
+	 * Random per boot, so an ETag from before a reboot never matches a new
+	 * snapshot with the same generation
+	 */
+	static uint32_t getBootTag() {
+#if defined(ESP32)
+		static uint32_t tag = esp_random();
+#else
+		static uint32_t tag = ESP.random();
+#endif
+		return tag;
+	}
 
-			const char *modeClass;
-			const char *modeText;
-			if (!cfg) {
-				modeClass = "mode-undefined";
-				modeText = "NOT CONFIGURED";
-			} else
-				switch (cfg->mode) {
-				case GPIOMode::Input:
-					modeClass = "mode-input";
-					modeText = "INPUT";
-					break;
-				case GPIOMode::Output:
-					modeClass = "mode-output";
-					modeText = "OUTPUT";
-					break;
-				default:
-					modeClass = "mode-undefined";
-					modeText = "UNDEFINED";
-				}
-
-			const char *pinType = cfg ? getPinTypeName(cfg->type) : "None";
-
-			const char *uiRefText =
-				(uiRef == 0) ? "-" : (uiRef == 10000 ? "BLOCKED" : nullptr);
-
-			res->printf("<tr><td class='pin-number'>%u</td><td "
-						"class='pin-number'>%u</td>"
-						"<td class='%s'>%s</td><td class='%s'>%s</td>"
-						"<td class='pin-type'>%s</td>",
-						gpio, gpio, statusClass, statusText, modeClass,
-						modeText, pinType);
-
-#if defined(ESP32) || defined(ESP8266)
-			if (cfg) {
-				res->printf("<td class='%s'>%s</td>",
-							cfg->canDeepSleep ? "flag-yes" : "flag-no",
-							cfg->canDeepSleep ? "YES" : "NO");
-				res->printf("<td class='%s'>%s</td>",
-							cfg->canUseWithWiFi ? "flag-yes" : "flag-no",
-							cfg->canUseWithWiFi ? "YES" : "NO");
-				res->printf("<td class='%s'>%s</td>",
-							cfg->isTouchGPIO ? "flag-yes" : "flag-no",
-							cfg->isTouchGPIO ? "YES" : "NO");
-			} else {
-				res->print(F(
-					"<td class='flag-yes'>YES</td><td "
-					"class='flag-yes'>YES</td><td class='flag-yes'>YES</td>"));
-			}
+	/**
+	 * HTTP request handler for the pin status page
+	 * @param request AsyncWebServerRequest object
+	 */
+	static void handlePinStatusRequest(AsyncWebServerRequest *request) {
+#ifdef USE_LITTLEFS_MODE
+		sendWebAsset(request, "/pin-status.html", "text/html");
+#else
+		request->send_P(200, "text/html", PIN_STATUS_HTML);
 #endif
-			if (uiRefText)
-				res->printf("<td>%s</td></tr>", uiRefText);
-			else
-				res->printf("<td>%u</td></tr>", uiRef);
+	}
+
+	/**
+	 * HTTP request handler for the pin snapshot
+	 * Answers 304 when If-None-Match carries the current ETag.
+	 * @param request AsyncWebServerRequest object
+	 */
+	static void handlePinsAPIRequest(AsyncWebServerRequest *request) {
+		const PinSnapshot &snapshot = getPinSnapshot();
+		AsyncWebServerResponse *response;
+		if (request->hasHeader("If-None-Match") &&
+			request->getHeader("If-None-Match")->value() == snapshot.etag) {
+			response = request->beginResponse(304);
+		} else {
+			response = request->beginResponse(200, "application/json",
+											  snapshot.json);
 		}
-		res->print(F("</tbody></table>"));
-
-		// 3) Legend and actions (also from PROGMEM or F())
-		res->print(F("<div class='legend'>"
-					 "<h3>Legend</h3>"
-					 "<div class='legend-item'><span class='legend-color "
-					 "in-use'></span>IN USE / USED</div>"
-					 "<div class='legend-item'><span class='legend-color "
-					 "available'></span>AVAILABLE</div>"
-					 "<div class='legend-item'><span class='legend-color "
-					 "broken'></span>BROKEN</div>"
-					 "<div class='legend-item'><span class='legend-color "
-					 "not-configured'></span>NOT CONFIGURED</div>"
-					 "</div>"
-					 "</div></body></html>"));
-
-		request->send(res);
+		response->addHeader("ETag", snapshot.etag);
+		response->addHeader("Cache-Control", "no-cache");
+		request->send(response);
 	}
 };
 
-#endif
\ No newline at end of file
+volatile bool ESPAllOnPinStatus::resendLevels = false;
+uint32_t ESPAllOnPinStatus::watchedGeneration = 0;
+std::bitset<ESP_BoardConf::NUM_PINS> ESPAllOnPinStatus::outputPins;
+
+#endif
@@ -1,9 +1,11 @@
 #ifndef _ESPALLON_PROJECTS_H
 #define _ESPALLON_PROJECTS_H
 
+#include "../../manager/ConfigLoad_Manager.h"
 #include "../../manager/ESPinner_Manager.h"
 #include "../../utils.h"
 #include "../ProjectsAPIClient.h"
+#include "WebAssets.h"
 #include <ArduinoJson.h>
 #include <AsyncJson.h>
 #include <ESPUI.h>
@@ -12,18 +14,6 @@
 #include "dataProjectsHTML.h"
 #endif
 
-#ifdef USE_LITTLEFS_MODE
-#if defined(ESP32)
-#if (ESP_IDF_VERSION_MAJOR == 4 && ESP_IDF_VERSION_MINOR >= 4) ||              \
-	ESP_IDF_VERSION_MAJOR > 4
-#include <LittleFS.h>
-#else
-#include <LITTLEFS.h>
-#endif
-#else
-#include <LittleFS.h>
-#endif
-#endif
 /**
  * Simple Projects endpoint handler for ESPAllOn system
  * Provides web interface for project management and configuration loading
@@ -39,39 +29,22 @@ class ESPAllOnProjects {
 
 		// API endpoints
 		ESPUI.server->on("/api/projects", HTTP_GET, handleProjectsAPIRequest);
+		ESPUI.server->on("/api/config/status", HTTP_GET,
+						 handleConfigStatusRequest);
 
 		registerProjectPOSTEndpoints();
 
 #ifdef USE_LITTLEFS_MODE
-		// Serve CSS file for projects page when in LittleFS mode
-		ESPUI.server->on(
-			"/projects.css", HTTP_GET, [](AsyncWebServerRequest *request) {
-#if defined(ESP32)
-#if (ESP_IDF_VERSION_MAJOR == 4 && ESP_IDF_VERSION_MINOR >= 4) ||              \
-	ESP_IDF_VERSION_MAJOR > 4
-				request->send(LittleFS, "/projects.css", "text/css");
-#else
-			request->send(LITTLEFS, "/projects.css", "text/css");
-#endif
-#else
-			request->send(LittleFS, "/projects.css", "text/css");
-#endif
-			});
-
-		// Serve JavaScript file for projects page when in LittleFS mode
+		// Serve CSS and JavaScript files for projects page in LittleFS mode
+		ESPUI.server->on("/projects.css", HTTP_GET,
+						 [](AsyncWebServerRequest *request) {
+							 sendWebAsset(request, "/projects.css",
+										  "text/css");
+						 });
 		ESPUI.server->on("/projects.js", HTTP_GET,
 						 [](AsyncWebServerRequest *request) {
-#if defined(ESP32)
-#if (ESP_IDF_VERSION_MAJOR == 4 && ESP_IDF_VERSION_MINOR >= 4) ||              \
-	ESP_IDF_VERSION_MAJOR > 4
-							 request->send(LittleFS, "/projects.js",
-										   "application/javascript");
-#else
-			request->send(LITTLEFS, "/projects.js", "application/javascript");
-#endif
-#else
-			request->send(LittleFS, "/projects.js", "application/javascript");
-#endif
+							 sendWebAsset(request, "/projects.js",
+										  "application/javascript");
 						 });
 #endif
 		// Note: In embedded mode (USE_LITTLEFS_MODE disabled),
@@ -90,16 +63,7 @@ class ESPAllOnProjects {
 
 #ifdef USE_LITTLEFS_MODE
 		// Serve HTML file from LittleFS
-#if defined(ESP32)
-#if (ESP_IDF_VERSION_MAJOR == 4 && ESP_IDF_VERSION_MINOR >= 4) ||              \
-	ESP_IDF_VERSION_MAJOR > 4
-		request->send(LittleFS, "/projects.html", "text/html");
-#else
-		request->send(LITTLEFS, "/projects.html", "text/html");
-#endif
-#else
-		request->send(LittleFS, "/projects.html", "text/html");
-#endif
+		sendWebAsset(request, "/projects.html", "text/html");
 #else
 		// Serve embedded HTML page
 		request->send_P(200, "text/html", PROJECTS_HTML);
@@ -143,9 +107,35 @@ class ESPAllOnProjects {
 		request->send(200, "application/json", jsonResponse);
 	}
 
+	/**
+	 * HTTP request handler for the configuration load status
+	 * /api/config/status?job=<id>
+	 * @param request AsyncWebServerRequest object
+	 */
+	static void handleConfigStatusRequest(AsyncWebServerRequest *request) {
+		ConfigLoad_Manager &loader = ConfigLoad_Manager::getInstance();
+		if (request->hasParam("job")) {
+			uint32_t job = request->getParam("job")->value().toInt();
+			if (job != loader.getJobId()) {
+				request->send(404, "application/json",
+							  R"({"success":false,"error":"Unknown job"})");
+				return;
+			}
+		}
+
+		JsonDocument status;
+		loader.getStatus(status);
+		String response;
+		serializeJson(status, response);
+		request->send(200, "application/json", response);
+	}
+
 	/**
 	 * HTTP request handler for POST endpoints
 	 * /api/config/load
+	 * The configuration is queued in ConfigLoad_Manager and loaded from the
+	 * main loop; the response carries the job id to poll
+	 * /api/config/status with.
 	 * @return void
 	 */
 
@@ -176,27 +166,19 @@ class ESPAllOnProjects {
 				serializeJson(obj["config"], configJson);
 				DUMPLN("JSON converted to string: ", configJson);
 
-				// Validate all pins before applying configuration
-				String validationError;
-				if (!validatePinsInConfig(obj["config"].as<JsonArray>(),
-										  validationError)) {
-					String errorResponse = "{\"success\":false,\"error\":\"Pin "
-										   "validation failed: " +
-										   validationError + "\"}";
-					DUMPLN("Pin validation failed: ", validationError);
-					request->send(400, "application/json", errorResponse);
+				// Pin validation and loading run as stages of the job
+				uint32_t job =
+					ConfigLoad_Manager::getInstance().submit(configJson);
+				if (job == 0) {
+					request->send(
+						409, "application/json",
+						R"({"success":false,"error":"Configuration load in progress"})");
 					return;
 				}
 
-				bool ok =
-					ESPinner_Manager::getInstance().loadFromJSON(configJson);
-
-				if (ok)
-					request->send(200, "application/json",
-								  R"({"success":true})");
-				else
-					request->send(500, "application/json",
-								  R"({"success":false})");
+				request->send(200, "application/json",
+							  "{\"success\":true,\"job\":" + String(job) +
+								  "}");
 			});
 		ESPUI.server->addHandler(jh);
 	}
@@ -89,6 +89,7 @@ void voidCallback(Control *sender, int type) {}
 void generalCallback(Control *sender, int type);
 void extendedCallback(Control *sender, int type, void *param);
 void ESPINNER_ID_Callback(Control *sender, int type);
+void removeESPinnerUI(uint16_t parentRef);
 
 /** General callback that uses debug functionality */
 void generalCallback(Control *sender, int type) { debugCallback(sender, type); }
@@ -146,106 +147,15 @@ void createPINConfigCallback(Control *sender, int type) {
 		}
 	}
 
-	if (sender->value == GPIO_LABEL) {
-#ifdef _ESPINNER_GPIO_H
-		// If GPIO Model exists avoid duplicates
-		uint16_t is_GPIO_Selector =
-			searchByLabel(parentRef, GPIO_MODESELECTOR_LABEL);
-		if (is_GPIO_Selector == 0) {
-			// Remove previous Model in Espinner Selector
-
-			GPIO_UI(parentRef);
-		}
-#endif
-	}
-
-	if (sender->value == STEPPER_LABEL) {
-#ifdef _ESPINNER_STEPPER_H
-		uint16_t is_Stepper_Selector =
-			searchByLabel(parentRef, STEPPER_MODESELECTOR_LABEL);
-		if (is_Stepper_Selector == 0) {
-			// Remove previous Model in Espinner Selector
-			Stepper_UI(parentRef);
+	const ESPinner_Descriptor *descriptor =
+		findDescriptorByLabel(sender->value.c_str());
+	if (descriptor != nullptr) {
+		// If the module panel already exists avoid duplicates
+		uint16_t isSelector =
+			searchByLabel(parentRef, descriptor->selectorLabel);
+		if (isSelector == 0) {
+			descriptor->buildUI(parentRef);
 		}
-#endif
-	}
-
-	if (sender->value == DC_LABEL) {
-#ifdef _ESPINNER_DC_H
-		// If DC Model exists avoid duplicates
-		uint16_t is_DC_Selector =
-			searchByLabel(parentRef, DC_MODESELECTOR_LABEL);
-		if (is_DC_Selector == 0) {
-			// Remove previous Model in Espinner Selector
-			DC_UI(parentRef);
-		}
-#endif
-	}
-
-	if (sender->value == MPU_LABEL) {
-#ifdef _ESPINNER_MPU_H
-		// If MPU Model exists avoid duplicates
-		uint16_t is_MPU_Selector =
-			searchByLabel(parentRef, MPU_MODESELECTOR_LABEL);
-		if (is_MPU_Selector == 0) {
-			MPU_UI(parentRef);
-		}
-#endif
-	}
-
-	if (sender->value == TFT_LABEL) {
-#ifdef _ESPINNER_TFT_H
-		// If TFT Model exists avoid duplicates
-		uint16_t is_TFT_Selector =
-			searchByLabel(parentRef, TFT_MODESELECTOR_LABEL);
-		if (is_TFT_Selector == 0) {
-			TFT_UI(parentRef);
-		}
-#endif
-	}
-
-	if (sender->value == NEOPIXEL_LABEL) {
-#ifdef _ESPINNER_NEOPIXEL_H
-		// If NEOPIXEL Model exists avoid duplicates
-		uint16_t is_NEOPIXEL_Selector =
-			searchByLabel(parentRef, NEOPIXEL_MODESELECTOR_LABEL);
-		if (is_NEOPIXEL_Selector == 0) {
-			Neopixel_UI(parentRef);
-		}
-#endif
-	}
-
-	if (sender->value == LCD_LABEL) {
-#ifdef _ESPINNER_LCD_H
-		// If LCD Model exists avoid duplicates
-		uint16_t is_LCD_Selector =
-			searchByLabel(parentRef, LCD_MODESELECTOR_LABEL);
-		if (is_LCD_Selector == 0) {
-			LCD_UI(parentRef);
-		}
-#endif
-	}
-
-	if (sender->value == ENCODER_LABEL) {
-#ifdef _ESPINNER_ENCODER_H
-		// If RFID Model exists avoid duplicates
-		uint16_t is_ENCODER_Selector =
-			searchByLabel(parentRef, ENCODER_MODESELECTOR_LABEL);
-		if (is_ENCODER_Selector == 0) {
-			Encoder_UI(parentRef);
-		}
-#endif
-	}
-
-	if (sender->value == RFID_LABEL) {
-#ifdef _ESPINNER_RFID_H
-		// If RFID Model exists avoid duplicates
-		uint16_t is_RFID_Selector =
-			searchByLabel(parentRef, RFID_MODESELECTOR_LABEL);
-		if (is_RFID_Selector == 0) {
-			RFID_UI(parentRef);
-		}
-#endif
 	}
 
 	// Disable EspinnerType Selector and change Label on Parent
@@ -314,59 +224,37 @@ void saveElement_callback(Control *sender, int type) {
 		debugCallback(sender, type);
 		// Review Parent in Selector and Review ESPinner Model
 		uint16_t parentRef = getParentId(elementToParentMap, sender->id);
-		if (sender->value == GPIO_LABEL) {
-#ifdef _ESPINNER_GPIO_H
-			GPIO_UI(parentRef);
-			char *backgroundStyle = getBackground(PENDING_COLOR);
-			ESPUI.setPanelStyle(parentRef, backgroundStyle);
-#endif
-		}
-
-		if (sender->value == DC_LABEL) {
-#ifdef _ESPINNER_DC_H
-			DC_UI(parentRef);
-			DUMPSLN("DC MOTOR");
-			char *backgroundStyle = getBackground(PENDING_COLOR);
-			ESPUI.setPanelStyle(parentRef, backgroundStyle);
-#endif
+		const ESPinner_Descriptor *descriptor =
+			findDescriptorByLabel(sender->value.c_str());
+		if (descriptor != nullptr) {
+			descriptor->buildUI(parentRef);
+			if (descriptor->pendingOnSave) {
+				char *backgroundStyle = getBackground(PENDING_COLOR);
+				ESPUI.setPanelStyle(parentRef, backgroundStyle);
+			}
 		}
+	}
+}
 
-		if (sender->value == NEOPIXEL_LABEL) {
-#ifdef _ESPINNER_NEOPIXEL_H
-			Neopixel_UI(parentRef);
-#endif
-		}
-		if (sender->value == LCD_LABEL) {
-#ifdef _ESPINNER_LCD_H
-			LCD_UI(parentRef);
-#endif
-		}
-		if (sender->value == MPU_LABEL) {
-#ifdef _ESPINNER_MPU_H
-			MPU_UI(parentRef);
-#endif
-		}
-		if (sender->value == TFT_LABEL) {
-#ifdef _ESPINNER_TFT_H
-			TFT_UI(parentRef);
-#endif
-		}
-		if (sender->value == STEPPER_LABEL) {
-#ifdef _ESPINNER_STEPPER_H
-			Stepper_UI(parentRef);
-#endif
-		}
-		if (sender->value == ENCODER_LABEL) {
-#ifdef _ESPINNER_ENCODER_H
-			Encoder_UI(parentRef);
-#endif
-		}
-		if (sender->value == RFID_LABEL) {
-#ifdef _ESPINNER_RFID_H
-			RFID_UI(parentRef);
-#endif
-		}
+/**
+ * Removes the UI panel of an ESPinner together with its controller panel
+ * and the UI relations built around them
+ * @param parentRef UI reference of the ESPinner panel
+ */
+void removeESPinnerUI(uint16_t parentRef) {
+	ESPUI.removeControl(parentRef);
+	uint16_t controllerRef =
+		ESPinner_Manager::getInstance().findUIRelationRefByID(parentRef);
+	if (controllerRef != 0) {
+		ESPUI.removeControl(controllerRef);
+		ESPinner_Manager::getInstance().removeControllerHandle(controllerRef);
+		ESPinner_Manager::getInstance().removeAllControllersByParent(
+			parentRef);
+		ESPinner_Manager::getInstance().removeAllUIRelationBySelector(
+			parentRef);
 	}
+	removeControlId(controlReferences, parentRef);
+	removeChildrenFromMap(elementToParentMap, parentRef);
 }
 
 /**
@@ -385,24 +273,22 @@ void removeElement_callback(Control *sender, int type) {
 			Control *IDController = ESPUI.getControl(espinnerID_ref);
 			ESPinner_Manager::getInstance().debug();
 			if (espinnerID_ref != 0) {
+				// Removed by the user, its runtime state is not resumed
+				ESPinner *espinner =
+					ESPinner_Manager::getInstance().findESPinnerById(
+						IDController->value);
+				if (espinner != nullptr &&
+					espinner->getCheckpointProvider() != nullptr) {
+					getCheckpointService().forget(
+						espinner->getCheckpointProvider());
+				}
+				ESPinner_Manager::getInstance().removeESPinnerControllerMapping(
+					IDController->value);
 				ESPinner_Manager::getInstance().detach(IDController->value);
 			} else {
 				DUMPLN("NOT FOUND TO ERASE: ", espinnerID_ref);
 			}
-
-			ESPUI.removeControl(parentRef);
-			uint16_t controllerRef =
-				ESPinner_Manager::getInstance().findUIRelationRefByID(
-					parentRef);
-			if (controllerRef != 0) {
-				ESPUI.removeControl(controllerRef);
-				ESPinner_Manager::getInstance().removeAllControllersByParent(
-					parentRef);
-				ESPinner_Manager::getInstance().removeAllUIRelationBySelector(
-					parentRef);
-			}
-			removeControlId(controlReferences, parentRef);
-			removeChildrenFromMap(elementToParentMap, parentRef);
+			removeESPinnerUI(parentRef);
 		}
 		ESPinner_Manager::getInstance().saveESPinnersInStorage();
 	}
@@ -419,8 +305,6 @@ void detachRemovedPIN(String expected_label, String espinner_label,
 	if (espinner_label == expected_label) {
 
 		DUMP("DETACH PIN ", espinner_value.toInt())
-		removeValueFromMap(ESPAllOnPinManager::getInstance().getPINMap(),
-						   static_cast<uint16_t>(espinner_value.toInt()));
 		ESPAllOnPinManager::getInstance().detach(espinner_value.toInt());
 	}
 }
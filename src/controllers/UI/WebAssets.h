@@ -0,0 +1,44 @@
+#ifndef _ESPALLON_WEB_ASSETS_H
+#define _ESPALLON_WEB_ASSETS_H
+
+#include "../../config.h"
+#include <ESPUI.h>
+
+#ifdef USE_LITTLEFS_MODE
+#if defined(ESP32)
+#if (ESP_IDF_VERSION_MAJOR == 4 && ESP_IDF_VERSION_MINOR >= 4) ||              \
+	ESP_IDF_VERSION_MAJOR > 4
+#include <LittleFS.h>
+#define WEB_ASSETS_FS LittleFS
+#else
+#include <LITTLEFS.h>
+#define WEB_ASSETS_FS LITTLEFS
+#endif
+#else
+#include <LittleFS.h>
+#define WEB_ASSETS_FS LittleFS
+#endif
+
+/**
+ * Send a web asset from LittleFS
+ * tools/compress_data.py stores text assets as "<path>.gz"; that copy is
+ * sent with Content-Encoding: gzip when present.
+ * @param request AsyncWebServerRequest object
+ * @param path Asset path without the .gz suffix
+ * @param contentType MIME type of the uncompressed asset
+ */
+void sendWebAsset(AsyncWebServerRequest *request, const String &path,
+				  const char *contentType) {
+	String gzipPath = path + ".gz";
+	if (WEB_ASSETS_FS.exists(gzipPath)) {
+		AsyncWebServerResponse *response =
+			request->beginResponse(WEB_ASSETS_FS, gzipPath, contentType);
+		response->addHeader("Content-Encoding", "gzip");
+		request->send(response);
+		return;
+	}
+	request->send(WEB_ASSETS_FS, path, contentType);
+}
+#endif
+
+#endif
@@ -0,0 +1,224 @@
+#ifndef _DATA_PIN_STATUS_HTML_H
+#define _DATA_PIN_STATUS_HTML_H
+
+#include <Arduino.h>
+
+// Embedded pin status page, same as data/pin-status.html with its CSS and
+// JavaScript inlined
+const char PIN_STATUS_HTML[] PROGMEM = R"rawliteral(
+<!DOCTYPE html>
+<html lang="en">
+	<head>
+		<meta charset="UTF-8" />
+		<meta name="viewport" content="width=device-width, initial-scale=1.0" />
+		<title>ESP Pin Status - ESPAllOn</title>
+		<style>
+:root{--bg:#f5f5f5;--card:#fff;--text:#333;--muted:#6c757d;--border:#ddd;--primary:#007bff;--success:#28a745;--info:#17a2b8;--danger:#dc3545;--warning:#ffc107;--even:#f8f9fa;--hover:#e9ecef}*{box-sizing:border-box}html,body{margin:0;padding:0;font-family:Arial,sans-serif;background:var(--bg);color:var(--text)}.container{max-width:1200px;margin:0 auto;background:var(--card);padding:20px;border-radius:8px;box-shadow:0 2px 10px rgba(0,0,0,.1)}h1{text-align:center;margin:0 0 20px;color:var(--text)}.info-section{background:var(--hover);padding:15px;border-radius:5px;margin-bottom:20px}.info-section p{margin:5px 0}table{width:100%;border-collapse:collapse;margin:20px 0;font-size:14px}th,td{padding:8px 12px;text-align:left;border:1px solid var(--border)}th{background:var(--muted);color:#fff;font-weight:700}tr:nth-child(even){background:var(--even)}tr:hover{background:var(--hover)}.pin-number{font-weight:700;text-align:center}.status-used,.status-available,.status-broken,.status-not-configured,.mode-input,.mode-output,.mode-undefined{text-align:center;border-radius:3px}.status-used,.mode-output{background:var(--success);color:#fff}.status-available{background:var(--info);color:#fff}.status-broken{background:var(--danger);color:#fff}.status-not-configured{background:#87ceeb;color:#333}.mode-input{background:var(--warning);color:#212529}.mode-undefined{background:var(--muted);color:#fff}.flag-yes{color:var(--success);font-weight:700}.flag-no{color:var(--danger)}.level{text-align:center;font-family:monospace}.level-high{color:var(--success);font-weight:700}.level-low{color:var(--muted)}.pin-type{font-family:monospace;font-size:12px}.legend{margin:20px 0;padding:15px;background:var(--even);border-radius:5px}.legend h3{margin:0 0 10px}.legend-item{display:inline-block;margin:5px 10px}.legend-color{display:inline-block;width:20px;height:20px;margin-right:5px;vertical-align:middle;border-radius:3px}.legend-color.in-use{background:var(--success)}.legend-color.available{background:var(--info)}.legend-color.broken{background:var(--danger)}.legend-color.not-configured{background:#87ceeb}.actions{text-align:center;margin:20px 0}.actions button{padding:10px 20px;margin:0 10px;background:var(--primary);color:#fff;border:0;border-radius:5px;cursor:pointer;font-size:16px}.actions button:hover{background:#0056b3}@media(max-width:768px){.container{padding:10px}table{font-size:12px}th,td{padding:4px 6px}}
+		</style>
+	</head>
+	<body>
+		<div class="container">
+			<h1>ESP Pin Configuration &amp; Status</h1>
+			<div class="info-section">
+				<p><strong>Board:</strong> <span id="pin-board">-</span></p>
+				<p><strong>Total Pins:</strong> <span id="pin-total">-</span></p>
+				<div class="actions">
+					<button onclick="refreshPins()">Refresh</button>
+					<button onclick="location.href='/'">Back to Main</button>
+				</div>
+			</div>
+			<table>
+				<thead>
+					<tr id="pin-header"></tr>
+				</thead>
+				<tbody id="pin-rows"></tbody>
+			</table>
+			<div class="legend">
+				<h3>Legend</h3>
+				<div class="legend-item">
+					<span class="legend-color in-use"></span>IN USE / USED
+				</div>
+				<div class="legend-item">
+					<span class="legend-color available"></span>AVAILABLE
+				</div>
+				<div class="legend-item">
+					<span class="legend-color broken"></span>BROKEN / RESERVED
+				</div>
+				<div class="legend-item">
+					<span class="legend-color not-configured"></span>NOT CONFIGURED
+				</div>
+			</div>
+		</div>
+		<script>
+/* ========== Pin Status ========== */
+// Renders /api/pins and the live pin levels pushed on /pin-status/events.
+// The table is fetched again when the device reports a pin state change;
+// without EventSource the page falls back to polling, answered with 304
+// while the pin state is unchanged.
+
+const PIN_ATTACHED = 1;
+const PIN_BROKEN = 2;
+const PIN_RESERVED = 4;
+const PIN_CONFIGURED = 8;
+
+const CAP_EXISTS = 0x0001;
+const PIN_COLUMNS = [
+	['ADC', 0x0008 | 0x0010],
+	['Touch', 0x0020],
+	['RTC / Deep Sleep', 0x0080],
+	['PWM', 0x0100],
+	['Strapping', 0x0040],
+	['Input Only', 0x0004],
+];
+const PIN_MODES = [
+	['mode-undefined', 'UNDEFINED'],
+	['mode-input', 'INPUT'],
+	['mode-output', 'OUTPUT'],
+];
+const PIN_REFRESH_MS = 2000;
+
+let pinStatusTag = null;
+const pinLevels = new Map();
+
+function pinStatus(caps, state, ref) {
+	const blocked = state & (PIN_BROKEN | PIN_RESERVED);
+	const inUse = !blocked && ref !== 0;
+	if (!(caps & CAP_EXISTS)) {
+		return ['status-not-configured', 'NOT PRESENT'];
+	}
+	if (!(state & PIN_CONFIGURED)) {
+		return inUse
+			? ['status-used', 'IN USE']
+			: ['status-not-configured', 'NOT CONFIGURED'];
+	}
+	if (blocked) {
+		return ['status-broken', state & PIN_BROKEN ? 'BROKEN' : 'RESERVED'];
+	}
+	if (state & PIN_ATTACHED || inUse) {
+		return ['status-used', inUse ? 'IN USE' : 'USED'];
+	}
+	return ['status-available', 'AVAILABLE'];
+}
+
+function pinCell(text, className) {
+	const cell = document.createElement('td');
+	if (className) {
+		cell.className = className;
+	}
+	cell.textContent = text;
+	return cell;
+}
+
+function renderPinHeader() {
+	const row = document.getElementById('pin-header');
+	const titles = ['Pin #', 'GPIO', 'Status', 'Level', 'Mode', 'Pin Type'];
+	PIN_COLUMNS.forEach((column) => titles.push(column[0]));
+	titles.push('UI Ref');
+	titles.forEach((title) => {
+		const th = document.createElement('th');
+		th.textContent = title;
+		row.appendChild(th);
+	});
+}
+
+function renderPins(data) {
+	document.getElementById('pin-board').textContent = data.board;
+	document.getElementById('pin-total').textContent = data.pins.length;
+
+	const body = document.getElementById('pin-rows');
+	const rows = document.createDocumentFragment();
+	data.pins.forEach(([gpio, caps, state, ref, mode, type]) => {
+		const row = document.createElement('tr');
+		const status = pinStatus(caps, state, ref);
+		const configured = state & PIN_CONFIGURED;
+		const pinMode = configured
+			? PIN_MODES[mode] || PIN_MODES[0]
+			: ['mode-undefined', 'NOT CONFIGURED'];
+		const blocked = state & (PIN_BROKEN | PIN_RESERVED);
+
+		row.appendChild(pinCell(gpio, 'pin-number'));
+		row.appendChild(pinCell(gpio, 'pin-number'));
+		row.appendChild(pinCell(status[1], status[0]));
+		const level = pinCell('-', 'level');
+		level.id = 'level-' + gpio;
+		row.appendChild(level);
+		row.appendChild(pinCell(pinMode[1], pinMode[0]));
+		row.appendChild(pinCell(configured ? type : 'None', 'pin-type'));
+		PIN_COLUMNS.forEach((column) => {
+			const flag = caps & column[1];
+			row.appendChild(
+				pinCell(flag ? 'YES' : 'NO', flag ? 'flag-yes' : 'flag-no')
+			);
+		});
+		row.appendChild(pinCell(blocked ? 'BLOCKED' : ref || '-'));
+		rows.appendChild(row);
+	});
+	body.replaceChildren(rows);
+	pinLevels.forEach((value, gpio) => showLevel(gpio));
+}
+
+function showLevel(gpio) {
+	const cell = document.getElementById('level-' + gpio);
+	if (!cell) {
+		return;
+	}
+	const value = pinLevels.get(gpio);
+	if (value === undefined) {
+		cell.textContent = '-';
+		cell.className = 'level';
+	} else if (value === 0 || value === 1) {
+		cell.textContent = value ? 'HIGH' : 'LOW';
+		cell.className = value ? 'level level-high' : 'level level-low';
+	} else {
+		cell.textContent = value;
+		cell.className = 'level';
+	}
+}
+
+// {"t": ms, "p": [[gpio, value], ...]}, a null value stops the pin
+function applyLevels(diff) {
+	diff.p.forEach(([gpio, value]) => {
+		if (value === null) {
+			pinLevels.delete(gpio);
+		} else {
+			pinLevels.set(gpio, value);
+		}
+		showLevel(gpio);
+	});
+}
+
+async function refreshPins() {
+	try {
+		const response = await fetch('/api/pins', { cache: 'no-cache' });
+		if (!response.ok) {
+			return;
+		}
+		// A revalidated 304 arrives here as the cached 200 with the same tag
+		const tag = response.headers.get('ETag');
+		if (tag !== null && tag === pinStatusTag) {
+			return;
+		}
+		pinStatusTag = tag;
+		renderPins(await response.json());
+	} catch (error) {
+		console.error('Pin status refresh failed', error);
+	}
+}
+
+renderPinHeader();
+refreshPins();
+if (window.EventSource) {
+	const events = new EventSource('/pin-status/events');
+	events.addEventListener('levels', (event) =>
+		applyLevels(JSON.parse(event.data))
+	);
+	events.addEventListener('pins', refreshPins);
+} else {
+	setInterval(refreshPins, PIN_REFRESH_MS);
+}
+		</script>
+	</body>
+</html>
+)rawliteral";
+
+#endif
@@ -296,6 +296,21 @@ const char PROJECTS_HTML[] PROGMEM = R"rawliteral(
             showStatus('✅ Seleccionado: ' + project.name, 'success');
         }
         
+        async function waitForConfigJob(jobId) {
+            for (;;) {
+                const response = await fetch('/api/config/status?job=' + jobId);
+                if (!response.ok) throw new Error('Error HTTP: ' + response.status);
+                
+                const status = await response.json();
+                if (status.stage === 'done') return status;
+                if (status.stage === 'failed') {
+                    throw new Error(status.error || 'Error al cargar configuración');
+                }
+                showStatus('⏳ Cargando configuración (' + status.stage + ' ' + status.done + '/' + status.total + ')...', 'loading');
+                await new Promise(resolve => setTimeout(resolve, 250));
+            }
+        }
+        
         async function loadProject(projectId) {
             const project = projects.find(p => p.id === projectId);
             if (!project) return;
@@ -322,6 +337,7 @@ const char PROJECTS_HTML[] PROGMEM = R"rawliteral(
                 
                 const result = await response.json();
                 if (result.success) {
+                    await waitForConfigJob(result.job);
                     showStatus('🎉 Configuración cargada: ' + project.name, 'success');
                 } else {
                     throw new Error(result.message || 'Error desconocido al cargar configuración');
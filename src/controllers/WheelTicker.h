@@ -0,0 +1,103 @@
+#ifndef _ESPALLON_WHEELTICKER_H
+#define _ESPALLON_WHEELTICKER_H
+
+#include "../manager/TimerWheel.h"
+
+#include <Arduino.h>
+#include <TickerFree.h>
+
+/**
+ * Periodic ticker backed by the timer wheel of the loop
+ *
+ * Drop-in for the TickerFree calls of the controllers and ESPinners: the
+ * callback fires from getTimerWheel().advance() instead of a per ticker
+ * update(), so idle tickers cost nothing on a loop pass. Intervals are in
+ * ms; MICROS intervals are rounded up to whole ms.
+ *
+ * A ticker owns one timer of the wheel pool while it lives, so it can be
+ * neither copied nor moved. A ticker built with the pool exhausted has no
+ * timer: hasTimer() is false, start() leaves it STOPPED and the wheel
+ * counts the failure (TimerWheel::getExhausted()).
+ */
+class WheelTicker {
+  public:
+	typedef std::function<void()> TickerCallback;
+
+	/**
+	 * @param interval Time between callbacks
+	 * @param repeats Callbacks before the ticker stops, 0 for endless
+	 */
+	WheelTicker(TickerCallback callback, uint32_t interval,
+				uint32_t repeats = 0, resolution_t resolution = MILLIS)
+		: callback(callback), repeats(repeats) {
+		this->interval(resolution == MICROS ? (interval + 999) / 1000
+											: interval);
+		timer = getTimerWheel().create([this]() { this->fire(); });
+	}
+
+	WheelTicker(const WheelTicker &) = delete;
+	WheelTicker &operator=(const WheelTicker &) = delete;
+
+	virtual ~WheelTicker() { getTimerWheel().release(timer); }
+
+	/**
+	 * Starts the ticker and resets its counter, first callback one interval
+	 * from now
+	 */
+	void start() {
+		counts = 0;
+		if (timer < 0) {
+			return;
+		}
+		status = RUNNING;
+		getTimerWheel().start(timer, period, period);
+	}
+
+	void stop() {
+		status = STOPPED;
+		getTimerWheel().stop(timer);
+	}
+
+	/**
+	 * Changes the interval, a running ticker restarts its period from now
+	 */
+	void interval(uint32_t interval_ms) {
+		period = interval_ms > 0 ? interval_ms : 1;
+		if (status == RUNNING) {
+			getTimerWheel().start(timer, period, period);
+		}
+	}
+	uint32_t interval() const { return period; }
+
+	void setCallback(TickerCallback callback) { this->callback = callback; }
+
+	status_t state() const { return status; }
+
+	/** False if the timer pool was exhausted when the ticker was built */
+	bool hasTimer() const { return timer >= 0; }
+
+	/** Callbacks since the last start() */
+	uint32_t counter() const { return counts; }
+
+  private:
+	TickerCallback callback;
+	TimerWheel::TimerHandle timer = -1;
+	uint32_t period = 1;
+	uint32_t repeats;
+	uint32_t counts = 0;
+	status_t status = STOPPED;
+
+	void fire() {
+		counts++;
+		if (repeats > 0 && counts >= repeats) {
+			stop();
+		}
+		// A copy: the callback may replace itself, as the wifi ticker does
+		TickerCallback current = callback;
+		if (current) {
+			current();
+		}
+	}
+};
+
+#endif
@@ -9,8 +9,15 @@
 
 #include "controllers/UI/ESPAllOnGUI.h"
 #include "manager/ESPAllOn.h"
-#include "mods/ESPinner_NeoPixel/NeopixelRunner.h"
+#include "manager/ConfigLoad_Manager.h"
+#include "manager/CheckpointService.h"
+#include "manager/LoopProfiler.h"
+#include "manager/Scheduler.h"
+#include "manager/StateJournal.h"
+#include "manager/TimerWheel.h"
+#if ESPALLON_MOD_STEPPER
 #include "mods/ESPinner_Stepper/StepperRunner.h"
+#endif
 #include <TickerFree.h>
 
 #if MEMORYDEBUG
@@ -41,7 +48,148 @@ String nameAction = "Send MQTT Message";
 ESPAction ACTION(nameAction, "ACTION1", externalAction);
 ESPAction ACTION2("BLocked Door", "ACTION2", externalAction2);
 
-ESPALLON_Wifi wifi = ESPALLON_Wifi::getInstance();
+ESPALLON_Wifi &wifi = ESPALLON_Wifi::getInstance();
+
+/**
+ * Serial debug commands
+ */
+void handleSerialCommands() {
+	if (!Serial.available()) {
+		return;
+	}
+	switch (Serial.read()) {
+	case 'w': // Print IP details
+		Serial.println(WiFi.localIP());
+		break;
+	case 'W': // Reconnect wifi
+		wifi.connectWifi();
+		break;
+	case 'C': // Force a crash (for testing exception decoder)
+#if !defined(ESP32)
+		((void (*)())0xf00fdead)();
+#endif
+		break;
+	case 'O': // Force a crash (for testing exception decoder)
+		DUMP_PINOUT();
+		break;
+	case 'M': // Print storage backend usage
+		DUMP_STORAGE();
+		break;
+	case 'P': // Print loop profiler histograms
+		printLoopProfile(Serial);
+		break;
+	case 'p': // Reset loop profiler histograms
+		getLoopProfiler().reset();
+		break;
+	case 'S': // Stop all steppers
+		ESPinner_Manager::getInstance().stopAllSteppers();
+		break;
+	case 'T': // Print scheduler statistics
+		printSchedulerStats(Serial);
+		Serial.printf("timers armed %u, fired %u, next in %u ms, pool "
+					  "exhausted %u\n",
+					  (unsigned)getTimerWheel().armedCount(),
+					  (unsigned)getTimerWheel().getFired(),
+					  (unsigned)getTimerWheel().timeUntilNext(),
+					  (unsigned)getTimerWheel().getExhausted());
+		ESPinner_Manager::getInstance().printStepperCommandStats(Serial);
+#if ESPALLON_MOD_STEPPER
+		{
+			const StepAdmission<StepperRunner::MAX_STEPPERS> &admission =
+				StepperRunner::getInstance().getAdmission();
+			Serial.printf("step rate %.0f of %.0f steps/s, overloads %u\n",
+						  admission.getTotal(), admission.getCapacity(),
+						  (unsigned)admission.getOverloads());
+		}
+#endif
+#if ESPALLON_MOD_STEPPER && MOTION_TASK_ENABLED
+		if (getMotionTask().isRunning()) {
+			MotionTaskStats motion = getMotionTask().getStats();
+			Serial.printf("motion task iterations %u, commands %u, max step "
+						  "gap %u us, max command wait %u us\n",
+						  (unsigned)motion.iterations,
+						  (unsigned)motion.commands,
+						  (unsigned)motion.maxStepGap,
+						  (unsigned)motion.maxCommandWait);
+		}
+#endif
+		break;
+	default:
+		DUMP_PINOUT();
+		break;
+	}
+}
+
+/**
+ * Registers the work of loop() with the scheduler
+ * Steppers are motion tasks and run between all other tasks; budgets are
+ * the expected worst case of each task, in us.
+ */
+void registerLoopTasks() {
+	Scheduler &scheduler = getScheduler();
+#if LOOP_PROFILER_ENABLED
+	// Before the motion task starts recording the stepper stages
+	scheduler.setProfiler(&getLoopProfiler());
+#endif
+#if ESPALLON_MOD_STEPPER
+	// Steppers run on the motion task when it starts, else from loop()
+	bool motionTask = false;
+#if MOTION_TASK_ENABLED
+	motionTask = getMotionTask().start();
+#endif
+	if (!motionTask) {
+		scheduler.addTask("steppers", TaskClass::Motion,
+						  []() { StepperRunner::getInstance().runAll(); });
+	}
+	if (STEPPER_STEP_CAPACITY <= 0) {
+		// On the task that runs the steppers, before any of them moves
+		float capacity = StepperRunner::getInstance().calibrateCapacity(
+			STEPPER_CALIBRATION_MAX_SPEED, STEPPER_CALIBRATION_TRIAL_US,
+			STEPPER_CAPACITY_SHARE);
+		DUMPLN("Step capacity (steps/s): ", capacity);
+	}
+#endif
+	// Wifi, stepper action and NeoPixel animation tickers; only due timers
+	// cost time. strip.show() takes 30 us per LED with interrupts off
+	scheduler.addTask(
+		"timers", TaskClass::Animation, []() { getTimerWheel().advance(); }, 0,
+		3000);
+	// Advance a pending project load within its time budget
+	scheduler.addTask(
+		"config-load", TaskClass::Background,
+		[]() { ConfigLoad_Manager::getInstance().update(); }, 0,
+		CONFIG_LOAD_BUDGET_MS * 1000);
+	scheduler.addTask(
+		"checkpoint", TaskClass::Background,
+		[]() { getCheckpointService().update(clockMillis()); }, 0, 1000);
+	scheduler.addTask(
+		"journal", TaskClass::Background, []() { getStateJournal().update(); },
+		0, 5000);
+	scheduler.addTask(
+		"pin-status", TaskClass::Background,
+		[]() { ESPAllOnPinStatus::update(clockMillis()); },
+		PIN_TELEMETRY_INTERVAL_MS * 1000, 1000);
+	scheduler.addTask("serial", TaskClass::Background, handleSerialCommands);
+	scheduler.addTask("network", TaskClass::Background, []() {
+#if !defined(ESP32)
+		{
+			// We don't need to call this explicitly on ESP32 but we do on 8266
+			LOOP_PROFILE("mdns");
+			MDNS.update();
+		}
+#endif
+		// Process DNS requests for captive portal when in AP mode
+		if (WiFi.getMode() == WIFI_AP || WiFi.getMode() == WIFI_AP_STA) {
+			LOOP_PROFILE("dns");
+			extern DNSServer dnsServer;
+			dnsServer.processNextRequest();
+		}
+	});
+#if MEMORYDEBUG
+	scheduler.addTask("memory", TaskClass::Background,
+					  []() { Memory_Ticker.update(); });
+#endif
+}
 
 /**
  * Setup initializes all system components
@@ -68,8 +216,11 @@ void setup() {
 	ESPAllOn::getInstance().setup();
 	ESPAllOn::getInstance().begin();
 
+	// Runtime state first, so ESPinners can read it while implemented
+	getStateJournal().replay();
 	ESPinner_Manager::getInstance().loadFromStorage();
 	wifi.begin();
+	registerLoopTasks();
 
 #if MEMORYDEBUG
 	Memory_Ticker.start();
@@ -77,51 +228,8 @@ void setup() {
 }
 
 /**
- * Main loop function - handles UI updates, WiFi management, and serial
- * Continuously updates the UI ticker, manages WiFi connection, and processes
- * serial commands for debugging and configuration purposes.
+ * Main loop function - runs one pass of the scheduler
+ * Motion, animation, UI, network and storage work are registered as tasks
+ * in registerLoopTasks().
  */
-void loop() {
-	wifi.update();
-
-	// Execute all steppers in the StepperRunner (non-blocking)
-	StepperRunner::getInstance().runAll();
-	NeopixelRunner::getInstance().runAll();
-
-	if (Serial.available()) {
-		switch (Serial.read()) {
-		case 'w': // Print IP details
-			Serial.println(WiFi.localIP());
-			break;
-		case 'W': // Reconnect wifi
-			wifi.connectWifi();
-			break;
-		case 'C': // Force a crash (for testing exception decoder)
-#if !defined(ESP32)
-			((void (*)())0xf00fdead)();
-#endif
-			break;
-		case 'O': // Force a crash (for testing exception decoder)
-			DUMP_PINOUT();
-			break;
-		default:
-			DUMP_PINOUT();
-			break;
-		}
-	}
-
-#if !defined(ESP32)
-	// We don't need to call this explicitly on ESP32 but we do on 8266
-	MDNS.update();
-#endif
-
-	// Process DNS requests for captive portal when in AP mode
-	if (WiFi.getMode() == WIFI_AP || WiFi.getMode() == WIFI_AP_STA) {
-		extern DNSServer dnsServer;
-		dnsServer.processNextRequest();
-	}
-
-#if MEMORYDEBUG
-	Memory_Ticker.update();
-#endif
-}
\ No newline at end of file
+void loop() { getScheduler().run(); }
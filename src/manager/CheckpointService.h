@@ -0,0 +1,242 @@
+#ifndef _ESPALLON_CHECKPOINTSERVICE_H
+#define _ESPALLON_CHECKPOINTSERVICE_H
+
+#include "StateJournal.h"
+
+#include <algorithm>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+// Time between two samples of the registered providers
+#ifndef CHECKPOINT_INTERVAL_MS
+#define CHECKPOINT_INTERVAL_MS 500
+#endif
+
+/**
+ * One checkpointed value of a provider
+ * The journal key is "<checkpointID>/<name>".
+ */
+struct CheckpointChannel {
+	const char *name;
+	int32_t threshold; // Minimum change written while the value keeps moving
+};
+
+/**
+ * Runtime state that should survive a reset
+ *
+ * Implemented by ESPinners whose state would otherwise be lost on reboot,
+ * e.g. a stepper position. Values are sampled as int32_t per channel.
+ */
+class ICheckpointProvider {
+  public:
+	virtual ~ICheckpointProvider() = default;
+
+	/** Prefix of the journal keys, usually the ESPinner ID */
+	virtual const char *checkpointID() = 0;
+
+	/**
+	 * @param channels Output table of channels
+	 * @return Number of channels in the table
+	 */
+	virtual uint8_t checkpointChannels(const CheckpointChannel *&channels) = 0;
+
+	/**
+	 * @return False if the value is not available, e.g. no driver yet
+	 */
+	virtual bool sampleCheckpoint(uint8_t channel, int32_t &value) = 0;
+
+	virtual void restoreCheckpoint(uint8_t channel, int32_t value) = 0;
+};
+
+/**
+ * Throttled checkpointing of runtime state into the StateJournal
+ *
+ * Providers are sampled every interval. A value is written when it moved at
+ * least its channel threshold since the last write, or when it stopped
+ * moving at a value that differs from the written one. A stepper running a
+ * long move is therefore written every few hundred steps, and its exact
+ * position once it settles, so the machine resumes without re-homing.
+ */
+class CheckpointService {
+  private:
+	struct ChannelState {
+		int32_t saved = 0;
+		int32_t previous = 0;
+		bool hasSaved = false;
+		bool hasPrevious = false;
+	};
+
+	struct Entry {
+		ICheckpointProvider *provider;
+		std::vector<ChannelState> channels;
+	};
+
+	StateJournal &journal;
+	std::vector<Entry> entries;
+	uint32_t interval;
+	uint32_t lastSample = 0;
+	bool sampledOnce = false;
+
+	uint32_t samples = 0;
+	uint32_t writes = 0;
+
+	static std::string channelKey(ICheckpointProvider *provider,
+								  const CheckpointChannel &channel) {
+		std::string key = provider->checkpointID();
+		key += '/';
+		key += channel.name;
+		return key;
+	}
+
+	Entry *findEntry(ICheckpointProvider *provider) {
+		for (Entry &entry : entries) {
+			if (entry.provider == provider) {
+				return &entry;
+			}
+		}
+		return nullptr;
+	}
+
+	void sampleEntry(Entry &entry) {
+		const CheckpointChannel *channels = nullptr;
+		uint8_t count = entry.provider->checkpointChannels(channels);
+		entry.channels.resize(count);
+		for (uint8_t i = 0; i < count; i++) {
+			int32_t value;
+			if (!entry.provider->sampleCheckpoint(i, value)) {
+				continue;
+			}
+			ChannelState &state = entry.channels[i];
+			bool settled = state.hasPrevious && value == state.previous;
+			state.previous = value;
+			state.hasPrevious = true;
+			if (state.hasSaved && value == state.saved) {
+				continue;
+			}
+			int32_t delta = state.hasSaved ? abs(value - state.saved) : 0;
+			if (state.hasSaved && !settled && delta < channels[i].threshold) {
+				continue;
+			}
+			if (journal.put(channelKey(entry.provider, channels[i]).c_str(),
+							value)) {
+				state.saved = value;
+				state.hasSaved = true;
+				writes++;
+			}
+		}
+	}
+
+  public:
+	CheckpointService(StateJournal &stateJournal,
+					  uint32_t intervalMs = CHECKPOINT_INTERVAL_MS)
+		: journal(stateJournal), interval(intervalMs) {}
+
+	void add(ICheckpointProvider *provider) {
+		if (findEntry(provider) == nullptr) {
+			entries.push_back({provider, {}});
+		}
+	}
+
+	/**
+	 * Stop sampling a provider, e.g. before it is destroyed
+	 * Its stored values are kept so it can be restored later.
+	 */
+	void remove(ICheckpointProvider *provider) {
+		entries.erase(std::remove_if(entries.begin(), entries.end(),
+									 [provider](const Entry &entry) {
+										 return entry.provider == provider;
+									 }),
+					  entries.end());
+	}
+
+	void clear() { entries.clear(); }
+
+	/**
+	 * Apply the stored values of a provider
+	 * @return Number of channels restored
+	 */
+	uint8_t restore(ICheckpointProvider *provider) {
+		const CheckpointChannel *channels = nullptr;
+		uint8_t count = provider->checkpointChannels(channels);
+		Entry *entry = findEntry(provider);
+		if (entry != nullptr) {
+			entry->channels.resize(count);
+		}
+		uint8_t restored = 0;
+		for (uint8_t i = 0; i < count; i++) {
+			int32_t value;
+			if (!journal.get(channelKey(provider, channels[i]).c_str(),
+							 value)) {
+				continue;
+			}
+			provider->restoreCheckpoint(i, value);
+			if (entry != nullptr) {
+				entry->channels[i].saved = value;
+				entry->channels[i].hasSaved = true;
+			}
+			restored++;
+		}
+		return restored;
+	}
+
+	/**
+	 * Drop the stored values of a provider, e.g. when its ESPinner is
+	 * removed by the user
+	 */
+	void forget(ICheckpointProvider *provider) {
+		const CheckpointChannel *channels = nullptr;
+		uint8_t count = provider->checkpointChannels(channels);
+		for (uint8_t i = 0; i < count; i++) {
+			journal.erase(channelKey(provider, channels[i]).c_str());
+		}
+		Entry *entry = findEntry(provider);
+		if (entry != nullptr) {
+			entry->channels.clear();
+		}
+	}
+
+	/**
+	 * Sample every provider once, ignoring the interval
+	 */
+	void sample() {
+		for (Entry &entry : entries) {
+			sampleEntry(entry);
+		}
+		samples++;
+	}
+
+	/**
+	 * Sample the providers when the interval has elapsed
+	 * @param now Current time in milliseconds
+	 * @return True if the providers were sampled
+	 */
+	bool update(uint32_t now) {
+		if (sampledOnce && now - lastSample < interval) {
+			return false;
+		}
+		sampledOnce = true;
+		lastSample = now;
+		sample();
+		return true;
+	}
+
+	void setInterval(uint32_t intervalMs) { interval = intervalMs; }
+	uint32_t getInterval() const { return interval; }
+	size_t size() const { return entries.size(); }
+	uint32_t getSamples() const { return samples; }
+	uint32_t getWrites() const { return writes; }
+};
+
+#ifdef ARDUINO
+/**
+ * Checkpoint service writing into the runtime state journal
+ */
+CheckpointService &getCheckpointService() {
+	static CheckpointService service(getStateJournal());
+	return service;
+}
+#endif
+
+#endif
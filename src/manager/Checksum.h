@@ -0,0 +1,25 @@
+#ifndef _ESPALLON_CHECKSUM_H
+#define _ESPALLON_CHECKSUM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320)
+ * Kept free of Arduino headers so host tests can use it.
+ * @param data Buffer to checksum
+ * @param length Number of bytes
+ * @param crc Previous CRC to chain several buffers
+ */
+uint32_t crc32(const uint8_t *data, size_t length, uint32_t crc = 0) {
+	crc = ~crc;
+	for (size_t i = 0; i < length; i++) {
+		crc ^= data[i];
+		for (uint8_t bit = 0; bit < 8; bit++) {
+			crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+		}
+	}
+	return ~crc;
+}
+
+#endif
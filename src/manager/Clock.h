@@ -0,0 +1,101 @@
+#ifndef _ESPALLON_CLOCK_H
+#define _ESPALLON_CLOCK_H
+
+#include <stdint.h>
+
+#ifndef ARDUINO
+#include <chrono>
+#endif
+
+/**
+ * Time source of the loop: the scheduler, the timer wheel and the motion
+ * task read the time through clockMicros() and clockMillis() only
+ *
+ * Defaults to micros()/millis() on target and steady_clock on the host.
+ * setClockSource() swaps it, e.g. for a VirtualClock that a simulation
+ * advances by hand. Swap it before the loop singletons run: readers on
+ * other tasks do not synchronize with the swap.
+ */
+struct ClockSource {
+	uint32_t (*micros)();
+	uint32_t (*millis)();
+};
+
+#ifdef ARDUINO
+inline ClockSource systemClockSource() {
+	return {[]() -> uint32_t { return micros(); },
+			[]() -> uint32_t { return millis(); }};
+}
+#else
+inline ClockSource systemClockSource() {
+	return {[]() -> uint32_t {
+				return static_cast<uint32_t>(
+					std::chrono::duration_cast<std::chrono::microseconds>(
+						std::chrono::steady_clock::now().time_since_epoch())
+						.count());
+			},
+			[]() -> uint32_t {
+				return static_cast<uint32_t>(
+					std::chrono::duration_cast<std::chrono::milliseconds>(
+						std::chrono::steady_clock::now().time_since_epoch())
+						.count());
+			}};
+}
+#endif
+
+inline ClockSource &activeClockSource() {
+	static ClockSource source = systemClockSource();
+	return source;
+}
+
+inline void setClockSource(const ClockSource &source) {
+	activeClockSource() = source;
+}
+
+inline uint32_t clockMicros() { return activeClockSource().micros(); }
+inline uint32_t clockMillis() { return activeClockSource().millis(); }
+
+/**
+ * Clock that only moves when advanced
+ *
+ * Keeps 64 bit nanoseconds, so a simulation can charge sub-microsecond
+ * costs, run past the 32 bit micros() wrap and still order its events.
+ * micros() and millis() wrap like the Arduino ones. It never moves back:
+ * the timer wheel and the scheduler remember the last time they saw.
+ */
+class VirtualClock {
+  private:
+	uint64_t nanos = 0;
+
+  public:
+	uint64_t nowNanos() const { return nanos; }
+	uint64_t nowMicros() const { return nanos / 1000; }
+	uint32_t micros() const { return static_cast<uint32_t>(nanos / 1000); }
+	uint32_t millis() const { return static_cast<uint32_t>(nanos / 1000000); }
+
+	void advance(uint64_t us) { nanos += us * 1000; }
+	void advanceNanos(uint64_t ns) { nanos += ns; }
+	/** Moves to a time in us, never backwards */
+	void advanceTo(uint64_t us) {
+		if (us * 1000 > nanos) {
+			nanos = us * 1000;
+		}
+	}
+};
+
+inline VirtualClock &getVirtualClock() {
+	static VirtualClock clock;
+	return clock;
+}
+
+/**
+ * Routes clockMicros() and clockMillis() to getVirtualClock()
+ */
+inline void useVirtualClock() {
+	setClockSource({[]() -> uint32_t { return getVirtualClock().micros(); },
+					[]() -> uint32_t { return getVirtualClock().millis(); }});
+}
+
+inline void useSystemClock() { setClockSource(systemClockSource()); }
+
+#endif
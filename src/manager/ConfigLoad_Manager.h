@@ -0,0 +1,250 @@
+#ifndef _ESPALLON_CONFIGLOAD_MANAGER_H
+#define _ESPALLON_CONFIGLOAD_MANAGER_H
+
+#include "../config.h"
+#include "../controllers/ESPAllOnPinManager.h"
+#include "ESPinner_Manager.h"
+#include "PinValidation.h"
+
+/**
+ * Stages of a project load job, run in declaration order
+ */
+enum class ConfigLoadStage : uint8_t {
+	Idle,		 // No job submitted yet
+	Parse,		 // Parse the received configuration
+	Validate,	 // Assign and check pins, plan the diff against running ESPinners
+	Instantiate, // Tear down removed ESPinners and create the new ones
+	BuildUI,	 // GUI and pin manager setup of each new ESPinner
+	Persist,	 // Save the configuration in storage
+	Done,		 // Job finished successfully
+	Failed		 // Job aborted, see getError()
+};
+
+/**
+ * Gets the name reported by the status endpoint for a load stage
+ */
+const char *getConfigLoadStageName(ConfigLoadStage stage) {
+	switch (stage) {
+	case ConfigLoadStage::Idle:
+		return "idle";
+	case ConfigLoadStage::Parse:
+		return "parse";
+	case ConfigLoadStage::Validate:
+		return "validate";
+	case ConfigLoadStage::Instantiate:
+		return "instantiate";
+	case ConfigLoadStage::BuildUI:
+		return "ui";
+	case ConfigLoadStage::Persist:
+		return "persist";
+	case ConfigLoadStage::Done:
+		return "done";
+	case ConfigLoadStage::Failed:
+		return "failed";
+	}
+	return "unknown";
+}
+
+/**
+ * Runs project configuration loads from the main loop in small steps
+ *
+ * The HTTP handler only queues the configuration and answers with a job id.
+ * update() is called on every loop() iteration and advances the job one step
+ * at a time (one ESPinner torn down, created or implemented per step) until
+ * CONFIG_LOAD_BUDGET_MS is spent, so runners keep working during the load.
+ *
+ * Only one job runs at a time; submit() is refused while a job is busy.
+ */
+class ConfigLoad_Manager {
+  private:
+	volatile ConfigLoadStage stage = ConfigLoadStage::Idle;
+	uint32_t jobId = 0;
+	String pendingConfig;
+	String error;
+
+	JsonDocument doc;
+	ESPinnerConfigPlan plan;
+	std::vector<ESPinnerHandle> created;
+	size_t cursor = 0;
+
+	uint16_t stepsDone = 0;
+	uint16_t stepsTotal = 0;
+
+	ConfigLoad_Manager() {}
+
+	/**
+	 * Release the job buffers. The plan points into doc, so it goes first.
+	 */
+	void releaseJob() {
+		plan = ESPinnerConfigPlan();
+		created.clear();
+		doc.clear();
+		pendingConfig = "";
+		cursor = 0;
+	}
+
+	void fail(const String &message) {
+		DUMPLN("Config load failed: ", message);
+		releaseJob();
+		error = message;
+		stage = ConfigLoadStage::Failed;
+	}
+
+	/**
+	 * Run a single unit of work of the current stage
+	 */
+	void step() {
+		ESPinner_Manager &manager = ESPinner_Manager::getInstance();
+
+		switch (stage) {
+		case ConfigLoadStage::Parse: {
+			DeserializationError parseError =
+				deserializeJson(doc, pendingConfig);
+			pendingConfig = "";
+			if (parseError) {
+				fail("Invalid JSON in 'config'");
+			} else if (!doc.is<JsonArray>()) {
+				fail("Invalid 'config' structure");
+			} else {
+				stage = ConfigLoadStage::Validate;
+			}
+			break;
+		}
+
+		case ConfigLoadStage::Validate: {
+			std::vector<String> assignErrors;
+			if (!resolveAutoPins(doc.as<JsonArray>(), assignErrors)) {
+				fail("Pin assignment failed: " + joinPinErrors(assignErrors));
+				break;
+			}
+			String validationError;
+			if (!validatePinsInConfig(doc.as<JsonArrayConst>(),
+									  validationError)) {
+				fail("Pin validation failed: " + validationError);
+				break;
+			}
+			plan = manager.planConfig(doc.as<JsonArrayConst>());
+			cursor = 0;
+			stepsTotal =
+				plan.toRemove.size() + 2 * plan.toCreate.size() + 1;
+			stage = ConfigLoadStage::Instantiate;
+			break;
+		}
+
+		case ConfigLoadStage::Instantiate:
+			if (cursor < plan.toRemove.size()) {
+				manager.teardownESPinner(plan.toRemove[cursor]);
+			} else if (cursor < plan.toRemove.size() + plan.toCreate.size()) {
+				created.push_back(manager.createESPinner(
+					plan.toCreate[cursor - plan.toRemove.size()]));
+			} else {
+				cursor = 0;
+				stage = ConfigLoadStage::BuildUI;
+				break;
+			}
+			cursor++;
+			stepsDone++;
+			break;
+
+		case ConfigLoadStage::BuildUI:
+			if (cursor < created.size()) {
+				manager.implementESPinner(created[cursor]);
+				cursor++;
+				stepsDone++;
+			} else {
+				stage = ConfigLoadStage::Persist;
+			}
+			break;
+
+		case ConfigLoadStage::Persist:
+			if (!plan.empty()) {
+				manager.saveESPinnersInStorage();
+			}
+			stepsDone++;
+			releaseJob();
+			stage = ConfigLoadStage::Done;
+			DUMPLN("Config load job done: ", jobId);
+			break;
+
+		default:
+			break;
+		}
+	}
+
+  public:
+	static ConfigLoad_Manager &getInstance() {
+		static ConfigLoad_Manager instance;
+		return instance;
+	}
+
+	/**
+	 * Queue a configuration array for loading
+	 * @param configJson Serialized ESPinner configuration array
+	 * @return Job id, or 0 if another job is still running
+	 */
+	uint32_t submit(const String &configJson) {
+		if (isBusy()) {
+			return 0;
+		}
+		pendingConfig = configJson;
+		error = "";
+		stepsDone = 0;
+		stepsTotal = 0;
+		jobId++;
+		stage = ConfigLoadStage::Parse;
+		DUMPLN("Config load job queued: ", jobId);
+		return jobId;
+	}
+
+	/**
+	 * Advance the current job until the loop budget is spent
+	 * Call once per loop() iteration.
+	 */
+	void update() {
+		if (!isBusy()) {
+			return;
+		}
+		unsigned long start = millis();
+		do {
+			step();
+		} while (isBusy() && millis() - start < CONFIG_LOAD_BUDGET_MS);
+	}
+
+	/**
+	 * Run the current job to the end without a time budget
+	 */
+	void finish() {
+		while (isBusy()) {
+			step();
+		}
+	}
+
+	bool isBusy() const {
+		return stage != ConfigLoadStage::Idle &&
+			   stage != ConfigLoadStage::Done &&
+			   stage != ConfigLoadStage::Failed;
+	}
+
+	ConfigLoadStage getStage() const { return stage; }
+	uint32_t getJobId() const { return jobId; }
+	const String &getError() const { return error; }
+
+	/**
+	 * Fill a status report for the status endpoint
+	 * @param status Document to fill
+	 */
+	void getStatus(JsonDocument &status) const {
+		ConfigLoadStage current = stage;
+		status["job"] = jobId;
+		status["stage"] = getConfigLoadStageName(current);
+		status["busy"] = isBusy();
+		status["done"] = stepsDone;
+		status["total"] = stepsTotal;
+		status["success"] = current != ConfigLoadStage::Failed;
+		if (current == ConfigLoadStage::Failed) {
+			status["error"] = error;
+		}
+	}
+};
+
+#endif
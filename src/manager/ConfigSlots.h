@@ -0,0 +1,226 @@
+#ifndef _ESPALLON_CONFIGSLOTS_H
+#define _ESPALLON_CONFIGSLOTS_H
+
+#include "Checksum.h"
+#include "Lzss.h"
+#include "StorageBackend.h"
+#include <Arduino.h>
+
+#define CONFIGSLOT_MAGIC "EAS1"
+#define CONFIGSLOT_MAGIC_LZSS "EAS2"
+#define CONFIGSLOT_COUNT 2
+
+// Store configurations LZSS compressed (base64, so text-only backends like
+// NVS strings can hold them). Set to 0 to write plain JSON records.
+#ifndef CONFIGSLOT_COMPRESS
+#define CONFIGSLOT_COMPRESS 1
+#endif
+
+// Largest configuration accepted when decompressing a slot
+#ifndef CONFIGSLOT_MAX_PAYLOAD
+#define CONFIGSLOT_MAX_PAYLOAD 16384
+#endif
+
+/**
+ * Header of a configuration slot record
+ */
+struct ConfigSlotHeader {
+	uint32_t seq = 0;	 // Commit sequence, higher is newer
+	uint32_t crc = 0;	 // CRC-32 of the payload
+	uint32_t length = 0; // Payload length in bytes
+	bool valid = false;	 // Header parsed and payload matches length and CRC
+};
+
+/**
+ * Crash-safe A/B storage for the ESPinner configuration
+ *
+ * Each slot keeps one record "EAS1;<seq>;<crc>;<length>;<payload>" under
+ * "<path>_a" or "<path>_b". "EAS2" records hold the payload LZSS compressed
+ * and base64 encoded; CRC and length always cover the stored text. A
+ * commit always writes the slot that is not active, with the next sequence
+ * number, so the last good configuration is never overwritten. The storage
+ * backend writes each key as a whole; a record torn by a power loss fails
+ * its length or CRC check and boot falls back to the other slot. Slots
+ * live in any IStorageBackend.
+ *
+ * Boot reads both slots and takes the newest valid one without parsing the
+ * JSON. The plain "<path>" key written by older firmware is read when no
+ * slot is valid, and is replaced by the first commit.
+ */
+class ConfigSlots {
+  private:
+	IStorageBackend &backend;
+	String path;
+
+	bool scanned = false;	// Slots have been read at least once
+	int8_t activeSlot = -1; // -1 while no valid slot is known
+	uint32_t activeSeq = 0;
+
+	String slotPath(uint8_t slot) const {
+		return path + (slot == 0 ? "_a" : "_b");
+	}
+
+	String readKey(const String &key) {
+		std::string value;
+		backend.read(key.c_str(), value);
+		return String(value.c_str());
+	}
+
+	/**
+	 * Parse and verify a slot record
+	 * @param record Raw slot content
+	 * @param payload Output payload when the record is valid
+	 */
+	static ConfigSlotHeader decode(const String &record, String &payload) {
+		ConfigSlotHeader header;
+		bool compressed = record.startsWith(CONFIGSLOT_MAGIC_LZSS ";");
+		if (!compressed && !record.startsWith(CONFIGSLOT_MAGIC ";")) {
+			return header;
+		}
+		int seqStart = strlen(CONFIGSLOT_MAGIC) + 1;
+		int crcStart = record.indexOf(';', seqStart) + 1;
+		int lengthStart = crcStart > 0 ? record.indexOf(';', crcStart) + 1 : 0;
+		int payloadStart =
+			lengthStart > 0 ? record.indexOf(';', lengthStart) + 1 : 0;
+		if (payloadStart <= 0) {
+			return header;
+		}
+
+		header.seq = strtoul(record.c_str() + seqStart, nullptr, 10);
+		header.crc = strtoul(record.c_str() + crcStart, nullptr, 16);
+		header.length = strtoul(record.c_str() + lengthStart, nullptr, 10);
+
+		const char *data = record.c_str() + payloadStart;
+		if (record.length() - payloadStart != header.length ||
+			crc32(reinterpret_cast<const uint8_t *>(data), header.length) !=
+				header.crc) {
+			return header;
+		}
+		if (!compressed) {
+			header.valid = true;
+			payload = data;
+			return header;
+		}
+
+		std::string packed;
+		std::string json;
+		if (!base64Decode(data, header.length, packed) ||
+			!lzssDecompress(reinterpret_cast<const uint8_t *>(packed.data()),
+							packed.size(), json, CONFIGSLOT_MAX_PAYLOAD)) {
+			return header;
+		}
+		header.valid = true;
+		payload = json.c_str();
+		return header;
+	}
+
+	/**
+	 * Build a slot record, compressed when that makes it shorter
+	 */
+	static String encode(uint32_t seq, const String &payload) {
+		const char *magic = CONFIGSLOT_MAGIC;
+		String data = payload;
+#if CONFIGSLOT_COMPRESS
+		std::string packed;
+		std::string text;
+		lzssCompress(reinterpret_cast<const uint8_t *>(payload.c_str()),
+					 payload.length(), packed);
+		base64Encode(reinterpret_cast<const uint8_t *>(packed.data()),
+					 packed.size(), text);
+		if (text.size() < payload.length()) {
+			magic = CONFIGSLOT_MAGIC_LZSS;
+			data = text.c_str();
+		}
+#endif
+		uint32_t crc = crc32(reinterpret_cast<const uint8_t *>(data.c_str()),
+							 data.length());
+		String record = magic;
+		record += ";" + String(seq) + ";" + String(crc, HEX) + ";" +
+				  String(data.length()) + ";";
+		record += data;
+		return record;
+	}
+
+  public:
+	ConfigSlots(IStorageBackend &storageBackend, const String &basePath)
+		: backend(storageBackend), path(basePath) {}
+
+	/**
+	 * Load the newest valid configuration
+	 * @return Payload of the newest valid slot, the legacy configuration or
+	 * an empty string if nothing valid is stored
+	 */
+	String load() {
+		String newest;
+		scanned = true;
+		activeSlot = -1;
+		activeSeq = 0;
+		for (uint8_t slot = 0; slot < CONFIGSLOT_COUNT; slot++) {
+			String payload;
+			ConfigSlotHeader header =
+				decode(readKey(slotPath(slot)), payload);
+			if (!header.valid) {
+				DUMPLN("Config slot invalid: ", slotPath(slot));
+				continue;
+			}
+			if (activeSlot < 0 || header.seq > activeSeq) {
+				activeSlot = slot;
+				activeSeq = header.seq;
+				newest = payload;
+			}
+		}
+		if (activeSlot >= 0) {
+			DUMP("Config slot loaded: ", slotPath(activeSlot));
+			DUMPLN(" seq ", activeSeq);
+			return newest;
+		}
+		return readKey(path);
+	}
+
+	/**
+	 * Write a configuration to the inactive slot
+	 * @param payload Serialized configuration
+	 * @return True if the record reads back valid
+	 */
+	bool commit(const String &payload) {
+		if (!scanned) {
+			load();
+		}
+		uint8_t target = activeSlot == 0 ? 1 : 0;
+		uint32_t seq = activeSeq + 1;
+		String record = encode(seq, payload);
+		backend.write(slotPath(target).c_str(), record.c_str(),
+					  record.length());
+
+		String stored;
+		if (!decode(readKey(slotPath(target)), stored).valid) {
+			DUMPLN("Config slot commit failed: ", slotPath(target));
+			return false;
+		}
+		if (activeSlot < 0) {
+			// First slot commit replaces the legacy configuration
+			backend.remove(path.c_str());
+		}
+		activeSlot = target;
+		activeSeq = seq;
+		return true;
+	}
+
+	/**
+	 * Remove both slots and the legacy configuration
+	 */
+	void clear() {
+		for (uint8_t slot = 0; slot < CONFIGSLOT_COUNT; slot++) {
+			backend.remove(slotPath(slot).c_str());
+		}
+		backend.remove(path.c_str());
+		scanned = true;
+		activeSlot = -1;
+		activeSeq = 0;
+	}
+
+	int8_t getActiveSlot() const { return activeSlot; }
+	uint32_t getSequence() const { return activeSeq; }
+};
+
+#endif
@@ -9,6 +9,7 @@
 #include "../utils.h"
 
 #include "../controllers/ESPAction.h"
+#include "../controllers/UI/ESPAllOnPerf.h"
 #include "../controllers/UI/ESPAllOnPinStatus.h"
 #include "../controllers/UI/ESPAllOnProjects.h"
 
@@ -274,6 +275,9 @@ class ESPAllOn {
 		// Register the projects endpoints
 		ESPAllOnProjects::registerProjectsEndpoints();
 
+		// Register the loop profiler endpoint
+		ESPAllOnPerf::registerPerfEndpoint();
+
 		pinStatusTab();
 	}
 
@@ -2,18 +2,45 @@
 #define _ESPINNER_MANAGER_H
 
 #include "../config.h"
+#include "ConfigSlots.h"
 #include "Storage_Manager.h"
 #include <Persistance.h>
-#include <list>
 
 #include "../controllers/ESPinner.h"
+#include "ESPinner_Registry.h"
+#include "ESPinner_Views.h"
+#include "TimerWheel.h"
 
 #include "../controllers/UI/TabController.h"
 #include "./upcast/upcast_utils.h"
+
+/**
+ * Changes needed to move the running ESPinners to a new configuration
+ * Config objects point into the JSON document the plan was built from.
+ */
+struct ESPinnerConfigPlan {
+	std::vector<String> toRemove;			 // IDs to tear down
+	std::vector<JsonObjectConst> toCreate; // Configs to instantiate
+
+	bool empty() const { return toRemove.empty() && toCreate.empty(); }
+};
+
 class ESPinner_Manager {
   private:
-	std::list<std::unique_ptr<ESPinner>> ESPinners;
-	Persistance ESPinnerManager;
+	ESPinner_Registry ESPinners;
+
+	// Typed views per ESPinner_Mod, kept in sync with the registry
+	ESPinnerView<ESPinner_GPIO> GPIOView;
+#if ESPALLON_MOD_DC
+	ESPinnerView<ESPinner_DC> DCView;
+#endif
+#if ESPALLON_MOD_STEPPER
+	ESPinnerView<ESPinner_Stepper> StepperView;
+#endif
+#if ESPALLON_MOD_NEOPIXEL
+	ESPinnerView<ESPinner_Neopixel> NeopixelView;
+#endif
+	ConfigSlots configSlots;
 	ESPAllOnPinManager *pinManager;
 
 	// Relation between controller in ESPinner
@@ -28,9 +55,120 @@ class ESPinner_Manager {
 	// This provides O(1) lookup for controller access
 	std::map<String, uint16_t> ESPinnerID_to_ControllerRef;
 
+	// Controller UI Reference -> ESPinner Handle
+	// Lets controller callbacks reach their ESPinner without reading the ID
+	std::map<uint16_t, ESPinnerHandle> ControllerRef_to_Handle;
+
+	/**
+	 * Insert or replace an ESPinner keeping the typed views in sync
+	 * @return Handle to the registered ESPinner
+	 */
+	ESPinnerHandle registerESPinner(std::unique_ptr<ESPinner> espinner) {
+		removeFromViews(espinner->ID);
+		ESPinnerHandle handle = ESPinners.insert(std::move(espinner));
+		addToViews(ESPinners.get(handle));
+		return handle;
+	}
+
+	void addToViews(ESPinner *espinner) {
+		switch (espinner->getType()) {
+		case ESPinner_Mod::GPIO:
+			GPIOView.add(static_cast<ESPinner_GPIO *>(espinner));
+			break;
+#if ESPALLON_MOD_DC
+		case ESPinner_Mod::DC:
+			DCView.add(static_cast<ESPinner_DC *>(espinner));
+			break;
+#endif
+#if ESPALLON_MOD_STEPPER
+		case ESPinner_Mod::Stepper:
+			StepperView.add(static_cast<ESPinner_Stepper *>(espinner));
+			break;
+#endif
+#if ESPALLON_MOD_NEOPIXEL
+		case ESPinner_Mod::NeoPixel:
+			NeopixelView.add(static_cast<ESPinner_Neopixel *>(espinner));
+			break;
+#endif
+		default:
+			break;
+		}
+	}
+
+	void removeFromViews(const String &id) {
+		ESPinner *espinner = ESPinners.findById(id);
+		if (espinner == nullptr) {
+			return;
+		}
+		switch (espinner->getType()) {
+		case ESPinner_Mod::GPIO:
+			GPIOView.remove(id);
+			break;
+#if ESPALLON_MOD_DC
+		case ESPinner_Mod::DC:
+			DCView.remove(id);
+			break;
+#endif
+#if ESPALLON_MOD_STEPPER
+		case ESPinner_Mod::Stepper:
+			StepperView.remove(id);
+			break;
+#endif
+#if ESPALLON_MOD_NEOPIXEL
+		case ESPinner_Mod::NeoPixel:
+			NeopixelView.remove(id);
+			break;
+#endif
+		default:
+			break;
+		}
+	}
+
+	/**
+	 * Order independent hash of a JSON config object
+	 * Key order differs between a received config and serializeJSON, so
+	 * each key/value pair is hashed on its own and the results are summed.
+	 */
+	static uint32_t configHash(JsonObjectConst config) {
+		uint32_t hash = 0;
+		for (JsonPairConst pair : config) {
+			const char *key = pair.key().c_str();
+			String value;
+			serializeJson(pair.value(), value);
+			uint32_t pairHash = fnv1aHash(key, strlen(key));
+			hash += fnv1aHash(value.c_str(), value.length(), pairHash);
+		}
+		return hash;
+	}
+
+	static uint32_t configHash(ESPinner *espinner) {
+		JsonDocument doc = espinner->serializeJSON();
+		return configHash(doc.as<JsonObjectConst>());
+	}
+
+	/**
+	 * Release the GPIOs listed in the module descriptor pin fields
+	 */
+	void detachESPinnerPins(ESPinner *espinner) {
+		const ESPinner_Descriptor *descriptor =
+			findDescriptorByMod(espinner->getType());
+		if (descriptor == nullptr) {
+			return;
+		}
+		JsonDocument doc = espinner->serializeJSON();
+		for (uint8_t i = 0; i < descriptor->numPinFields; i++) {
+			JsonVariantConst value = doc[descriptor->pinFields[i].key];
+			if (!value.is<uint8_t>()) {
+				continue;
+			}
+			uint16_t pin = value.as<uint8_t>();
+			pinManager->detach(pin);
+		}
+	}
+
   public:
-	ESPinner_Manager() : ESPinnerManager(nullptr, &storage) {
-		storage.setRoot(ESPinner_File);
+	ESPinner_Manager()
+		: configSlots(getStorageBackend(), ESPinner_Path) {
 		pinManager = &ESPAllOnPinManager::getInstance();
 	}
 	static ESPinner_Manager &getInstance() {
@@ -39,8 +177,19 @@ class ESPinner_Manager {
 	}
 	size_t espinnerSize() const { return ESPinners.size(); }
 	void clearESPinners() {
+		GPIOView.clear();
+#if ESPALLON_MOD_DC
+		DCView.clear();
+#endif
+#if ESPALLON_MOD_STEPPER
+		StepperView.clear();
+#endif
+#if ESPALLON_MOD_NEOPIXEL
+		NeopixelView.clear();
+#endif
 		ESPinners.clear();
 		clearESPinnerControllerMappings();
+		ControllerRef_to_Handle.clear();
 	}
 
 	std::map<uint16_t, uint16_t> &getControllerMap() {
@@ -50,7 +199,7 @@ class ESPinner_Manager {
 
 	void loadFromStorage() {
 		DynamicJsonDocument doc(256);
-		String serialized = ESPinnerManager.loadData(ESPinner_Path);
+		String serialized = configSlots.load();
 		DUMP("Dataloaded: ", serialized);
 		DeserializationError error = deserializeJson(doc, serialized);
 		if (!error) {
@@ -58,35 +207,14 @@ class ESPinner_Manager {
 				DUMPSLN("ERROR: NO JSON ARRAY FORMAT.");
 				return;
 			}
-			clearESPinners();
-			JsonArray array = doc.as<JsonArray>();
-			for (JsonDocument obj : array) {
-				String mod = obj[ESPINNER_MODEL_JSONCONFIG].as<const char *>();
-
-				DUMPLN("MOD: ", mod);
-				auto espinner = ESPinner::create(mod);
-				if (espinner) {
-					String output;
-					DUMPLN("ESPinner loaded: ", mod);
-					serializeJson(obj, output);
-					espinner->deserializeJSON(output);
-
-					uint16_t parentRef = getTab(TabType::BasicTab);
-
-					// Implement Includes GUI and ESPAllOn_PinManager
-					// Configuration
-					espinner->implement();
-
-					// Create ESPinner Model in List
-					ESPinners.push_back(std::move(espinner));
-					// ESPinner_Manager::getInstance().debug();
-				}
-			}
+			applyConfig(doc.as<JsonArrayConst>());
 		}
 	}
 
 	/**
 	 * Load ESPinners from JSON string
+	 * Only ESPinners that differ from the running ones are rebuilt, and the
+	 * configuration is saved only if something changed.
 	 * @param jsonString JSON string containing ESPinner configuration array
 	 * @return true if loaded successfully, false otherwise
 	 */
@@ -103,54 +231,161 @@ class ESPinner_Manager {
 			return false;
 		}
 
-		clearESPinners();
-		JsonArray array = doc.as<JsonArray>();
-		uint16_t idx = 0;
-		for (JsonDocument obj : array) {
-			String mod = obj[ESPINNER_MODEL_JSONCONFIG].as<const char *>();
-
-			DUMPLN("Loading ESPinner module from JSON: ", mod);
+		// Save the new configuration to storage
+		if (applyConfig(doc.as<JsonArrayConst>())) {
+			saveESPinnersInStorage();
+		}
 
-			auto espinner = ESPinner::create(mod);
-			if (espinner) {
-				String output;
-				serializeJson(obj, output);
-				espinner->deserializeJSON(output);
-				uint16_t parentRef = getTab(TabType::BasicTab);
+		return true;
+	}
 
-				// Implement Includes GUI and ESPAllOn_PinManager Configuration
-				espinner->implement();
+	// ------------------------------------- //
+	// ------------ CONFIG DIFF ------------ //
+	// ------------------------------------- //
 
-				// Create ESPinner Model in List
-				ESPinners.push_back(std::move(espinner));
+	/**
+	 * Compare a configuration array with the running ESPinners
+	 *
+	 * ESPinners are matched by ID. Missing ones are removed, new ones are
+	 * created and those whose content hash differs are removed and created
+	 * again. Unchanged ESPinners are not part of the plan.
+	 */
+	ESPinnerConfigPlan planConfig(JsonArrayConst config) {
+		ESPinnerConfigPlan plan;
+		std::unordered_map<String, uint32_t, StringHash> incoming;
+
+		for (JsonObjectConst item : config) {
+			const char *id = item[ESPINNER_ID_JSONCONFIG];
+			if (id == nullptr) {
+				DUMPSLN("ESPinner config without ID skipped");
+				continue;
+			}
+			uint32_t hash = configHash(item);
+			incoming[id] = hash;
+
+			ESPinner *current = ESPinners.findById(id);
+			if (current == nullptr) {
+				plan.toCreate.push_back(item);
+			} else if (configHash(current) != hash) {
+				plan.toRemove.push_back(id);
+				plan.toCreate.push_back(item);
+			}
+		}
 
-			} else {
-				DUMPLN("Failed to create ESPinner for module: ", mod);
+		ESPinners.forEach([&incoming, &plan](ESPinner *espinner) {
+			if (incoming.find(espinner->ID) == incoming.end()) {
+				plan.toRemove.push_back(espinner->ID);
 			}
-			idx++;
+		});
+
+		DUMP("Config diff remove: ", plan.toRemove.size());
+		DUMPLN(" create: ", plan.toCreate.size());
+		return plan;
+	}
+
+	/**
+	 * Stop an ESPinner and remove its UI, pins and registry entry
+	 * Runners drop the ESPinner when its driver is destroyed.
+	 */
+	void teardownESPinner(const String &id) {
+		ESPinner *espinner = ESPinners.findById(id);
+		if (espinner == nullptr) {
+			return;
 		}
+		DUMPLN("Teardown ESPinner: ", id);
+		detachESPinnerPins(espinner);
+		if (espinner->getPanelRef() != 0) {
+			removeESPinnerUI(espinner->getPanelRef());
+		}
+		removeESPinnerControllerMapping(id);
+		detach(id);
+	}
 
-		// Save the new configuration to storage
-		saveESPinnersInStorage();
+	/**
+	 * Create and register an ESPinner from its JSON config
+	 * The UI and pin manager setup is left to implementESPinner.
+	 * @return Handle to the ESPinner, invalid if the module is unknown or
+	 * its tickers found the timer pool exhausted
+	 */
+	ESPinnerHandle createESPinner(JsonObjectConst config) {
+		String mod = config[ESPINNER_MODEL_JSONCONFIG] | "";
+		uint32_t exhausted = getTimerWheel().getExhausted();
+		auto espinner = ESPinner::create(mod);
+		if (!espinner) {
+			DUMPLN("Failed to create ESPinner for module: ", mod);
+			return ESPinnerHandle();
+		}
+		if (getTimerWheel().getExhausted() != exhausted) {
+			// Its tickers would never fire, raise TIMER_WHEEL_MAX_TIMERS
+			DUMPLN("Timer pool exhausted, ESPinner not created: ", mod);
+			return ESPinnerHandle();
+		}
+		DUMPLN("ESPinner loaded: ", mod);
+		String output;
+		serializeJson(config, output);
+		espinner->deserializeJSON(output);
+
+		// Register first so controllers built in implement can bind to the
+		// ESPinner handle
+		return registerESPinner(std::move(espinner));
+	}
 
-		return true;
+	/**
+	 * Build the GUI and ESPAllOn_PinManager configuration of an ESPinner
+	 */
+	void implementESPinner(ESPinnerHandle handle) {
+		ESPinner *espinner = ESPinners.get(handle);
+		if (espinner != nullptr) {
+			espinner->implement();
+		}
+	}
+
+	/**
+	 * Apply a configuration array in one blocking pass
+	 * @return True if any ESPinner was added, removed or rebuilt
+	 */
+	bool applyConfig(JsonArrayConst config) {
+		ESPinnerConfigPlan plan = planConfig(config);
+		for (const String &id : plan.toRemove) {
+			teardownESPinner(id);
+		}
+		std::vector<ESPinnerHandle> created;
+		for (JsonObjectConst item : plan.toCreate) {
+			created.push_back(createESPinner(item));
+		}
+		for (ESPinnerHandle handle : created) {
+			implementESPinner(handle);
+		}
+		return !plan.empty();
 	}
 
 	void saveESPinnersInStorage() {
 		DynamicJsonDocument doc(1024);
 		JsonArray JSONESPinner_array = doc.to<JsonArray>();
-		for (const auto &espinner : ESPinners) {
+		ESPinners.forEach([&JSONESPinner_array](ESPinner *espinner) {
 			JsonDocument JSONEspinner = espinner->serializeJSON();
 			JSONESPinner_array.add(JSONEspinner);
-		}
+		});
 
 		String data;
 		serializeJson(doc, data);
-		ESPinnerManager.getStorageModel()->save(data, ESPinner_Path);
+		configSlots.commit(data);
 	}
 
-	void clearPinConfigInStorage() {
-		ESPinnerManager.getStorageModel()->remove(ESPinner_Path);
+	void clearPinConfigInStorage() { configSlots.clear(); }
+
+	/**
+	 * Read the stored configuration from the newest valid slot
+	 * @return Serialized ESPinner array or an empty string
+	 */
+	String loadConfigFromStorage() { return configSlots.load(); }
+
+	/**
+	 * Check if any configuration slot holds a valid configuration
+	 */
+	bool hasConfigInStorage() {
+		configSlots.load();
+		return configSlots.getActiveSlot() >= 0;
 	}
 
 	// ------------------------------------- //
@@ -247,49 +482,160 @@ class ESPinner_Manager {
 						"ESPinnerID_to_ControllerRef");
 	}
 
+	// ------------------------------------- //
+	// ------ CONTROLLER TO ESPINNER ------- //
+	// ------------------------------------- //
+
+	/**
+	 * Bind a controller panel to the handle of the ESPinner it drives
+	 * @param controllerRef UI reference of the controller panel
+	 * @param espinnerID String ID of the ESPinner
+	 */
+	void bindControllerHandle(uint16_t controllerRef,
+							  const String &espinnerID) {
+		ESPinnerHandle handle = ESPinners.find(espinnerID);
+		if (handle.isValid()) {
+			ControllerRef_to_Handle[controllerRef] = handle;
+		}
+	}
+
+	/**
+	 * Get the ESPinner driven by a controller panel
+	 * @param controllerRef UI reference of the controller panel
+	 * @return ESPinner pointer or nullptr if unbound or detached
+	 */
+	ESPinner *findESPinnerByControllerRef(uint16_t controllerRef) {
+		auto it = ControllerRef_to_Handle.find(controllerRef);
+		if (it == ControllerRef_to_Handle.end()) {
+			return nullptr;
+		}
+		return ESPinners.get(it->second);
+	}
+
+#if ESPALLON_MOD_STEPPER
+	ESPinner_Stepper *findStepperByControllerRef(uint16_t controllerRef) {
+		ESPinner *espinner = findESPinnerByControllerRef(controllerRef);
+		return espinner ? StepperView.find(espinner->ID) : nullptr;
+	}
+#endif
+
+#if ESPALLON_MOD_NEOPIXEL
+	ESPinner_Neopixel *findNeopixelByControllerRef(uint16_t controllerRef) {
+		ESPinner *espinner = findESPinnerByControllerRef(controllerRef);
+		return espinner ? NeopixelView.find(espinner->ID) : nullptr;
+	}
+#endif
+
+	void removeControllerHandle(uint16_t controllerRef) {
+		ControllerRef_to_Handle.erase(controllerRef);
+	}
+
 	// ------------------------------------- //
 	// ---------- ESPINNER METHODS --------- //
 	// ------------------------------------- //
 
 	ESPinner *findESPinnerById(const String &id) {
-		for (auto &espinner : ESPinners) {
-			if (espinner->ID == id) {
-				return espinner.get();
+		return ESPinners.findById(id);
+	}
+
+	/**
+	 * Get a stable handle for an ESPinner
+	 * Handles survive push replacement and go stale on detach.
+	 * @param id String ID of the ESPinner
+	 * @return Handle, invalid if the ID is not registered
+	 */
+	ESPinnerHandle findHandleById(const String &id) const {
+		return ESPinners.find(id);
+	}
+
+	/**
+	 * Resolve a handle obtained from findHandleById or push
+	 * @return ESPinner pointer or nullptr if the handle is stale
+	 */
+	ESPinner *getESPinner(ESPinnerHandle handle) const {
+		return ESPinners.get(handle);
+	}
+
+	ESPinnerHandle push(std::unique_ptr<ESPinner> GUIESPinner) {
+		ESPinnerHandle handle = registerESPinner(std::move(GUIESPinner));
+		saveESPinnersInStorage();
+		return handle;
+	}
+
+	// ------------------------------------- //
+	// ----------- TYPED VIEWS ------------- //
+	// ------------------------------------- //
+
+	const ESPinnerView<ESPinner_GPIO> &getGPIOs() const { return GPIOView; }
+#if ESPALLON_MOD_DC
+	const ESPinnerView<ESPinner_DC> &getDCs() const { return DCView; }
+#endif
+
+#if ESPALLON_MOD_STEPPER
+	const ESPinnerView<ESPinner_Stepper> &getSteppers() const {
+		return StepperView;
+	}
+
+	ESPinner_Stepper *findStepperById(const String &id) const {
+		return StepperView.find(id);
+	}
+#endif
+
+#if ESPALLON_MOD_NEOPIXEL
+	const ESPinnerView<ESPinner_Neopixel> &getNeopixels() const {
+		return NeopixelView;
+	}
+
+	ESPinner_Neopixel *findNeopixelById(const String &id) const {
+		return NeopixelView.find(id);
+	}
+#endif
+
+	/**
+	 * Decelerate every stepper to a stop
+	 */
+	void stopAllSteppers() {
+#if ESPALLON_MOD_STEPPER
+		for (ESPinner_Stepper *espinnerStepper : StepperView) {
+			AccelStepperAdapter *adapter =
+				espinnerStepper->getAccelStepperAdapter();
+			if (adapter) {
+				adapter->send(MotionCommand::stop());
 			}
 		}
-		return nullptr;
+#endif
 	}
 
-	void push(std::unique_ptr<ESPinner> GUIESPinner) {
-		auto it = std::find_if(
-			ESPinners.begin(), ESPinners.end(),
-			[&GUIESPinner](const std::unique_ptr<ESPinner> &espinner) {
-				return espinner->getID() == GUIESPinner->getID();
-			});
-
-		if (it != ESPinners.end()) {
-			*it = std::move(GUIESPinner);
-		} else {
-			ESPinners.push_back(std::move(GUIESPinner));
+	/**
+	 * Prints the command queue counters of every stepper
+	 */
+	void printStepperCommandStats(Print &out) {
+#if ESPALLON_MOD_STEPPER
+		for (ESPinner_Stepper *espinnerStepper : StepperView) {
+			AccelStepperAdapter *adapter =
+				espinnerStepper->getAccelStepperAdapter();
+			if (adapter) {
+				MotionCommandStats stats = adapter->getCommandStats();
+				out.printf("%-12s commands sent %u applied %u dropped %u "
+						   "flushed %u max depth %u\n",
+						   espinnerStepper->getID().c_str(),
+						   (unsigned)stats.sent, (unsigned)stats.applied,
+						   (unsigned)stats.dropped, (unsigned)stats.flushed,
+						   (unsigned)stats.maxDepth);
+			}
 		}
-		saveESPinnersInStorage();
+#endif
 	}
 
 	void debug() {
-		for (auto &espinner : ESPinners) {
+		ESPinners.forEach([](ESPinner *espinner) {
 			DUMPLN("ID FROM ESPINNER: ", espinner->getID());
-		}
+		});
 	}
 
 	void detach(const String &id) {
-		auto it =
-			std::find_if(ESPinners.begin(), ESPinners.end(),
-						 [&id](const std::unique_ptr<ESPinner> &espinner) {
-							 return espinner->getID() == id;
-						 });
-		if (it != ESPinners.end()) {
-			ESPinners.erase(it);
-		} else {
+		removeFromViews(id);
+		if (!ESPinners.erase(id)) {
 			DUMPSLN("ESPINNER NOT ERASED IN DETACH");
 		}
 	}
@@ -310,27 +656,42 @@ void ESPINNER_ID_Callback(Control *sender, int type) {
 	}
 }
 
+#if ESPALLON_MOD_STEPPER
 AccelStepperAdapter *findStepperAdapterById(const String &id) {
-	ESPinner *espinner = ESPinner_Manager::getInstance().findESPinnerById(id);
-	if (espinner && espinner->getType() == ESPinner_Mod::Stepper) {
-
-		ESPinner_Stepper *stepperESPinner =
-			static_cast<ESPinner_Stepper *>(espinner);
-		return static_cast<AccelStepperAdapter *>(
-			stepperESPinner->stepper.get());
+	ESPinner_Stepper *stepperESPinner =
+		ESPinner_Manager::getInstance().findStepperById(id);
+	if (stepperESPinner) {
+		return stepperESPinner->getAccelStepperAdapter();
 	}
 	return nullptr;
 }
+#endif
 
-#include "../mods/ESPinner_DC/ESPinner_DC_Controls.h"
 #include "../mods/ESPinner_GPIO/ESPinner_GPIO_Controls.h"
+#if ESPALLON_MOD_DC
+#include "../mods/ESPinner_DC/ESPinner_DC_Controls.h"
+#endif
+#if ESPALLON_MOD_STEPPER
 #include "../mods/ESPinner_Stepper/ESPinner_Stepper_Controls.h"
+#endif
 
+#if ESPALLON_MOD_ENCODER
 #include "../mods/ESPinner_Encoder/ESPinner_Encoder_Controls.h"
+#endif
+#if ESPALLON_MOD_LCD
 #include "../mods/ESPinner_LCD/ESPinner_LCD_Controls.h"
+#endif
+#if ESPALLON_MOD_MPU
 #include "../mods/ESPinner_MPU/ESPinner_MPU_Controls.h"
+#endif
+#if ESPALLON_MOD_NEOPIXEL
 #include "../mods/ESPinner_NeoPixel/ESPinner_NeoPixel_Controls.h"
+#endif
+#if ESPALLON_MOD_RFID
 #include "../mods/ESPinner_RFID/ESPinner_RFID_Controls.h"
+#endif
+#if ESPALLON_MOD_TFT
 #include "../mods/ESPinner_TFT/ESPinner_TFT_Controls.h"
+#endif
 
 #endif
\ No newline at end of file
@@ -0,0 +1,182 @@
+#ifndef _ESPINNER_REGISTRY_H
+#define _ESPINNER_REGISTRY_H
+
+#include "../config.h"
+#include "../controllers/ESPinner.h"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Stable reference to an ESPinner stored in the registry
+ *
+ * The index selects the slot and the generation detects handles whose
+ * ESPinner has been detached meanwhile. Replacing an ESPinner with the same
+ * ID (push) keeps the slot and generation, so handles stay valid.
+ */
+struct ESPinnerHandle {
+	static constexpr uint16_t INVALID_INDEX = 0xFFFF;
+
+	uint16_t index = INVALID_INDEX;
+	uint16_t generation = 0;
+
+	ESPinnerHandle() {}
+	ESPinnerHandle(uint16_t slotIndex, uint16_t slotGeneration)
+		: index(slotIndex), generation(slotGeneration) {}
+
+	bool isValid() const { return index != INVALID_INDEX; }
+
+	bool operator==(const ESPinnerHandle &other) const {
+		return index == other.index && generation == other.generation;
+	}
+	bool operator!=(const ESPinnerHandle &other) const {
+		return !(*this == other);
+	}
+};
+
+/**
+ * FNV-1a hash of a byte buffer
+ * @param data Buffer to hash
+ * @param length Number of bytes
+ * @param hash Seed, to chain several buffers
+ */
+uint32_t fnv1aHash(const char *data, size_t length,
+				   uint32_t hash = 2166136261u) {
+	for (size_t i = 0; i < length; i++) {
+		hash ^= static_cast<uint8_t>(data[i]);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * FNV-1a hash for Arduino String keys in unordered containers
+ */
+struct StringHash {
+	size_t operator()(const String &key) const {
+		return fnv1aHash(key.c_str(), key.length());
+	}
+};
+
+/**
+ * Contiguous ESPinner storage with an ID hash index
+ *
+ * ESPinners live in a slot vector; detached slots are recycled through a
+ * free list. Lookups by ID go through the hash index and lookups by handle
+ * are a direct slot access, both O(1).
+ */
+class ESPinner_Registry {
+  private:
+	struct Slot {
+		std::unique_ptr<ESPinner> espinner;
+		uint16_t generation = 0;
+	};
+
+	std::vector<Slot> slots;
+	std::vector<uint16_t> freeSlots;
+	std::unordered_map<String, uint16_t, StringHash> idIndex;
+
+  public:
+	ESPinner_Registry() { slots.reserve(MOD_CAPACITY); }
+
+	/**
+	 * Insert an ESPinner or replace the one registered with the same ID
+	 * @param espinner ESPinner to take ownership of
+	 * @return Handle to the slot holding the ESPinner
+	 */
+	ESPinnerHandle insert(std::unique_ptr<ESPinner> espinner) {
+		auto it = idIndex.find(espinner->ID);
+		if (it != idIndex.end()) {
+			Slot &slot = slots[it->second];
+			slot.espinner = std::move(espinner);
+			return ESPinnerHandle(it->second, slot.generation);
+		}
+
+		uint16_t index;
+		if (!freeSlots.empty()) {
+			index = freeSlots.back();
+			freeSlots.pop_back();
+		} else {
+			index = static_cast<uint16_t>(slots.size());
+			slots.push_back(Slot());
+		}
+		idIndex[espinner->ID] = index;
+		slots[index].espinner = std::move(espinner);
+		return ESPinnerHandle(index, slots[index].generation);
+	}
+
+	/**
+	 * Remove the ESPinner registered with the given ID
+	 * Outstanding handles to it become stale.
+	 * @return True if an ESPinner was removed
+	 */
+	bool erase(const String &id) {
+		auto it = idIndex.find(id);
+		if (it == idIndex.end()) {
+			return false;
+		}
+		uint16_t index = it->second;
+		idIndex.erase(it);
+		slots[index].espinner.reset();
+		slots[index].generation++;
+		freeSlots.push_back(index);
+		return true;
+	}
+
+	/**
+	 * Get a handle for the ESPinner with the given ID
+	 * @return Valid handle, or an invalid one if the ID is not registered
+	 */
+	ESPinnerHandle find(const String &id) const {
+		auto it = idIndex.find(id);
+		if (it == idIndex.end()) {
+			return ESPinnerHandle();
+		}
+		return ESPinnerHandle(it->second, slots[it->second].generation);
+	}
+
+	/**
+	 * Resolve a handle to its ESPinner
+	 * @return ESPinner pointer, or nullptr if the handle is stale or invalid
+	 */
+	ESPinner *get(ESPinnerHandle handle) const {
+		if (handle.index >= slots.size()) {
+			return nullptr;
+		}
+		const Slot &slot = slots[handle.index];
+		if (slot.generation != handle.generation) {
+			return nullptr;
+		}
+		return slot.espinner.get();
+	}
+
+	ESPinner *findById(const String &id) const { return get(find(id)); }
+
+	size_t size() const { return idIndex.size(); }
+
+	void clear() {
+		for (uint16_t i = 0; i < slots.size(); i++) {
+			if (slots[i].espinner) {
+				slots[i].espinner.reset();
+				slots[i].generation++;
+				freeSlots.push_back(i);
+			}
+		}
+		idIndex.clear();
+	}
+
+	/**
+	 * Visit every registered ESPinner in slot order
+	 * @param fn Callable receiving an ESPinner pointer
+	 */
+	template <typename Fn> void forEach(Fn fn) const {
+		for (const Slot &slot : slots) {
+			if (slot.espinner) {
+				fn(slot.espinner.get());
+			}
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef _ESPINNER_VIEWS_H
+#define _ESPINNER_VIEWS_H
+
+#include "ESPinner_Registry.h"
+
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Dense typed view over the ESPinners of a single ESPinner_Mod
+ *
+ * Holds non-owning pointers already cast to the concrete module class, so
+ * callers can iterate or look up one module type without type checks.
+ * Ownership stays in ESPinner_Registry; ESPinner_Manager keeps views in
+ * sync on push, detach and clear.
+ */
+template <typename T> class ESPinnerView {
+  private:
+	std::vector<T *> items;
+	std::unordered_map<String, uint16_t, StringHash> positions;
+
+  public:
+	typedef typename std::vector<T *>::const_iterator const_iterator;
+
+	void add(T *espinner) {
+		positions[espinner->ESPinner::ID] =
+			static_cast<uint16_t>(items.size());
+		items.push_back(espinner);
+	}
+
+	/**
+	 * Remove an ESPinner from the view (swap with last, then pop)
+	 * @return True if the ID was in the view
+	 */
+	bool remove(const String &id) {
+		auto it = positions.find(id);
+		if (it == positions.end()) {
+			return false;
+		}
+		uint16_t position = it->second;
+		positions.erase(it);
+		if (position != items.size() - 1) {
+			items[position] = items.back();
+			positions[items[position]->ESPinner::ID] = position;
+		}
+		items.pop_back();
+		return true;
+	}
+
+	/**
+	 * @return Typed ESPinner pointer or nullptr if not in the view
+	 */
+	T *find(const String &id) const {
+		auto it = positions.find(id);
+		if (it == positions.end()) {
+			return nullptr;
+		}
+		return items[it->second];
+	}
+
+	size_t size() const { return items.size(); }
+	bool empty() const { return items.empty(); }
+
+	void clear() {
+		items.clear();
+		positions.clear();
+	}
+
+	const_iterator begin() const { return items.begin(); }
+	const_iterator end() const { return items.end(); }
+};
+
+#endif
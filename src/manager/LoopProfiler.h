@@ -0,0 +1,302 @@
+#ifndef _ESPALLON_LOOPPROFILER_H
+#define _ESPALLON_LOOPPROFILER_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef ARDUINO
+#include <chrono>
+#endif
+
+// Scoped timing of the loop stages and runnables, see LOOP_PROFILE. Off on
+// ESP8266: the histograms of 32 stages take about 16 KB of RAM
+#ifndef LOOP_PROFILER_ENABLED
+#if defined(ESP8266)
+#define LOOP_PROFILER_ENABLED 0
+#else
+#define LOOP_PROFILER_ENABLED 1
+#endif
+#endif
+// Stages profiled at most: loop passes, scheduler tasks and runnables
+#ifndef LOOP_PROFILER_MAX_STAGES
+#if LOOP_PROFILER_ENABLED
+#define LOOP_PROFILER_MAX_STAGES 32
+#else
+#define LOOP_PROFILER_MAX_STAGES 1
+#endif
+#endif
+// Sub-buckets per power of two are 2^bits: 3 bits keep 12.5% precision
+#ifndef LOOP_PROFILER_SUB_BITS
+#define LOOP_PROFILER_SUB_BITS 3
+#endif
+
+/**
+ * Latency histogram with HDR-style log-linear buckets
+ *
+ * Each power of two is split into 2^LOOP_PROFILER_SUB_BITS linear buckets,
+ * so every recorded value keeps the same relative precision from a few
+ * ticks up to 2^32. Counts are 16 bit; when one would overflow all of them
+ * are halved, which keeps the shape of the distribution while older
+ * samples fade out. Recording is a count leading zeros and an increment.
+ */
+class LatencyHistogram {
+  public:
+	static constexpr uint8_t SUB_BITS = LOOP_PROFILER_SUB_BITS;
+	static constexpr uint32_t SUB_BUCKETS = 1u << SUB_BITS;
+	static constexpr size_t BUCKETS = (33 - SUB_BITS) * SUB_BUCKETS;
+
+  private:
+	uint16_t counts[BUCKETS] = {};
+	uint32_t samples = 0; // Recorded since reset, not halved
+	uint32_t maximum = 0;
+
+	static size_t bucketOf(uint32_t value) {
+		if (value < SUB_BUCKETS) {
+			return value;
+		}
+		uint8_t exponent = 31 - __builtin_clz(value);
+		uint8_t shift = exponent - SUB_BITS;
+		return (shift + 1) * SUB_BUCKETS +
+			   ((value >> shift) & (SUB_BUCKETS - 1));
+	}
+
+	/** Largest value falling in a bucket */
+	static uint32_t highestOf(size_t bucket) {
+		if (bucket < SUB_BUCKETS) {
+			return bucket;
+		}
+		uint8_t shift = bucket / SUB_BUCKETS - 1;
+		uint32_t sub = bucket % SUB_BUCKETS;
+		uint64_t lowest = static_cast<uint64_t>(SUB_BUCKETS + sub) << shift;
+		return static_cast<uint32_t>(lowest + (1ull << shift) - 1);
+	}
+
+  public:
+	void record(uint32_t value) {
+		uint16_t &count = counts[bucketOf(value)];
+		if (count == UINT16_MAX) {
+			for (uint16_t &each : counts) {
+				each >>= 1;
+			}
+		}
+		count++;
+		samples++;
+		if (value > maximum) {
+			maximum = value;
+		}
+	}
+
+	/**
+	 * @param percentile 0 to 100
+	 * @return Highest value of the bucket holding the percentile, at most
+	 * the recorded maximum; 0 if empty
+	 */
+	uint32_t percentile(float percentile) const {
+		uint32_t total = 0;
+		for (uint16_t count : counts) {
+			total += count;
+		}
+		if (total == 0) {
+			return 0;
+		}
+		uint32_t rank = static_cast<uint32_t>(percentile / 100.0f * total);
+		rank = rank < 1 ? 1 : (rank > total ? total : rank);
+		uint32_t seen = 0;
+		for (size_t bucket = 0; bucket < BUCKETS; bucket++) {
+			seen += counts[bucket];
+			if (seen >= rank) {
+				uint32_t highest = highestOf(bucket);
+				return highest < maximum ? highest : maximum;
+			}
+		}
+		return maximum;
+	}
+
+	uint32_t getSamples() const { return samples; }
+	uint32_t getMax() const { return maximum; }
+
+	void reset() {
+		memset(counts, 0, sizeof(counts));
+		samples = 0;
+		maximum = 0;
+	}
+};
+
+/**
+ * Time spent per stage of loop(), from a cycle counter
+ *
+ * Stages are named once and addressed by id; a Scope records the ticks
+ * from its construction to its destruction into the stage histogram.
+ * Ticks come from an injected source: the CPU cycle counter on target,
+ * steady_clock ns on the host, so an instrumented stage costs two counter
+ * reads and a histogram increment. Every stage must be recorded by a
+ * single task; readers may see a sample in progress. reset() may be called
+ * from any task: it flags the stages, and each histogram is cleared by the
+ * task recording it on its next sample; flagged stages read as empty.
+ */
+class LoopProfiler {
+  public:
+	typedef uint32_t (*TickSource)();
+	typedef int StageId; // -1 = not profiled
+
+	static constexpr size_t NAME_LENGTH = 16;
+
+	/**
+	 * Records a stage for the lifetime of the scope
+	 */
+	class Scope {
+		LoopProfiler *profiler;
+		StageId stage;
+		uint32_t start;
+
+	  public:
+		Scope(LoopProfiler *profiler, StageId stage)
+			: profiler(stage >= 0 ? profiler : nullptr), stage(stage),
+			  start(this->profiler ? this->profiler->ticks() : 0) {}
+		~Scope() {
+			if (profiler) {
+				profiler->record(stage, profiler->ticks() - start);
+			}
+		}
+	};
+
+  private:
+	struct Stage {
+		char name[NAME_LENGTH];
+		LatencyHistogram histogram;
+		std::atomic<bool> resetPending{false};
+	};
+
+	TickSource ticks;
+	uint32_t ticksPerUs;
+	Stage stages[LOOP_PROFILER_MAX_STAGES];
+	size_t count = 0;
+
+  public:
+	LoopProfiler(TickSource ticks, uint32_t ticksPerUs)
+		: ticks(ticks), ticksPerUs(ticksPerUs > 0 ? ticksPerUs : 1) {}
+
+	/**
+	 * Id of a stage, added on first use
+	 * @param name Copied, truncated to NAME_LENGTH - 1 characters
+	 * @return Stage id, -1 if LOOP_PROFILER_MAX_STAGES are in use
+	 */
+	StageId stage(const char *name) {
+		for (size_t i = 0; i < count; i++) {
+			if (strncmp(stages[i].name, name, NAME_LENGTH - 1) == 0) {
+				return i;
+			}
+		}
+		if (count >= LOOP_PROFILER_MAX_STAGES) {
+			return -1;
+		}
+		size_t length = strnlen(name, NAME_LENGTH - 1);
+		memcpy(stages[count].name, name, length);
+		stages[count].name[length] = '\0';
+		stages[count].histogram.reset();
+		stages[count].resetPending.store(false, std::memory_order_relaxed);
+		return count++;
+	}
+
+	void record(StageId stage, uint32_t elapsed) {
+		if (stage < 0 || stage >= (StageId)count) {
+			return;
+		}
+		Stage &entry = stages[stage];
+		if (entry.resetPending.load(std::memory_order_relaxed) &&
+			entry.resetPending.exchange(false, std::memory_order_acquire)) {
+			entry.histogram.reset();
+		}
+		entry.histogram.record(elapsed);
+	}
+
+	uint32_t now() const { return ticks(); }
+
+	size_t size() const { return count; }
+	const char *getName(StageId stage) const {
+		return stage >= 0 && stage < (StageId)count ? stages[stage].name : "";
+	}
+	const LatencyHistogram &getHistogram(StageId stage) const {
+		static const LatencyHistogram empty;
+		if (stage < 0 || stage >= (StageId)count ||
+			stages[stage].resetPending.load(std::memory_order_relaxed)) {
+			return empty;
+		}
+		return stages[stage].histogram;
+	}
+
+	/** Converts ticks to us, rounding up so short stages do not read 0 */
+	uint32_t toMicros(uint32_t elapsed) const {
+		return (elapsed + ticksPerUs - 1) / ticksPerUs;
+	}
+
+	/** Clears every histogram before its next sample */
+	void reset() {
+		for (size_t i = 0; i < count; i++) {
+			stages[i].resetPending.store(true, std::memory_order_release);
+		}
+	}
+};
+
+#ifdef ARDUINO
+/**
+ * Profiler of loop() and the runners, timed with the CPU cycle counter
+ */
+LoopProfiler &getLoopProfiler() {
+	static LoopProfiler profiler(
+		[]() -> uint32_t { return ESP.getCycleCount(); }, ESP.getCpuFreqMHz());
+	return profiler;
+}
+
+#define LOOP_PROFILE_JOIN(a, b) a##b
+#define LOOP_PROFILE_NAME(a, b) LOOP_PROFILE_JOIN(a, b)
+#if LOOP_PROFILER_ENABLED
+/**
+ * Times the rest of the enclosing block as the named stage of
+ * getLoopProfiler(); the stage is looked up once per call site
+ */
+#define LOOP_PROFILE(name)                                                     \
+	static const LoopProfiler::StageId LOOP_PROFILE_NAME(                      \
+		_profileStage, __LINE__) = getLoopProfiler().stage(name);             \
+	LoopProfiler::Scope LOOP_PROFILE_NAME(_profileScope, __LINE__)(            \
+		&getLoopProfiler(), LOOP_PROFILE_NAME(_profileStage, __LINE__))
+#else
+#define LOOP_PROFILE(name)
+#endif
+
+/**
+ * Prints p50, p99 and max of every stage, in us
+ */
+void printLoopProfile(Print &out) {
+	LoopProfiler &profiler = getLoopProfiler();
+	for (size_t i = 0; i < profiler.size(); i++) {
+		const LatencyHistogram &histogram = profiler.getHistogram(i);
+		out.printf("%-15s samples %u p50 %u us p99 %u us max %u us\n",
+				   profiler.getName(i), (unsigned)histogram.getSamples(),
+				   (unsigned)profiler.toMicros(histogram.percentile(50)),
+				   (unsigned)profiler.toMicros(histogram.percentile(99)),
+				   (unsigned)profiler.toMicros(histogram.getMax()));
+	}
+}
+#else
+/** Host tick source: steady_clock ns, 1000 ticks per us */
+inline uint32_t hostProfilerTicks() {
+	return static_cast<uint32_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch())
+			.count());
+}
+
+/**
+ * Profiler of the host simulation, timed with steady_clock: the virtual
+ * clock does not move while code runs
+ */
+LoopProfiler &getLoopProfiler() {
+	static LoopProfiler profiler(hostProfilerTicks, 1000);
+	return profiler;
+}
+#endif
+
+#endif
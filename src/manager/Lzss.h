@@ -0,0 +1,230 @@
+#ifndef _ESPALLON_LZSS_H
+#define _ESPALLON_LZSS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define LZSS_WINDOW 4096
+#define LZSS_MIN_MATCH 3
+#define LZSS_MAX_MATCH 18
+#define LZSS_HASH_BITS 10
+#define LZSS_MAX_CHAIN 32
+
+static uint16_t lzssHash(const uint8_t *data) {
+	uint32_t value = (data[0] << 16) | (data[1] << 8) | data[2];
+	return static_cast<uint16_t>((value * 2654435761u) >>
+								 (32 - LZSS_HASH_BITS));
+}
+
+/**
+ * LZSS codec for stored configurations
+ *
+ * Same family as heatshrink, without the dependency. Output is a sequence of
+ * groups: one flag byte, then up to eight items, where a set flag bit is a
+ * literal byte and a clear bit a two byte back reference
+ *   (distance - 1) << 4 | (length - 3)
+ * with a 4 KiB window and matches of 3 to 18 bytes. Serialized JSON
+ * configurations shrink to roughly a quarter, since keys repeat for every
+ * ESPinner.
+ *
+ * Decoding needs no memory beyond its output, so the decoder can run over
+ * a configuration as it is read back.
+ *
+ * Compression finds matches through hash chains over 3 byte prefixes; the
+ * chains hold distances in a ring the size of the window, so memory stays
+ * fixed (about 12 KiB) whatever the input length.
+ */
+void lzssCompress(const uint8_t *input, size_t length, std::string &output) {
+	output.clear();
+	output.reserve(length / 2 + 16);
+
+	std::vector<int32_t> head(1 << LZSS_HASH_BITS, -1);
+	std::vector<uint16_t> chain(LZSS_WINDOW, 0);
+
+	size_t flagPosition = 0;
+	uint8_t flagBit = 8;
+
+	size_t position = 0;
+	while (position < length) {
+		if (flagBit == 8) {
+			flagPosition = output.size();
+			output.push_back(0);
+			flagBit = 0;
+		}
+
+		size_t bestLength = 0;
+		size_t bestDistance = 0;
+		if (position + LZSS_MIN_MATCH <= length) {
+			uint16_t hash = lzssHash(input + position);
+			size_t maxLength = length - position;
+			if (maxLength > LZSS_MAX_MATCH) {
+				maxLength = LZSS_MAX_MATCH;
+			}
+			int32_t candidate = head[hash];
+			uint8_t steps = 0;
+			while (candidate >= 0 && position - candidate <= LZSS_WINDOW &&
+				   steps++ < LZSS_MAX_CHAIN) {
+				size_t matched = 0;
+				while (matched < maxLength &&
+					   input[candidate + matched] == input[position + matched]) {
+					matched++;
+				}
+				if (matched > bestLength) {
+					bestLength = matched;
+					bestDistance = position - candidate;
+					if (matched == maxLength) {
+						break;
+					}
+				}
+				uint16_t previous = chain[candidate % LZSS_WINDOW];
+				candidate = previous == 0 ? -1 : candidate - previous;
+			}
+		}
+
+		size_t advance = 1;
+		if (bestLength >= LZSS_MIN_MATCH) {
+			uint16_t word = static_cast<uint16_t>(
+				((bestDistance - 1) << 4) | (bestLength - LZSS_MIN_MATCH));
+			output.push_back(static_cast<char>(word >> 8));
+			output.push_back(static_cast<char>(word & 0xFF));
+			advance = bestLength;
+		} else {
+			output[flagPosition] |= static_cast<char>(1 << flagBit);
+			output.push_back(static_cast<char>(input[position]));
+		}
+		flagBit++;
+
+		// Index every position covered by this item
+		for (size_t i = 0; i < advance; i++, position++) {
+			if (position + LZSS_MIN_MATCH <= length) {
+				uint16_t hash = lzssHash(input + position);
+				int32_t previous = head[hash];
+				chain[position % LZSS_WINDOW] =
+					previous >= 0 && position - previous <= LZSS_WINDOW
+						? static_cast<uint16_t>(position - previous)
+						: 0;
+				head[hash] = static_cast<int32_t>(position);
+			}
+		}
+	}
+}
+
+/**
+ * Decompress a buffer
+ * @param maxLength Output limit, guards against corrupt input
+ * @return False on a reference before the start or past maxLength
+ */
+bool lzssDecompress(const uint8_t *input, size_t length, std::string &output,
+					size_t maxLength) {
+	output.clear();
+	size_t position = 0;
+	while (position < length) {
+		uint8_t flags = input[position++];
+		for (uint8_t bit = 0; bit < 8 && position < length; bit++) {
+			if (flags & (1 << bit)) {
+				if (output.size() >= maxLength) {
+					return false;
+				}
+				output.push_back(static_cast<char>(input[position++]));
+				continue;
+			}
+			if (position + 2 > length) {
+				return false;
+			}
+			uint16_t word = (input[position] << 8) | input[position + 1];
+			position += 2;
+			size_t distance = (word >> 4) + 1;
+			size_t matchLength = (word & 0x0F) + LZSS_MIN_MATCH;
+			if (distance > output.size() ||
+				output.size() + matchLength > maxLength) {
+				return false;
+			}
+			size_t start = output.size() - distance;
+			for (size_t i = 0; i < matchLength; i++) {
+				output.push_back(output[start + i]);
+			}
+		}
+	}
+	return true;
+}
+
+static const char base64Alphabet[] =
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/**
+ * Base64 encode binary data so it can be stored as a text value
+ */
+void base64Encode(const uint8_t *input, size_t length, std::string &output) {
+	output.clear();
+	output.reserve((length + 2) / 3 * 4);
+	for (size_t i = 0; i < length; i += 3) {
+		uint32_t block = input[i] << 16;
+		if (i + 1 < length) {
+			block |= input[i + 1] << 8;
+		}
+		if (i + 2 < length) {
+			block |= input[i + 2];
+		}
+		output.push_back(base64Alphabet[(block >> 18) & 0x3F]);
+		output.push_back(base64Alphabet[(block >> 12) & 0x3F]);
+		output.push_back(i + 1 < length ? base64Alphabet[(block >> 6) & 0x3F]
+										: '=');
+		output.push_back(i + 2 < length ? base64Alphabet[block & 0x3F] : '=');
+	}
+}
+
+static int8_t base64Value(char c) {
+	if (c >= 'A' && c <= 'Z') {
+		return c - 'A';
+	}
+	if (c >= 'a' && c <= 'z') {
+		return c - 'a' + 26;
+	}
+	if (c >= '0' && c <= '9') {
+		return c - '0' + 52;
+	}
+	if (c == '+') {
+		return 62;
+	}
+	if (c == '/') {
+		return 63;
+	}
+	return -1;
+}
+
+/**
+ * @return False on characters outside the alphabet or a truncated block
+ */
+bool base64Decode(const char *input, size_t length, std::string &output) {
+	output.clear();
+	if (length % 4 != 0) {
+		return false;
+	}
+	output.reserve(length / 4 * 3);
+	for (size_t i = 0; i < length; i += 4) {
+		uint32_t block = 0;
+		uint8_t padding = 0;
+		for (uint8_t j = 0; j < 4; j++) {
+			char c = input[i + j];
+			int8_t value = 0;
+			if (c == '=' && i + 4 == length && j >= 2) {
+				padding++;
+			} else if (padding > 0 || (value = base64Value(c)) < 0) {
+				return false;
+			}
+			block = (block << 6) | value;
+		}
+		output.push_back(static_cast<char>(block >> 16));
+		if (padding < 2) {
+			output.push_back(static_cast<char>((block >> 8) & 0xFF));
+		}
+		if (padding < 1) {
+			output.push_back(static_cast<char>(block & 0xFF));
+		}
+	}
+	return true;
+}
+
+#endif
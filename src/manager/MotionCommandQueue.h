@@ -0,0 +1,152 @@
+#ifndef _ESPALLON_MOTIONCOMMANDQUEUE_H
+#define _ESPALLON_MOTIONCOMMANDQUEUE_H
+
+#include "SpscQueue.h"
+
+#include <atomic>
+#include <stdint.h>
+
+/**
+ * Motion command kinds, one per AccelStepper call of the UI
+ */
+enum class MotionCommandType : uint8_t {
+	MoveTo,		 // Absolute target, steps
+	Move,		 // Relative target, steps
+	SetSpeed,	 // Constant speed, steps/s
+	SetMaxSpeed, // Speed of the moves, steps/s
+	Stop,		 // Decelerate to a stop
+	SetPosition, // Redefine the current position, steps
+	DisableOutputs,
+};
+
+struct MotionCommand {
+	MotionCommandType type;
+	int32_t steps;
+	float speed;
+
+	static MotionCommand moveTo(int32_t steps) {
+		return {MotionCommandType::MoveTo, steps, 0};
+	}
+	static MotionCommand move(int32_t steps) {
+		return {MotionCommandType::Move, steps, 0};
+	}
+	static MotionCommand setSpeed(float speed) {
+		return {MotionCommandType::SetSpeed, 0, speed};
+	}
+	static MotionCommand setMaxSpeed(float speed) {
+		return {MotionCommandType::SetMaxSpeed, 0, speed};
+	}
+	static MotionCommand stop() { return {MotionCommandType::Stop, 0, 0}; }
+	static MotionCommand setPosition(int32_t steps) {
+		return {MotionCommandType::SetPosition, steps, 0};
+	}
+	static MotionCommand disableOutputs() {
+		return {MotionCommandType::DisableOutputs, 0, 0};
+	}
+};
+
+/**
+ * Counters of a command queue
+ */
+struct MotionCommandStats {
+	uint32_t sent = 0;
+	uint32_t applied = 0;
+	uint32_t dropped = 0; // Refused, the queue was full
+	uint32_t flushed = 0; // Discarded by a Stop sent to a full queue
+	uint32_t maxDepth = 0;
+};
+
+/**
+ * Commands from UI callbacks to one stepper
+ *
+ * Senders never touch the AccelStepper; the runner drains the queue right
+ * before stepping it, so commands apply between two steps, in order. The
+ * ring is a lock-free SpscQueue: drain() never blocks. Senders in several
+ * tasks (websocket callbacks, serial commands, project loads) are
+ * serialized among themselves with a ProducerLock.
+ *
+ * Overflow policy: a command sent to a full queue is dropped and counted,
+ * except Stop. A Stop that does not fit is latched instead: the next
+ * drain() discards the queued commands, which it overrides anyway, and
+ * applies the Stop first. A stop request is never lost.
+ */
+template <size_t N> class MotionCommandQueue {
+  private:
+	SpscQueue<MotionCommand, N> queue;
+	ProducerLock senderLock;
+	std::atomic<bool> stopLatched{false};
+
+	// Sender side
+	std::atomic<uint32_t> sent{0};
+	std::atomic<uint32_t> dropped{0};
+	std::atomic<uint32_t> maxDepth{0};
+	// Drain side
+	std::atomic<uint32_t> applied{0};
+	std::atomic<uint32_t> flushed{0};
+
+  public:
+	/**
+	 * @return false if the command was dropped
+	 */
+	bool send(const MotionCommand &command) {
+		senderLock.lock();
+		bool queued = queue.push(command);
+		if (queued) {
+			uint32_t depth = queue.size();
+			if (depth > maxDepth.load(std::memory_order_relaxed)) {
+				maxDepth.store(depth, std::memory_order_relaxed);
+			}
+		} else if (command.type == MotionCommandType::Stop) {
+			stopLatched.store(true, std::memory_order_release);
+			queued = true;
+		}
+		senderLock.unlock();
+
+		if (queued) {
+			sent.fetch_add(1, std::memory_order_relaxed);
+		} else {
+			dropped.fetch_add(1, std::memory_order_relaxed);
+		}
+		return queued;
+	}
+
+	/**
+	 * Applies the pending commands, call from the task stepping the motor
+	 * @param apply Callable taking a const MotionCommand &
+	 * @return Commands applied
+	 */
+	template <typename Apply> size_t drain(Apply apply) {
+		size_t count = 0;
+		MotionCommand command;
+		if (stopLatched.exchange(false, std::memory_order_acquire)) {
+			for (size_t queued = queue.size(); queued > 0; queued--) {
+				queue.pop(command);
+				flushed.fetch_add(1, std::memory_order_relaxed);
+			}
+			apply(MotionCommand::stop());
+			count++;
+		}
+		while (queue.pop(command)) {
+			apply(command);
+			count++;
+		}
+		applied.fetch_add(count, std::memory_order_relaxed);
+		return count;
+	}
+
+	bool pending() const {
+		return !queue.empty() || stopLatched.load(std::memory_order_acquire);
+	}
+
+	MotionCommandStats getStats() const {
+		MotionCommandStats stats;
+		stats.sent = sent.load(std::memory_order_relaxed);
+		stats.applied = applied.load(std::memory_order_relaxed);
+		stats.dropped = dropped.load(std::memory_order_relaxed);
+		stats.flushed = flushed.load(std::memory_order_relaxed);
+		stats.maxDepth = maxDepth.load(std::memory_order_relaxed);
+		return stats;
+	}
+};
+
+#endif
@@ -0,0 +1,325 @@
+#ifndef _ESPALLON_MOTIONTASK_H
+#define _ESPALLON_MOTIONTASK_H
+
+#include "SpscQueue.h"
+
+#include <atomic>
+#include <stdint.h>
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#elif !defined(ARDUINO)
+#include <chrono>
+#include <thread>
+#endif
+
+// Run the steppers on their own task instead of loop(), ESP32 only
+#ifndef MOTION_TASK_ENABLED
+#define MOTION_TASK_ENABLED 0
+#endif
+// Core 0, next to WiFi and the TCP stack, so loop() keeps core 1
+#ifndef MOTION_TASK_CORE
+#define MOTION_TASK_CORE 0
+#endif
+// Above the idle task, below the WiFi and TCP/IP tasks
+#ifndef MOTION_TASK_PRIORITY
+#define MOTION_TASK_PRIORITY 3
+#endif
+#ifndef MOTION_TASK_STACK
+#define MOTION_TASK_STACK 4096
+#endif
+// Time the task steps before it sleeps one tick so its core idles
+#ifndef MOTION_TASK_SLICE_US
+#define MOTION_TASK_SLICE_US 4000
+#endif
+// Commands waiting for the motion task at most
+#ifndef MOTION_QUEUE_SIZE
+#define MOTION_QUEUE_SIZE 16
+#endif
+
+/**
+ * Motion task statistics, times in us
+ */
+struct MotionTaskStats {
+	uint32_t iterations = 0;
+	uint32_t commands = 0;
+	uint32_t yields = 0;		// Ticks left to other tasks
+	uint32_t maxStepGap = 0;	// Worst time between two steps while moving
+	uint32_t maxCommandWait = 0; // Worst time from post() to execution
+};
+
+/**
+ * Runs motion on a dedicated task
+ *
+ * On ESP32 the task is a FreeRTOS task pinned to MOTION_TASK_CORE, core 0
+ * by default, so websocket serialization, HTTP requests or NVS writes in
+ * loop() no longer stall step pulses. loop() keeps all of core 1. On core
+ * 0 the WiFi and TCP/IP tasks preempt the steppers for their bursts; the
+ * steppers take the rest of the core, up to MOTION_TASK_SLICE_US of every
+ * slice plus one tick (80 % with the defaults). Pinned to core 1 with a
+ * priority above loop() (1), they would leave loop() only that last 20 %
+ * and a 1 ms gap in every step stream per slice. On the host a std::thread
+ * stands in for it, for latency tests. Other Arduino targets have no task
+ * and start() fails; the caller keeps running motion from loop().
+ *
+ * The task calls the motion step back to back. While something moves, it
+ * sleeps one tick every MOTION_TASK_SLICE_US so lower priority tasks on its
+ * core run, the idle task that feeds the task watchdog included; with
+ * nothing moving it sleeps on every iteration.
+ *
+ * Other tasks never touch motion state directly: they post() commands
+ * through a lock-free queue, drained by the task before each step, or
+ * execute() them and wait until the task ran them. Producers are
+ * serialized with a ProducerLock; the motion task itself never waits.
+ */
+class MotionTask {
+  public:
+	typedef uint32_t (*Clock)();
+	/** Runs motion once, returns true while anything moves */
+	typedef bool (*MotionStep)();
+	typedef void (*CommandFunction)(void *context);
+
+  private:
+	struct Command {
+		CommandFunction function;
+		void *context;
+		uint32_t posted;
+	};
+
+	Clock clock;
+	MotionStep step;
+	uint32_t slice;
+	SpscQueue<Command, MOTION_QUEUE_SIZE> queue;
+	ProducerLock producerLock;
+	std::atomic<uint32_t> postedCount{0};
+	std::atomic<uint32_t> appliedCount{0};
+	std::atomic<bool> running{false};
+	std::atomic<bool> stopRequested{false};
+
+	// Written by the motion task only
+	std::atomic<uint32_t> iterations{0};
+	std::atomic<uint32_t> yields{0};
+	std::atomic<uint32_t> maxStepGap{0};
+	std::atomic<uint32_t> maxCommandWait{0};
+	uint32_t lastStep = 0;
+	bool wasMoving = false;
+
+#if defined(ESP32)
+	TaskHandle_t handle = nullptr;
+#elif !defined(ARDUINO)
+	std::thread thread;
+#endif
+
+	static void raise(std::atomic<uint32_t> &maximum, uint32_t value) {
+		if (value > maximum.load(std::memory_order_relaxed)) {
+			maximum.store(value, std::memory_order_relaxed);
+		}
+	}
+
+	void drain() {
+		Command command;
+		while (queue.pop(command)) {
+			raise(maxCommandWait, clock() - command.posted);
+			command.function(command.context);
+			appliedCount.fetch_add(1, std::memory_order_release);
+		}
+	}
+
+	/** Sleeps one tick, or longer on the host when idle */
+	void idle(bool moving) {
+		yields.fetch_add(1, std::memory_order_relaxed);
+#if defined(ESP32)
+		vTaskDelay(1);
+#elif !defined(ARDUINO)
+		if (moving) {
+			std::this_thread::yield();
+		} else {
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+		}
+#endif
+	}
+
+	void runTask() {
+		uint32_t sliceStart = clock();
+		while (!stopRequested.load(std::memory_order_acquire)) {
+			bool moving = iterate();
+			if (!moving || clock() - sliceStart >= slice) {
+				idle(moving);
+				sliceStart = clock();
+				wasMoving = false; // Planned gap
+			}
+		}
+		drain();
+		running.store(false, std::memory_order_release);
+	}
+
+#if defined(ESP32)
+	static void taskMain(void *self) {
+		static_cast<MotionTask *>(self)->runTask();
+		vTaskDelete(nullptr);
+	}
+#endif
+
+	/**
+	 * Lets the other tasks run while waiting. On ESP32 a tick sleep:
+	 * taskYIELD() never lets a lower priority motion task on the same core
+	 * run.
+	 */
+	static void relax() {
+#if defined(ESP32)
+		vTaskDelay(1);
+#elif !defined(ARDUINO)
+		std::this_thread::yield();
+#endif
+	}
+
+	template <typename F> static void invoke(void *context) {
+		(*static_cast<F *>(context))();
+	}
+
+  public:
+	MotionTask(Clock clock, MotionStep step,
+			   uint32_t slice = MOTION_TASK_SLICE_US)
+		: clock(clock), step(step), slice(slice) {}
+
+	~MotionTask() { stop(); }
+
+	/**
+	 * Starts the task
+	 * @return false if the platform has no motion task or it is running
+	 */
+	bool start() {
+		if (running.load(std::memory_order_acquire)) {
+			return false;
+		}
+		stopRequested.store(false, std::memory_order_release);
+		running.store(true, std::memory_order_release);
+#if defined(ESP32)
+		if (xTaskCreatePinnedToCore(taskMain, "motion", MOTION_TASK_STACK,
+									this, MOTION_TASK_PRIORITY, &handle,
+									MOTION_TASK_CORE) != pdPASS) {
+			running.store(false, std::memory_order_release);
+			return false;
+		}
+		return true;
+#elif !defined(ARDUINO)
+		thread = std::thread([this]() { this->runTask(); });
+		return true;
+#else
+		running.store(false, std::memory_order_release);
+		return false;
+#endif
+	}
+
+	/**
+	 * Stops the task after its current iteration, pending commands run
+	 */
+	void stop() {
+		if (!running.load(std::memory_order_acquire)) {
+			return;
+		}
+		stopRequested.store(true, std::memory_order_release);
+#if defined(ESP32)
+		while (running.load(std::memory_order_acquire)) {
+			vTaskDelay(1);
+		}
+		handle = nullptr;
+#elif !defined(ARDUINO)
+		thread.join();
+#endif
+	}
+
+	bool isRunning() const { return running.load(std::memory_order_acquire); }
+
+	/** True when called from the motion task */
+	bool inMotionTask() const {
+#if defined(ESP32)
+		return handle != nullptr && xTaskGetCurrentTaskHandle() == handle;
+#elif !defined(ARDUINO)
+		return std::this_thread::get_id() == thread.get_id();
+#else
+		return false;
+#endif
+	}
+
+	/**
+	 * One iteration: pending commands, then one motion step. Called by the
+	 * task; call it directly to run motion elsewhere while it is stopped.
+	 * @return true while anything moves
+	 */
+	bool iterate() {
+		drain();
+		uint32_t now = clock();
+		if (wasMoving) {
+			raise(maxStepGap, now - lastStep);
+		}
+		bool moving = step();
+		lastStep = now;
+		wasMoving = moving;
+		iterations.fetch_add(1, std::memory_order_relaxed);
+		return moving;
+	}
+
+	/**
+	 * Queues a command for the motion task, or runs it now if the task is
+	 * not running or the caller is the task
+	 * @param context Must stay valid until the command ran
+	 * @return Sequence number for waitFor(), 0 if the command already ran
+	 * and UINT32_MAX if the queue is full
+	 */
+	uint32_t post(CommandFunction function, void *context) {
+		if (!isRunning() || inMotionTask()) {
+			function(context);
+			return 0;
+		}
+		uint32_t posted = clock();
+		producerLock.lock();
+		uint32_t sequence = 0;
+		if (queue.push(Command{function, context, posted})) {
+			sequence = postedCount.fetch_add(1, std::memory_order_relaxed) + 1;
+		} else {
+			sequence = UINT32_MAX;
+		}
+		producerLock.unlock();
+		return sequence;
+	}
+
+	/**
+	 * Waits until the motion task ran the command of a sequence number
+	 */
+	void waitFor(uint32_t sequence) {
+		if (sequence == 0 || sequence == UINT32_MAX) {
+			return;
+		}
+		while (static_cast<int32_t>(
+				   appliedCount.load(std::memory_order_acquire) - sequence) < 0 &&
+			   isRunning()) {
+			relax();
+		}
+	}
+
+	/**
+	 * Runs a callable on the motion task and waits for it, retrying while
+	 * the queue is full. Runs it now if the task is not running.
+	 */
+	template <typename F> void execute(F function) {
+		uint32_t sequence;
+		while ((sequence = post(&invoke<F>, &function)) == UINT32_MAX) {
+			waitFor(postedCount.load(std::memory_order_relaxed));
+		}
+		waitFor(sequence);
+	}
+
+	MotionTaskStats getStats() const {
+		MotionTaskStats stats;
+		stats.iterations = iterations.load(std::memory_order_relaxed);
+		stats.commands = appliedCount.load(std::memory_order_relaxed);
+		stats.yields = yields.load(std::memory_order_relaxed);
+		stats.maxStepGap = maxStepGap.load(std::memory_order_relaxed);
+		stats.maxCommandWait = maxCommandWait.load(std::memory_order_relaxed);
+		return stats;
+	}
+};
+
+#endif
@@ -0,0 +1,212 @@
+#ifndef _ESPALLON_PINSOLVER_H
+#define _ESPALLON_PINSOLVER_H
+
+#include "../models/BoardCapabilities.h"
+
+#include <bitset>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/** Value of a pin field left to the solver */
+#define PIN_AUTO_VALUE "auto"
+
+/**
+ * Capability flags a pin field value asks for: "auto" adds nothing to the
+ * schema of the field, a capability name adds its flags. SPI_CS and OUTPUT
+ * need an output driver; the GPIO matrix routes chip selects to any of them.
+ * @param name Value of the pin field
+ * @param flags Receives the BOARD_CAP_* flags
+ * @return false if the value is not a pin requirement
+ */
+bool parsePinRequirement(const char *name, uint16_t &flags) {
+	static const struct {
+		const char *name;
+		uint16_t flags;
+	} requirements[] = {{PIN_AUTO_VALUE, 0},
+						{"INPUT", 0},
+						{"OUTPUT", BOARD_CAP_OUTPUT},
+						{"PWM", BOARD_CAP_PWM | BOARD_CAP_OUTPUT},
+						{"SPI_CS", BOARD_CAP_OUTPUT},
+						{"ADC", BOARD_CAP_ADC1},
+						{"TOUCH", BOARD_CAP_TOUCH},
+						{"DAC", BOARD_CAP_DAC},
+						{"RTC", BOARD_CAP_RTC}};
+	if (name == nullptr) {
+		return false;
+	}
+	for (size_t i = 0; i < sizeof(requirements) / sizeof(requirements[0]);
+		 i++) {
+		if (strcasecmp(name, requirements[i].name) == 0) {
+			flags = requirements[i].flags;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Assigns GPIOs to pin demands from the board capability table
+ *
+ * Every demand needs one GPIO holding its BOARD_CAP_* flags, and a GPIO
+ * serves one demand at most, so the assignment is a bipartite matching.
+ * solve() runs augmenting paths (Kuhn) and finds an assignment whenever one
+ * exists, in O(D * D * N) for D demands: below 100k steps on a 40 GPIO board.
+ *
+ * Candidates of a demand are ranked so scarce pins are kept for the demands
+ * that need them: pins wasting fewer unneeded capabilities first, strapping
+ * pins last, then by GPIO. Demands are matched most constrained first. Both
+ * orders only depend on the input, so equal inputs give equal assignments.
+ *
+ * GPIOs that do not exist, are wired to flash, USB or a peripheral of the
+ * board, or were excluded with block() are never assigned.
+ */
+template <size_t N> class PinSolver {
+	static_assert(N > 0 && N < 255, "pins are indexed as uint8_t");
+
+  public:
+	typedef uint16_t (*CapabilityLookup)(uint8_t gpio);
+
+	static constexpr uint16_t UNASSIGNABLE =
+		BOARD_CAP_FLASH | BOARD_CAP_USB | BOARD_CAP_ONBOARD;
+
+  private:
+	CapabilityLookup capabilities;
+	std::bitset<N> blocked;
+	uint16_t requiredCaps[N];
+	int16_t assignment[N]; // Demand -> GPIO, -1 unassigned
+	int16_t owner[N];	   // GPIO -> demand, -1 free
+	uint8_t candidates[N][N];
+	uint8_t numCandidates[N];
+	size_t demands = 0;
+	bool overflow = false;
+
+	/**
+	 * Value of the capabilities a demand would waste on a GPIO. Output
+	 * drivers weigh most, they are what most modules ask for.
+	 */
+	uint16_t cost(uint8_t gpio, uint16_t required) const {
+		uint16_t spare = capabilities(gpio) & ~required;
+		return (spare & BOARD_CAP_STRAPPING ? 16 : 0) +
+			   (spare & BOARD_CAP_OUTPUT ? 4 : 0) +
+			   (spare & BOARD_CAP_ADC1 ? 2 : 0) +
+			   (spare & BOARD_CAP_DAC ? 2 : 0) +
+			   (spare & BOARD_CAP_PWM ? 1 : 0) +
+			   (spare & BOARD_CAP_ADC2 ? 1 : 0) +
+			   (spare & BOARD_CAP_TOUCH ? 1 : 0) +
+			   (spare & BOARD_CAP_RTC ? 1 : 0);
+	}
+
+	void rankCandidates(size_t demand) {
+		uint8_t count = 0;
+		for (size_t gpio = 0; gpio < N; gpio++) {
+			uint16_t caps = capabilities(gpio);
+			if (blocked[gpio] || !(caps & BOARD_CAP_EXISTS) ||
+				(caps & UNASSIGNABLE) ||
+				(caps & requiredCaps[demand]) != requiredCaps[demand]) {
+				continue;
+			}
+			// Insertion sort by cost, stable on GPIO order
+			uint16_t required = requiredCaps[demand];
+			uint16_t gpioCost = cost(gpio, required);
+			uint8_t i = count++;
+			for (; i > 0 && cost(candidates[demand][i - 1], required) > gpioCost;
+				 i--) {
+				candidates[demand][i] = candidates[demand][i - 1];
+			}
+			candidates[demand][i] = gpio;
+		}
+		numCandidates[demand] = count;
+	}
+
+	bool augment(size_t demand, std::bitset<N> &visited) {
+		for (uint8_t i = 0; i < numCandidates[demand]; i++) {
+			uint8_t gpio = candidates[demand][i];
+			if (visited[gpio]) {
+				continue;
+			}
+			visited.set(gpio);
+			if (owner[gpio] < 0 || augment(owner[gpio], visited)) {
+				owner[gpio] = demand;
+				assignment[demand] = gpio;
+				return true;
+			}
+		}
+		return false;
+	}
+
+  public:
+	explicit PinSolver(CapabilityLookup capabilities = boardCapabilities)
+		: capabilities(capabilities) {}
+
+	/**
+	 * Excludes a GPIO, e.g. reserved, broken or already given in the config
+	 */
+	void block(int gpio) {
+		if (gpio >= 0 && gpio < (int)N) {
+			blocked.set(gpio);
+		}
+	}
+	bool isBlocked(int gpio) const {
+		return gpio >= 0 && gpio < (int)N && blocked[gpio];
+	}
+
+	/**
+	 * Adds a pin to assign
+	 * @param required BOARD_CAP_* flags the GPIO must have
+	 * @return Demand index, -1 if there are more demands than GPIOs
+	 */
+	int addDemand(uint16_t required) {
+		if (demands >= N) {
+			overflow = true;
+			return -1;
+		}
+		requiredCaps[demands] = required | BOARD_CAP_EXISTS;
+		assignment[demands] = -1;
+		return demands++;
+	}
+	size_t size() const { return demands; }
+
+	/**
+	 * Assigns every demand
+	 * @return true if all demands got a GPIO; otherwise as many as possible
+	 * are assigned and the rest read -1
+	 */
+	bool solve() {
+		uint8_t order[N];
+		for (size_t gpio = 0; gpio < N; gpio++) {
+			owner[gpio] = -1;
+		}
+		for (size_t demand = 0; demand < demands; demand++) {
+			assignment[demand] = -1;
+			rankCandidates(demand);
+			// Most constrained first, stable on demand order
+			size_t i = demand;
+			for (; i > 0 &&
+				   numCandidates[order[i - 1]] > numCandidates[demand];
+				 i--) {
+				order[i] = order[i - 1];
+			}
+			order[i] = demand;
+		}
+
+		bool complete = !overflow;
+		for (size_t i = 0; i < demands; i++) {
+			std::bitset<N> visited;
+			if (!augment(order[i], visited)) {
+				complete = false;
+			}
+		}
+		return complete;
+	}
+
+	/**
+	 * GPIO assigned to a demand by the last solve()
+	 * @return GPIO number, -1 if unassigned
+	 */
+	int getAssignment(int demand) const {
+		return demand >= 0 && demand < (int)demands ? assignment[demand] : -1;
+	}
+};
+
+#endif
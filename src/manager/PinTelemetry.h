@@ -0,0 +1,136 @@
+#ifndef _ESPALLON_PINTELEMETRY_H
+#define _ESPALLON_PINTELEMETRY_H
+
+#include <bitset>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Time between two samples of the watched pins
+#ifndef PIN_TELEMETRY_INTERVAL_MS
+#define PIN_TELEMETRY_INTERVAL_MS 50
+#endif
+
+/**
+ * Reads the current digital level of a pin, 0 or 1
+ */
+typedef int32_t (*PinLevelReader)(uint8_t pin);
+
+/**
+ * Samples pin levels at a fixed rate and reports what changed
+ *
+ * Watched pins are read every interval through the reader and reported
+ * when their level flips. format() writes the changes of the last sample as a compact
+ * JSON diff
+ *   {"t":<ms>,"p":[[gpio,value],...]}
+ * where a null value means the pin is no longer watched. invalidate() makes
+ * the next sample report every watched pin, e.g. for a new listener.
+ */
+template <size_t N> class PinTelemetry {
+  private:
+	PinLevelReader reader;
+	uint32_t interval;
+	uint32_t lastSample = 0;
+	bool sampled = false;
+
+	std::bitset<N> watched;
+	std::bitset<N> known;	// values[pin] holds a reported value
+	std::bitset<N> changed; // Changes of the last sample
+	std::bitset<N> dropped; // Unwatched since the last sample
+	int32_t values[N] = {};
+
+	static bool inRange(int pin) { return pin >= 0 && pin < (int)N; }
+
+  public:
+	PinTelemetry(PinLevelReader reader,
+				 uint32_t interval = PIN_TELEMETRY_INTERVAL_MS)
+		: reader(reader), interval(interval) {}
+
+	void setInterval(uint32_t ms) { interval = ms; }
+	uint32_t getInterval() const { return interval; }
+
+	/**
+	 * Starts or stops sampling a pin
+	 */
+	void watch(int pin, bool watch) {
+		if (!inRange(pin) || watched[pin] == watch) {
+			return;
+		}
+		watched.set(pin, watch);
+		known.reset(pin);
+		dropped.set(pin, !watch);
+	}
+	bool isWatched(int pin) const { return inRange(pin) && watched[pin]; }
+
+	/**
+	 * Samples the watched pins once the interval elapsed
+	 * @param now Current time in ms
+	 * @return Number of pins to report, 0 when nothing changed or the
+	 * interval did not elapse
+	 */
+	size_t update(uint32_t now) {
+		if (sampled && now - lastSample < interval) {
+			return 0;
+		}
+		sampled = true;
+		lastSample = now;
+
+		changed = dropped;
+		dropped.reset();
+		for (size_t pin = 0; pin < N; pin++) {
+			if (!watched[pin]) {
+				continue;
+			}
+			int32_t value = reader(pin);
+			if (!known[pin] || value != values[pin]) {
+				values[pin] = value;
+				known.set(pin);
+				changed.set(pin);
+			}
+		}
+		return changed.count();
+	}
+
+	/**
+	 * Makes the next sample report every watched pin again
+	 */
+	void invalidate() { known.reset(); }
+
+	int32_t getValue(int pin) const {
+		return inRange(pin) && known[pin] ? values[pin] : -1;
+	}
+
+	/**
+	 * Writes the JSON diff of the last sample
+	 * @param now Timestamp written in the diff
+	 * @return Length written, 0 if the buffer is too small
+	 */
+	size_t format(char *out, size_t capacity, uint32_t now) const {
+		int length = snprintf(out, capacity, "{\"t\":%lu,\"p\":[",
+							  static_cast<unsigned long>(now));
+		bool first = true;
+		for (size_t pin = 0; pin < N; pin++) {
+			if (!changed[pin] || length < 0 || (size_t)length >= capacity) {
+				continue;
+			}
+			if (known[pin] && watched[pin]) {
+				length += snprintf(out + length, capacity - length,
+								   "%s[%u,%ld]", first ? "" : ",",
+								   static_cast<unsigned>(pin),
+								   static_cast<long>(values[pin]));
+			} else {
+				length += snprintf(out + length, capacity - length,
+								   "%s[%u,null]", first ? "" : ",",
+								   static_cast<unsigned>(pin));
+			}
+			first = false;
+		}
+		if (length < 0 || (size_t)length >= capacity) {
+			return 0;
+		}
+		length += snprintf(out + length, capacity - length, "]}");
+		return (size_t)length < capacity ? length : 0;
+	}
+};
+
+#endif
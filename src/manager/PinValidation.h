@@ -0,0 +1,242 @@
+#ifndef _ESPALLON_PIN_VALIDATION_H
+#define _ESPALLON_PIN_VALIDATION_H
+
+#include "../config.h"
+#include "../controllers/ESPAllOnPinManager.h"
+#include "PinSolver.h"
+#include "upcast/ESPinner_Descriptors.h"
+
+#include <bitset>
+#include <memory>
+#include <vector>
+
+/**
+ * Describes a capability required by a pin schema that the GPIO lacks
+ * @param missing Required BOARD_CAP_* flags the GPIO does not have
+ * @param available Capabilities of the GPIO
+ */
+const char *describeMissingCapability(uint16_t missing, uint16_t available) {
+	if ((missing & BOARD_CAP_OUTPUT) && (available & BOARD_CAP_INPUT_ONLY)) {
+		return "is input only";
+	}
+	if (missing & BOARD_CAP_OUTPUT) {
+		return "can not drive an output";
+	}
+	if (missing & BOARD_CAP_PWM) {
+		return "has no PWM";
+	}
+	if (missing & (BOARD_CAP_ADC1 | BOARD_CAP_ADC2)) {
+		return "has no ADC";
+	}
+	if (missing & BOARD_CAP_TOUCH) {
+		return "is not a touch pin";
+	}
+	return "lacks a required capability";
+}
+
+/**
+ * Validates the pins of every ESPinner in a project configuration
+ *
+ * Runs in one pass driven by the pin schema of each module
+ * (ESPinner_Descriptor::pinFields): every pin is checked against the board
+ * capabilities it needs and claimed in a scratch bitset, so two modules of
+ * the project using the same GPIO are caught as well. All problems are
+ * collected, up to PIN_VALIDATION_MAX_ERRORS, instead of stopping at the
+ * first one. Modules not built in are skipped.
+ * @param configArray ESPinner configurations
+ * @param errors Receives one message per invalid pin
+ * @return true if all pins are valid
+ */
+bool validateProjectPins(JsonArrayConst configArray,
+						 std::vector<String> &errors) {
+	ESPAllOnPinManager &pinManager = ESPAllOnPinManager::getInstance();
+	std::bitset<ESP_BoardConf::NUM_PINS> claimed;
+	const char *owners[ESP_BoardConf::NUM_PINS];
+	bool valid = true;
+
+	for (JsonVariantConst config : configArray) {
+		const ESPinner_Descriptor *descriptor = findDescriptorByTag(
+			config[ESPINNER_MODEL_JSONCONFIG].as<const char *>());
+		if (descriptor == nullptr) {
+			continue;
+		}
+		const char *id = config[ESPINNER_ID_JSONCONFIG] | "";
+
+		for (uint8_t i = 0; i < descriptor->numPinFields; i++) {
+			const PinFieldSchema &field = descriptor->pinFields[i];
+			JsonVariantConst value = config[field.key];
+			if (value.isNull()) {
+				continue;
+			}
+
+			int pin = value.as<int>();
+			const char *reason = nullptr;
+			const char *owner = nullptr;
+			if (!value.is<int>()) {
+				reason = "is not a GPIO number";
+			} else if (pin == 0) {
+				reason = "has invalid value 0";
+			} else if (pin < 0 || pin >= (int)ESP_BoardConf::NUM_PINS) {
+				reason = "is out of range for this board";
+			} else if (!boardPinUsable(pin)) {
+				reason = "does not exist on this board or is wired to flash";
+			} else if (pinManager.pinCurrentStatus.isBlocked(pin)) {
+				reason = "is reserved or marked as broken";
+			} else if (!pinManager.isPinOK(pin)) {
+				reason = "is not valid for this board";
+			} else if (requiredPinCaps(field, config) &
+					   ~boardCapabilities(pin)) {
+				reason = describeMissingCapability(
+					requiredPinCaps(field, config) & ~boardCapabilities(pin),
+					boardCapabilities(pin));
+			} else if (claimed[pin]) {
+				reason = "is already used by";
+				owner = owners[pin];
+			} else {
+				claimed.set(pin);
+				owners[pin] = id;
+				continue;
+			}
+
+			valid = false;
+			if (errors.size() < PIN_VALIDATION_MAX_ERRORS) {
+				String message = String("ESPinner '") + id + "': pin " +
+								 String(pin) + " (" + field.key + ") " +
+								 reason;
+				if (owner != nullptr) {
+					message += String(" '") + owner + "'";
+				}
+				DUMPLN("Validation error: ", message);
+				errors.push_back(message);
+			}
+		}
+	}
+
+	if (valid) {
+		DUMPSLN("All pins validated successfully");
+	}
+	return valid;
+}
+
+/**
+ * Assigns the pin fields of a project left to the solver
+ *
+ * A pin field holding "auto" or a capability name (see parsePinRequirement)
+ * gets a free GPIO with the capabilities of its schema plus the named ones.
+ * GPIOs given as numbers anywhere in the project, reserved or broken GPIOs
+ * and GPIO 0 are never assigned. Assigned fields are written back as
+ * numbers, so the project then validates and stores like one written by
+ * hand. Fields that could not be assigned keep their value.
+ * @param configArray ESPinner configurations, modified in place
+ * @param errors Receives one message per field without a GPIO
+ * @return true if every field got a GPIO
+ */
+bool resolveAutoPins(JsonArray configArray, std::vector<String> &errors) {
+	struct AutoPin {
+		JsonObject config;
+		const char *key;
+	};
+	typedef PinSolver<ESP_BoardConf::NUM_PINS> ProjectPinSolver;
+
+	ESPAllOnPinManager &pinManager = ESPAllOnPinManager::getInstance();
+	// Candidate lists take N * N bytes, too much for the loop task stack
+	std::unique_ptr<ProjectPinSolver> solver(new ProjectPinSolver());
+	std::vector<AutoPin> autoPins;
+	bool valid = true;
+
+	solver->block(0);
+	for (uint8_t gpio = 0; gpio < ESP_BoardConf::NUM_PINS; gpio++) {
+		if (pinManager.pinCurrentStatus.isBlocked(gpio) ||
+			!pinManager.isPinOK(gpio)) {
+			solver->block(gpio);
+		}
+	}
+
+	for (JsonObject config : configArray) {
+		const ESPinner_Descriptor *descriptor = findDescriptorByTag(
+			config[ESPINNER_MODEL_JSONCONFIG].as<const char *>());
+		if (descriptor == nullptr) {
+			continue;
+		}
+		const char *id = config[ESPINNER_ID_JSONCONFIG] | "";
+
+		for (uint8_t i = 0; i < descriptor->numPinFields; i++) {
+			const PinFieldSchema &field = descriptor->pinFields[i];
+			JsonVariant value = config[field.key];
+			if (value.is<int>()) {
+				solver->block(value.as<int>());
+				continue;
+			}
+			// Anything else is reported by validateProjectPins()
+			uint16_t flags;
+			if (!value.is<const char *>() ||
+				!parsePinRequirement(value.as<const char *>(), flags)) {
+				continue;
+			}
+			if (solver->addDemand(requiredPinCaps(field, config) | flags) < 0) {
+				valid = false;
+				if (errors.size() < PIN_VALIDATION_MAX_ERRORS) {
+					errors.push_back(String("ESPinner '") + id + "': pin " +
+									 field.key + " exceeds the board GPIOs");
+				}
+				continue;
+			}
+			autoPins.push_back({config, field.key});
+		}
+	}
+
+	if (autoPins.empty()) {
+		return valid;
+	}
+	solver->solve();
+	for (size_t i = 0; i < autoPins.size(); i++) {
+		JsonObject config = autoPins[i].config;
+		int gpio = solver->getAssignment(i);
+		if (gpio >= 0) {
+			DUMP("Auto pin ", autoPins[i].key);
+			DUMPLN(" assigned to GPIO ", gpio);
+			config[autoPins[i].key] = gpio;
+			continue;
+		}
+		valid = false;
+		if (errors.size() < PIN_VALIDATION_MAX_ERRORS) {
+			errors.push_back(String("ESPinner '") +
+							 (config[ESPINNER_ID_JSONCONFIG] | "") + "': pin " +
+							 autoPins[i].key + " (" +
+							 config[autoPins[i].key].as<const char *>() +
+							 ") has no free GPIO left");
+		}
+	}
+	return valid;
+}
+
+/**
+ * Joins pin errors for a single status message
+ */
+String joinPinErrors(const std::vector<String> &errors) {
+	String joined;
+	for (const String &error : errors) {
+		if (joined.length() > 0) {
+			joined += "; ";
+		}
+		joined += error;
+	}
+	return joined;
+}
+
+/**
+ * Validates all pins in a configuration array
+ * @param configArray JsonArray containing ESPinner configurations
+ * @param errorMsg Output parameter, every error joined with "; "
+ * @return true if all pins are valid, false otherwise
+ */
+bool validatePinsInConfig(JsonArrayConst configArray, String &errorMsg) {
+	std::vector<String> errors;
+	if (validateProjectPins(configArray, errors)) {
+		return true;
+	}
+	errorMsg = joinPinErrors(errors);
+	return false;
+}
+
+#endif
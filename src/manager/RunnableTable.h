@@ -0,0 +1,149 @@
+#ifndef _ESPALLON_RUNNABLETABLE_H
+#define _ESPALLON_RUNNABLETABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Fixed capacity table of the runnables of a runner
+ *
+ * Holds non-owning pointers with the active ones compacted at the front, so
+ * runAll() is one virtual run() call per active runnable: no allocation, no
+ * inactive entries and no isActive() call on the loop path. Owners report
+ * activity changes with setActive(), which swaps the entry across the
+ * active boundary.
+ *
+ * Entries are addressed by a handle that stays valid while entries move;
+ * a removed handle may be given to a later add().
+ */
+template <typename T, size_t N> class RunnableTable {
+	static_assert(N > 0 && N < 128, "positions are stored as int8_t");
+
+  public:
+	typedef int Handle; // -1 = invalid
+
+  private:
+	T *items[N];
+	int8_t handleAt[N];	  // Position -> handle
+	int8_t positionOf[N]; // Handle -> position, -1 free
+	size_t count = 0;
+	size_t active = 0; // Entries [0, active) run
+
+	void swap(size_t a, size_t b) {
+		if (a == b) {
+			return;
+		}
+		T *item = items[a];
+		items[a] = items[b];
+		items[b] = item;
+		int8_t handle = handleAt[a];
+		handleAt[a] = handleAt[b];
+		handleAt[b] = handle;
+		positionOf[handleAt[a]] = a;
+		positionOf[handleAt[b]] = b;
+	}
+
+  public:
+	RunnableTable() {
+		for (size_t i = 0; i < N; i++) {
+			positionOf[i] = -1;
+		}
+	}
+
+	/**
+	 * @param isActive Initial activity, later changes go to setActive()
+	 * @return Handle, -1 if the table is full or item is null
+	 */
+	Handle add(T *item, bool isActive) {
+		if (item == nullptr || count >= N) {
+			return -1;
+		}
+		Handle handle = 0;
+		while (positionOf[handle] >= 0) {
+			handle++;
+		}
+		items[count] = item;
+		handleAt[count] = handle;
+		positionOf[handle] = count;
+		count++;
+		if (isActive) {
+			swap(count - 1, active);
+			active++;
+		}
+		return handle;
+	}
+
+	/**
+	 * @return True if the handle was in the table
+	 */
+	bool remove(Handle handle) {
+		if (!isValid(handle)) {
+			return false;
+		}
+		setActive(handle, false);
+		swap(positionOf[handle], count - 1);
+		positionOf[handle] = -1;
+		count--;
+		return true;
+	}
+
+	void setActive(Handle handle, bool on) {
+		if (!isValid(handle)) {
+			return;
+		}
+		size_t position = positionOf[handle];
+		if (on && position >= active) {
+			swap(position, active);
+			active++;
+		} else if (!on && position < active) {
+			active--;
+			swap(position, active);
+		}
+	}
+
+	/**
+	 * Runs the active entries, last first: an entry deactivating itself
+	 * only moves entries that already ran. Entries activated by a run()
+	 * start on the next call.
+	 */
+	void runAll() {
+		for (size_t i = active; i-- > 0;) {
+			if (i < active) {
+				items[i]->run();
+			}
+		}
+	}
+
+	/**
+	 * runAll() through a wrapper, e.g. to time each entry
+	 * @param run Callable taking the Handle and T *, which runs the entry
+	 */
+	template <typename Run> void runAll(Run run) {
+		for (size_t i = active; i-- > 0;) {
+			if (i < active) {
+				run((Handle)handleAt[i], items[i]);
+			}
+		}
+	}
+
+	bool isValid(Handle handle) const {
+		return handle >= 0 && handle < (Handle)N && positionOf[handle] >= 0;
+	}
+	bool isActive(Handle handle) const {
+		return isValid(handle) && (size_t)positionOf[handle] < active;
+	}
+	T *get(Handle handle) const {
+		return isValid(handle) ? items[positionOf[handle]] : nullptr;
+	}
+	size_t size() const { return count; }
+	size_t activeCount() const { return active; }
+
+	void clear() {
+		for (size_t i = 0; i < N; i++) {
+			positionOf[i] = -1;
+		}
+		count = active = 0;
+	}
+};
+
+#endif
@@ -0,0 +1,415 @@
+#ifndef _ESPALLON_SCHEDULER_H
+#define _ESPALLON_SCHEDULER_H
+
+#include "Clock.h"
+#include "LoopProfiler.h"
+
+#include <functional>
+#include <stdint.h>
+#include <vector>
+
+// Registered loop tasks at most
+#ifndef SCHEDULER_MAX_TASKS
+#define SCHEDULER_MAX_TASKS 16
+#endif
+
+// Time a pass may spend on animation and background tasks before the ones
+// that are not late yet move to the next pass
+#ifndef SCHEDULER_PASS_BUDGET_US
+#define SCHEDULER_PASS_BUDGET_US 5000
+#endif
+
+/**
+ * Task classes, by priority
+ */
+enum class TaskClass : uint8_t {
+	Motion,		// Step pulses: before every other task, never deferred
+	Animation,	// Soft real time, e.g. LED animations
+	Background, // UI, network and storage
+};
+
+const char *getTaskClassName(TaskClass taskClass) {
+	switch (taskClass) {
+	case TaskClass::Motion:
+		return "motion";
+	case TaskClass::Animation:
+		return "animation";
+	case TaskClass::Background:
+		return "background";
+	}
+	return "unknown";
+}
+
+/**
+ * Run statistics of a task, times in us
+ */
+struct TaskStats {
+	uint32_t runs = 0;
+	uint32_t overruns = 0; // Runs longer than the task budget
+	uint32_t missed = 0;   // Runs started after their deadline
+	uint32_t deferred = 0; // Passes skipped for lack of budget
+	uint32_t lastRun = 0;
+	uint32_t maxRun = 0;
+	uint32_t maxLateness = 0; // Worst start delay after the task was due
+};
+
+/**
+ * Statistics of the scheduler passes, times in us
+ */
+struct SchedulerStats {
+	uint32_t passes = 0;
+	uint32_t overBudget = 0; // Passes longer than the pass budget
+	uint32_t maxPass = 0;
+	uint32_t maxMotionGap = 0; // Worst time between two motion runs
+};
+
+/**
+ * Cooperative scheduler of the main loop
+ *
+ * Every task has a class, a period (0 runs it on every pass) and a time
+ * budget. A pass of run():
+ * - runs the Motion tasks first and again before every other task, so a
+ *   slow task delays step pulses by its own duration only;
+ * - runs the due Animation and Background tasks earliest deadline first,
+ *   Animation first on equal deadlines. A task's deadline is one period
+ *   after it was due, or the pass start for tasks run on every pass;
+ * - defers a task to the next pass when its budget no longer fits in
+ *   SCHEDULER_PASS_BUDGET_US, unless its deadline already passed or, for
+ *   tasks run on every pass, it was deferred last pass. Deferred tasks can
+ *   not starve.
+ *
+ * Tasks that take longer than their budget count as overruns, and tasks
+ * started after their deadline count as missed. Time comes from an
+ * injected microsecond clock, so the scheduler runs on the host as well.
+ */
+class Scheduler {
+  public:
+	typedef uint32_t (*Clock)();
+	typedef std::function<void()> TaskFunction;
+	typedef int TaskHandle; // -1 = invalid
+
+  private:
+	struct Task {
+		const char *name;
+		TaskClass taskClass;
+		TaskFunction function;
+		uint32_t period;
+		uint32_t budget; // 0 = no budget
+		uint32_t due;
+		uint32_t pass; // Last pass the task ran or was deferred in
+		bool enabled;
+		bool skipped; // Deferred by the last pass
+		LoopProfiler::StageId stage;
+		TaskStats stats;
+	};
+
+	Clock clock;
+	uint32_t passBudget;
+	std::vector<Task> tasks;
+	SchedulerStats stats;
+	LoopProfiler *profiler = nullptr;
+	LoopProfiler::StageId passStage = -1;
+	uint32_t lastMotion = 0;
+	bool motionRan = false;
+
+	static bool reached(uint32_t now, uint32_t time) {
+		return static_cast<int32_t>(now - time) >= 0;
+	}
+
+	uint32_t deadline(const Task &task, uint32_t passStart) const {
+		return task.period == 0 ? passStart : task.due + task.period;
+	}
+
+	void execute(Task &task, uint32_t passStart) {
+		uint32_t start = clock();
+		uint32_t taskDeadline = deadline(task, passStart);
+		{
+			LoopProfiler::Scope scope(profiler, task.stage);
+			task.function();
+		}
+		uint32_t end = clock();
+
+		TaskStats &taskStats = task.stats;
+		uint32_t duration = end - start;
+		taskStats.runs++;
+		taskStats.lastRun = duration;
+		if (duration > taskStats.maxRun) {
+			taskStats.maxRun = duration;
+		}
+		if (task.budget > 0 && duration > task.budget) {
+			taskStats.overruns++;
+		}
+		if (task.period > 0) {
+			uint32_t lateness = reached(start, task.due) ? start - task.due : 0;
+			if (lateness > taskStats.maxLateness) {
+				taskStats.maxLateness = lateness;
+			}
+			if (!reached(taskDeadline, start)) {
+				taskStats.missed++;
+			}
+			// Keep the period grid, resynchronize after a missed period
+			task.due += task.period;
+			if (reached(start, task.due)) {
+				task.due = start + task.period;
+			}
+		}
+	}
+
+	void runMotion() {
+		uint32_t now = clock();
+		if (motionRan && now - lastMotion > stats.maxMotionGap) {
+			stats.maxMotionGap = now - lastMotion;
+		}
+		for (Task &task : tasks) {
+			if (task.enabled && task.taskClass == TaskClass::Motion) {
+				execute(task, now);
+			}
+		}
+		lastMotion = clock();
+		motionRan = true;
+	}
+
+	bool hasMotion() const {
+		for (const Task &task : tasks) {
+			if (task.enabled && task.taskClass == TaskClass::Motion) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * Next task of the pass: due, not yet run, earliest deadline
+	 * @return Task index, -1 when the pass is done
+	 */
+	int pickNext(uint32_t passStart, uint32_t now) const {
+		int best = -1;
+		int32_t bestSlack = 0;
+		for (size_t i = 0; i < tasks.size(); i++) {
+			const Task &task = tasks[i];
+			if (!task.enabled || task.taskClass == TaskClass::Motion ||
+				task.pass == stats.passes ||
+				(task.period > 0 && !reached(now, task.due))) {
+				continue;
+			}
+			int32_t slack =
+				static_cast<int32_t>(deadline(task, passStart) - passStart);
+			if (best < 0 || slack < bestSlack ||
+				(slack == bestSlack &&
+				 task.taskClass < tasks[best].taskClass)) {
+				best = i;
+				bestSlack = slack;
+			}
+		}
+		return best;
+	}
+
+  public:
+	explicit Scheduler(Clock clock,
+					   uint32_t passBudget = SCHEDULER_PASS_BUDGET_US)
+		: clock(clock), passBudget(passBudget) {
+		tasks.reserve(SCHEDULER_MAX_TASKS);
+	}
+
+	/**
+	 * Registers a task
+	 * @param name Static name shown in the statistics
+	 * @param period Time between two runs in us, 0 to run on every pass
+	 * @param budget Expected longest run in us, 0 for none
+	 * @return Task handle, -1 if SCHEDULER_MAX_TASKS are registered
+	 */
+	TaskHandle addTask(const char *name, TaskClass taskClass,
+					   TaskFunction function, uint32_t period = 0,
+					   uint32_t budget = 0) {
+		Task task;
+		task.name = name;
+		task.taskClass = taskClass;
+		task.function = function;
+		task.period = period;
+		task.budget = budget;
+		task.due = clock();
+		task.pass = 0;
+		task.enabled = true;
+		task.skipped = false;
+		task.stage = profiler ? profiler->stage(name) : -1;
+
+		for (size_t i = 0; i < tasks.size(); i++) {
+			if (!tasks[i].function) {
+				tasks[i] = task;
+				return i;
+			}
+		}
+		if (tasks.size() >= SCHEDULER_MAX_TASKS) {
+			return -1;
+		}
+		tasks.push_back(task);
+		return tasks.size() - 1;
+	}
+
+	/**
+	 * Unregisters a task, its handle may be reused
+	 */
+	void removeTask(TaskHandle handle) {
+		if (isValid(handle)) {
+			tasks[handle] = Task();
+			tasks[handle].function = nullptr;
+			tasks[handle].enabled = false;
+		}
+	}
+
+	/**
+	 * Records every pass and every task run in the profiler, as a "loop"
+	 * stage and a stage named after the task
+	 * @param profiler Not owned, nullptr to stop profiling
+	 */
+	void setProfiler(LoopProfiler *profiler) {
+		this->profiler = profiler;
+		passStage = profiler ? profiler->stage("loop") : -1;
+		for (Task &task : tasks) {
+			task.stage =
+				profiler && task.function ? profiler->stage(task.name) : -1;
+		}
+	}
+
+	void setEnabled(TaskHandle handle, bool enabled) {
+		if (isValid(handle)) {
+			tasks[handle].enabled = enabled;
+			tasks[handle].due = clock();
+		}
+	}
+
+	bool isValid(TaskHandle handle) const {
+		return handle >= 0 && handle < (int)tasks.size() &&
+			   tasks[handle].function;
+	}
+
+	/**
+	 * Runs one pass, call on every loop() iteration
+	 */
+	void run() {
+		LoopProfiler::Scope scope(profiler, passStage);
+		stats.passes++;
+		uint32_t passStart = clock();
+		bool motion = hasMotion();
+		if (motion) {
+			runMotion();
+		}
+
+		for (;;) {
+			uint32_t now = clock();
+			int next = pickNext(passStart, now);
+			if (next < 0) {
+				break;
+			}
+			Task &task = tasks[next];
+			task.pass = stats.passes;
+			// Tasks of every pass are late once they were deferred
+			bool late = task.period > 0
+							? reached(now, deadline(task, passStart))
+							: task.skipped;
+			if (!late && now - passStart + task.budget > passBudget) {
+				task.skipped = true;
+				task.stats.deferred++;
+				continue;
+			}
+			task.skipped = false;
+			execute(task, passStart);
+			if (motion) {
+				runMotion();
+			}
+		}
+
+		uint32_t duration = clock() - passStart;
+		if (duration > stats.maxPass) {
+			stats.maxPass = duration;
+		}
+		if (duration > passBudget) {
+			stats.overBudget++;
+		}
+	}
+
+	/**
+	 * Time until the next periodic task is due
+	 * @return us, 0 if a task is due or runs on every pass
+	 */
+	uint32_t timeUntilNextTask() const {
+		uint32_t now = clock();
+		uint32_t wait = UINT32_MAX;
+		for (const Task &task : tasks) {
+			if (!task.enabled) {
+				continue;
+			}
+			if (task.period == 0 || reached(now, task.due)) {
+				return 0;
+			}
+			if (task.due - now < wait) {
+				wait = task.due - now;
+			}
+		}
+		return wait;
+	}
+
+	void resetStats() {
+		stats = SchedulerStats();
+		motionRan = false;
+		for (Task &task : tasks) {
+			task.stats = TaskStats();
+			task.pass = 0;
+		}
+	}
+
+	size_t size() const { return tasks.size(); }
+	const char *getName(TaskHandle handle) const {
+		return isValid(handle) ? tasks[handle].name : "";
+	}
+	TaskClass getClass(TaskHandle handle) const {
+		return isValid(handle) ? tasks[handle].taskClass
+							   : TaskClass::Background;
+	}
+	uint32_t getBudget(TaskHandle handle) const {
+		return isValid(handle) ? tasks[handle].budget : 0;
+	}
+	const TaskStats &getTaskStats(TaskHandle handle) const {
+		static const TaskStats none;
+		return isValid(handle) ? tasks[handle].stats : none;
+	}
+	const SchedulerStats &getStats() const { return stats; }
+};
+
+/**
+ * Scheduler of loop(), timed with clockMicros()
+ */
+Scheduler &getScheduler() {
+	static Scheduler scheduler(clockMicros);
+	return scheduler;
+}
+
+#ifdef ARDUINO
+
+/**
+ * Prints the scheduler statistics, one line per task
+ */
+void printSchedulerStats(Print &out) {
+	Scheduler &scheduler = getScheduler();
+	const SchedulerStats &stats = scheduler.getStats();
+	out.printf("passes %u, over budget %u, max pass %u us, max motion gap "
+			   "%u us\n",
+			   (unsigned)stats.passes, (unsigned)stats.overBudget,
+			   (unsigned)stats.maxPass, (unsigned)stats.maxMotionGap);
+	for (size_t i = 0; i < scheduler.size(); i++) {
+		if (!scheduler.isValid(i)) {
+			continue;
+		}
+		const TaskStats &task = scheduler.getTaskStats(i);
+		out.printf("%-12s %-10s runs %u max %u us overruns %u missed %u "
+				   "deferred %u late %u us\n",
+				   scheduler.getName(i),
+				   getTaskClassName(scheduler.getClass(i)), (unsigned)task.runs,
+				   (unsigned)task.maxRun, (unsigned)task.overruns,
+				   (unsigned)task.missed, (unsigned)task.deferred,
+				   (unsigned)task.maxLateness);
+	}
+}
+#endif
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef _ESPALLON_SPSCQUEUE_H
+#define _ESPALLON_SPSCQUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#elif !defined(ARDUINO)
+#include <mutex>
+#endif
+
+/**
+ * Serializes the producers of an SpscQueue
+ *
+ * On ESP32 a portMUX critical section: holders only push, a few stores, and
+ * the holder can not be preempted on its core while it holds it, so a
+ * waiter never spins on a holder that does not run, whatever the
+ * priorities of the two tasks. The host uses a std::mutex; other Arduino
+ * targets have a single task and need no lock.
+ */
+class ProducerLock {
+  private:
+#if defined(ESP32)
+	portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+#elif !defined(ARDUINO)
+	std::mutex mutex;
+#endif
+
+  public:
+	void lock() {
+#if defined(ESP32)
+		taskENTER_CRITICAL(&mux);
+#elif !defined(ARDUINO)
+		mutex.lock();
+#endif
+	}
+	void unlock() {
+#if defined(ESP32)
+		taskEXIT_CRITICAL(&mux);
+#elif !defined(ARDUINO)
+		mutex.unlock();
+#endif
+	}
+};
+
+/**
+ * Bounded lock-free single producer, single consumer queue
+ *
+ * A ring of N entries with one free slot: push() only writes the tail and
+ * pop() only writes the head, each published with release ordering. One
+ * task may push while another pops, without locks and without allocation.
+ * Any more producers or consumers need their own serialization.
+ */
+template <typename T, size_t N> class SpscQueue {
+	static_assert(N >= 2, "one slot stays free");
+
+  private:
+	T items[N] = {};
+	std::atomic<size_t> head{0}; // Next to pop, written by the consumer
+	std::atomic<size_t> tail{0}; // Next to push, written by the producer
+
+	static size_t following(size_t index) {
+		return index + 1 == N ? 0 : index + 1;
+	}
+
+  public:
+	/**
+	 * Producer side
+	 * @return false if the queue is full
+	 */
+	bool push(const T &item) {
+		size_t current = tail.load(std::memory_order_relaxed);
+		size_t next = following(current);
+		if (next == head.load(std::memory_order_acquire)) {
+			return false;
+		}
+		items[current] = item;
+		tail.store(next, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Consumer side
+	 * @return false if the queue is empty
+	 */
+	bool pop(T &item) {
+		size_t current = head.load(std::memory_order_relaxed);
+		if (current == tail.load(std::memory_order_acquire)) {
+			return false;
+		}
+		item = items[current];
+		head.store(following(current), std::memory_order_release);
+		return true;
+	}
+
+	bool empty() const {
+		return head.load(std::memory_order_acquire) ==
+			   tail.load(std::memory_order_acquire);
+	}
+
+	size_t size() const {
+		size_t first = head.load(std::memory_order_acquire);
+		size_t last = tail.load(std::memory_order_acquire);
+		return last >= first ? last - first : N - first + last;
+	}
+
+	static constexpr size_t capacity() { return N - 1; }
+};
+
+#endif
@@ -0,0 +1,417 @@
+#ifndef _ESPALLON_STATEJOURNAL_H
+#define _ESPALLON_STATEJOURNAL_H
+
+#include "Checksum.h"
+
+#include <map>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#ifdef ARDUINO
+#include <LittleFS.h>
+#endif
+
+#ifndef STATE_JOURNAL_PATH
+#define STATE_JOURNAL_PATH "/state.journal"
+#endif
+
+// Compact once the log grows past this size and twice the live state
+#ifndef STATE_JOURNAL_COMPACT_BYTES
+#define STATE_JOURNAL_COMPACT_BYTES 4096
+#endif
+
+#define STATE_JOURNAL_RECORD 0xA5
+#define STATE_JOURNAL_TOMBSTONE 0x5A
+#define STATE_JOURNAL_HEADER_SIZE 3
+#define STATE_JOURNAL_CRC_SIZE 4
+#define STATE_JOURNAL_MAX_KEY 32
+#define STATE_JOURNAL_MAX_VALUE 64
+
+/**
+ * File holding the journal log
+ *
+ * append() adds bytes at the end, rewrite() replaces the whole content at
+ * once (write to a temporary file, then rename) and is only used by
+ * compaction.
+ */
+class IJournalFile {
+  public:
+	virtual ~IJournalFile() = default;
+	virtual bool readAll(std::vector<uint8_t> &content) = 0;
+	virtual bool append(const uint8_t *data, size_t length) = 0;
+	virtual bool rewrite(const uint8_t *data, size_t length) = 0;
+	virtual void remove() = 0;
+};
+
+#ifndef ARDUINO
+/**
+ * Journal file on the host filesystem, used by native tests and benchmarks
+ */
+class HostJournalFile : public IJournalFile {
+  private:
+	std::string path;
+	FILE *handle = nullptr;
+
+	void close() {
+		if (handle != nullptr) {
+			fclose(handle);
+			handle = nullptr;
+		}
+	}
+
+  public:
+	explicit HostJournalFile(const std::string &filePath) : path(filePath) {}
+	~HostJournalFile() { close(); }
+
+	bool readAll(std::vector<uint8_t> &content) override {
+		close();
+		content.clear();
+		FILE *file = fopen(path.c_str(), "rb");
+		if (file == nullptr) {
+			return false;
+		}
+		uint8_t buffer[256];
+		size_t count;
+		while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+			content.insert(content.end(), buffer, buffer + count);
+		}
+		fclose(file);
+		return true;
+	}
+
+	bool append(const uint8_t *data, size_t length) override {
+		if (handle == nullptr) {
+			handle = fopen(path.c_str(), "ab");
+			if (handle == nullptr) {
+				return false;
+			}
+		}
+		bool written = fwrite(data, 1, length, handle) == length;
+		return fflush(handle) == 0 && written;
+	}
+
+	bool rewrite(const uint8_t *data, size_t length) override {
+		close();
+		std::string tmpPath = path + ".tmp";
+		FILE *file = fopen(tmpPath.c_str(), "wb");
+		if (file == nullptr) {
+			return false;
+		}
+		bool written = fwrite(data, 1, length, file) == length;
+		fclose(file);
+		return written && rename(tmpPath.c_str(), path.c_str()) == 0;
+	}
+
+	void remove() override {
+		close();
+		::remove(path.c_str());
+	}
+};
+#else
+/**
+ * Journal file on LittleFS
+ */
+class LittleFSJournalFile : public IJournalFile {
+  private:
+	String path;
+	File handle;
+
+	void close() {
+		if (handle) {
+			handle.close();
+		}
+	}
+
+  public:
+	explicit LittleFSJournalFile(const char *filePath) : path(filePath) {}
+
+	bool readAll(std::vector<uint8_t> &content) override {
+		close();
+		content.clear();
+		if (!LittleFS.begin() || !LittleFS.exists(path)) {
+			return false;
+		}
+		File file = LittleFS.open(path, "r");
+		if (!file) {
+			return false;
+		}
+		content.resize(file.size());
+		size_t count = file.read(content.data(), content.size());
+		content.resize(count);
+		file.close();
+		return true;
+	}
+
+	bool append(const uint8_t *data, size_t length) override {
+		if (!handle) {
+			handle = LittleFS.open(path, "a");
+			if (!handle) {
+				return false;
+			}
+		}
+		bool written = handle.write(data, length) == length;
+		handle.flush();
+		return written;
+	}
+
+	bool rewrite(const uint8_t *data, size_t length) override {
+		close();
+		String tmpPath = path + ".tmp";
+		File file = LittleFS.open(tmpPath, "w");
+		if (!file) {
+			return false;
+		}
+		bool written = file.write(data, length) == length;
+		file.close();
+		return written && LittleFS.rename(tmpPath, path);
+	}
+
+	void remove() override {
+		close();
+		LittleFS.remove(path);
+	}
+};
+#endif
+
+/**
+ * Append-only journal for small runtime state records
+ *
+ * Every change is appended as one record:
+ *   type(1) keyLength(1) valueLength(1) key value crc32(4)
+ * so a stepper position update costs a few dozen bytes instead of a full
+ * configuration rewrite. The latest value of each key is kept in RAM.
+ *
+ * replay() rebuilds that state on boot and stops at the first torn or
+ * corrupt record. Compaction rewrites the log with one record per live key
+ * once it grows past the threshold; update() checks for it and is meant to
+ * be called from loop().
+ */
+class StateJournal {
+  private:
+	IJournalFile &file;
+	std::map<std::string, std::vector<uint8_t>> state;
+	size_t compactBytes;
+	size_t logBytes = 0;
+	size_t liveBytes = 0;
+
+	uint32_t bytesWritten = 0;
+	uint32_t compactions = 0;
+
+	static size_t recordSize(size_t keyLength, size_t valueLength) {
+		return STATE_JOURNAL_HEADER_SIZE + keyLength + valueLength +
+			   STATE_JOURNAL_CRC_SIZE;
+	}
+
+	static void encode(std::vector<uint8_t> &out, uint8_t type,
+					   const std::string &key, const uint8_t *value,
+					   uint8_t length) {
+		size_t start = out.size();
+		out.push_back(type);
+		out.push_back(static_cast<uint8_t>(key.size()));
+		out.push_back(length);
+		out.insert(out.end(), key.begin(), key.end());
+		out.insert(out.end(), value, value + length);
+		uint32_t crc = crc32(out.data() + start, out.size() - start);
+		for (uint8_t i = 0; i < STATE_JOURNAL_CRC_SIZE; i++) {
+			out.push_back(static_cast<uint8_t>(crc >> (8 * i)));
+		}
+	}
+
+	void apply(uint8_t type, const std::string &key, const uint8_t *value,
+			   uint8_t length) {
+		auto it = state.find(key);
+		if (it != state.end()) {
+			liveBytes -= recordSize(key.size(), it->second.size());
+			state.erase(it);
+		}
+		if (type == STATE_JOURNAL_RECORD) {
+			state[key].assign(value, value + length);
+			liveBytes += recordSize(key.size(), length);
+		}
+	}
+
+	bool appendRecord(uint8_t type, const std::string &key,
+					  const uint8_t *value, uint8_t length) {
+		std::vector<uint8_t> record;
+		record.reserve(recordSize(key.size(), length));
+		encode(record, type, key, value, length);
+		if (!file.append(record.data(), record.size())) {
+			return false;
+		}
+		logBytes += record.size();
+		bytesWritten += record.size();
+		apply(type, key, value, length);
+		return true;
+	}
+
+  public:
+	StateJournal(IJournalFile &journalFile,
+				 size_t compactThreshold = STATE_JOURNAL_COMPACT_BYTES)
+		: file(journalFile), compactBytes(compactThreshold) {}
+
+	/**
+	 * Rebuild the state from the log
+	 * A torn or corrupt tail is dropped by compacting right away, so new
+	 * records are never appended behind garbage.
+	 * @return Number of records applied
+	 */
+	size_t replay() {
+		state.clear();
+		liveBytes = 0;
+		logBytes = 0;
+
+		std::vector<uint8_t> content;
+		file.readAll(content);
+
+		size_t offset = 0;
+		size_t records = 0;
+		while (offset + recordSize(0, 0) <= content.size()) {
+			const uint8_t *record = content.data() + offset;
+			uint8_t type = record[0];
+			uint8_t keyLength = record[1];
+			uint8_t valueLength = record[2];
+			size_t size = recordSize(keyLength, valueLength);
+			if ((type != STATE_JOURNAL_RECORD &&
+				 type != STATE_JOURNAL_TOMBSTONE) ||
+				offset + size > content.size()) {
+				break;
+			}
+			size_t crcOffset = size - STATE_JOURNAL_CRC_SIZE;
+			uint32_t crc = 0;
+			for (uint8_t i = 0; i < STATE_JOURNAL_CRC_SIZE; i++) {
+				crc |= static_cast<uint32_t>(record[crcOffset + i]) << (8 * i);
+			}
+			if (crc32(record, crcOffset) != crc) {
+				break;
+			}
+			std::string key(reinterpret_cast<const char *>(record) +
+								STATE_JOURNAL_HEADER_SIZE,
+							keyLength);
+			apply(type, key, record + STATE_JOURNAL_HEADER_SIZE + keyLength,
+				  valueLength);
+			offset += size;
+			records++;
+		}
+
+		logBytes = offset;
+		if (offset != content.size()) {
+			compact();
+		}
+		return records;
+	}
+
+	/**
+	 * Record a new value for a key
+	 * Nothing is written if the value did not change.
+	 * @return False if the key or value is too long or the write failed
+	 */
+	bool put(const char *key, const void *value, uint8_t length) {
+		size_t keyLength = strlen(key);
+		if (keyLength == 0 || keyLength > STATE_JOURNAL_MAX_KEY ||
+			length > STATE_JOURNAL_MAX_VALUE) {
+			return false;
+		}
+		const uint8_t *bytes = static_cast<const uint8_t *>(value);
+		auto it = state.find(key);
+		if (it != state.end() && it->second.size() == length &&
+			memcmp(it->second.data(), bytes, length) == 0) {
+			return true;
+		}
+		return appendRecord(STATE_JOURNAL_RECORD, key, bytes, length);
+	}
+
+	template <typename T> bool put(const char *key, const T &value) {
+		return put(key, &value, sizeof(T));
+	}
+
+	/**
+	 * Read the latest value of a key
+	 * @return Value length, or -1 if the key is unknown or does not fit
+	 */
+	int get(const char *key, void *value, uint8_t capacity) const {
+		auto it = state.find(key);
+		if (it == state.end() || it->second.size() > capacity) {
+			return -1;
+		}
+		memcpy(value, it->second.data(), it->second.size());
+		return static_cast<int>(it->second.size());
+	}
+
+	template <typename T> bool get(const char *key, T &value) const {
+		return get(key, &value, sizeof(T)) == static_cast<int>(sizeof(T));
+	}
+
+	bool contains(const char *key) const {
+		return state.find(key) != state.end();
+	}
+
+	/**
+	 * Forget a key, e.g. when its ESPinner is removed
+	 */
+	bool erase(const char *key) {
+		if (!contains(key)) {
+			return true;
+		}
+		return appendRecord(STATE_JOURNAL_TOMBSTONE, key, nullptr, 0);
+	}
+
+	/**
+	 * Rewrite the log with one record per live key
+	 */
+	bool compact() {
+		std::vector<uint8_t> content;
+		content.reserve(liveBytes);
+		for (const auto &entry : state) {
+			encode(content, STATE_JOURNAL_RECORD, entry.first,
+				   entry.second.data(),
+				   static_cast<uint8_t>(entry.second.size()));
+		}
+		if (!file.rewrite(content.data(), content.size())) {
+			return false;
+		}
+		logBytes = content.size();
+		bytesWritten += content.size();
+		compactions++;
+		return true;
+	}
+
+	/**
+	 * Compact when the log is past the threshold and mostly stale records
+	 */
+	void update() {
+		if (logBytes > compactBytes && logBytes > 2 * liveBytes) {
+			compact();
+		}
+	}
+
+	/**
+	 * Drop every key and the log itself
+	 */
+	void clear() {
+		file.remove();
+		state.clear();
+		logBytes = 0;
+		liveBytes = 0;
+	}
+
+	size_t size() const { return state.size(); }
+	size_t getLogBytes() const { return logBytes; }
+	uint32_t getBytesWritten() const { return bytesWritten; }
+	uint32_t getCompactions() const { return compactions; }
+};
+
+#ifdef ARDUINO
+/**
+ * Journal for ESPinner runtime state, stored on LittleFS
+ */
+StateJournal &getStateJournal() {
+	static LittleFSJournalFile journalFile(STATE_JOURNAL_PATH);
+	static StateJournal journal(journalFile);
+	return journal;
+}
+#endif
+
+#endif
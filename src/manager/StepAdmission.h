@@ -0,0 +1,159 @@
+#ifndef _ESPALLON_STEPADMISSION_H
+#define _ESPALLON_STEPADMISSION_H
+
+#include <atomic>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Share of the requested rate a sustainable speed must deliver
+#ifndef STEPPER_CAPACITY_TOLERANCE
+#define STEPPER_CAPACITY_TOLERANCE 0.95f
+#endif
+
+enum class AdmissionPolicy : uint8_t {
+	Warn,  // Grant the speed, report the overload
+	Clamp, // Grant what is left of the capacity
+};
+
+/**
+ * Outcome of a speed request, speeds in steps/s
+ */
+struct Admission {
+	float requested;
+	float granted; // Same sign as requested
+	float total;   // Aggregate of all slots after the request
+	bool overCapacity;
+};
+
+/**
+ * Admission control of the aggregate step rate
+ *
+ * Every slot (a stepper) holds the speed it was last granted; the sum must
+ * stay within the capacity the loop was measured to sustain. A request
+ * that would exceed it is flagged, and with AdmissionPolicy::Clamp reduced
+ * to the capacity the other slots leave. Speeds count by magnitude until
+ * the slot is released or set to 0.
+ *
+ * request() and release() belong to one task, the one running the
+ * steppers; preview() and the getters may be called from any task.
+ */
+template <size_t N> class StepAdmission {
+  private:
+	std::atomic<float> speeds[N];
+	float capacity;
+	AdmissionPolicy policy;
+	std::atomic<uint32_t> overloads{0};
+
+	float othersTotal(size_t slot) const {
+		float total = 0;
+		for (size_t i = 0; i < N; i++) {
+			if (i != slot) {
+				total += speeds[i].load(std::memory_order_relaxed);
+			}
+		}
+		return total;
+	}
+
+  public:
+	StepAdmission(float capacity, AdmissionPolicy policy)
+		: capacity(capacity), policy(policy) {
+		for (std::atomic<float> &speed : speeds) {
+			speed.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 * What request() would grant now, without holding it
+	 * @param slot 0 to N - 1; other slots are granted without accounting
+	 */
+	Admission preview(size_t slot, float speed) const {
+		Admission admission = {speed, speed, 0, false};
+		if (slot >= N) {
+			admission.total = getTotal();
+			return admission;
+		}
+		float others = othersTotal(slot);
+		float magnitude = fabsf(speed);
+		if (others + magnitude > capacity) {
+			admission.overCapacity = true;
+			if (policy == AdmissionPolicy::Clamp) {
+				float left = capacity > others ? capacity - others : 0;
+				magnitude = left;
+				admission.granted = speed < 0 ? -left : left;
+			}
+		}
+		admission.total = others + magnitude;
+		return admission;
+	}
+
+	/**
+	 * Grants a speed and holds it for the slot
+	 * @param slot 0 to N - 1; other slots are granted without accounting
+	 */
+	Admission request(size_t slot, float speed) {
+		Admission admission = preview(slot, speed);
+		if (slot < N) {
+			speeds[slot].store(fabsf(admission.granted),
+							   std::memory_order_relaxed);
+			if (admission.overCapacity) {
+				overloads.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		return admission;
+	}
+
+	void release(size_t slot) {
+		if (slot < N) {
+			speeds[slot].store(0, std::memory_order_relaxed);
+		}
+	}
+
+	/** Speed held by a slot, steps/s */
+	float getSpeed(size_t slot) const {
+		return slot < N ? speeds[slot].load(std::memory_order_relaxed) : 0;
+	}
+	float getTotal() const { return othersTotal(N); }
+	float getCapacity() const { return capacity; }
+	void setCapacity(float value) { capacity = value; }
+	AdmissionPolicy getPolicy() const { return policy; }
+	void setPolicy(AdmissionPolicy value) { policy = value; }
+	/** Requests flagged over capacity so far */
+	uint32_t getOverloads() const {
+		return overloads.load(std::memory_order_relaxed);
+	}
+};
+
+/**
+ * Measures the highest aggregate step rate a loop sustains
+ *
+ * Binary search over the per stepper speed: a speed is sustainable when
+ * the slowest stepper delivers at least tolerance of it. Assumes speeds
+ * under a sustainable one are sustainable too.
+ * @param steppers Steppers run by each trial
+ * @param maxSpeed Highest per stepper speed tried, steps/s
+ * @param trial Callable taking the per stepper speed and returning the
+ * lowest delivered/requested ratio of the steppers
+ * @return Aggregate steps/s: steppers times the highest sustainable speed
+ */
+template <typename Trial>
+float measureStepCapacity(size_t steppers, float maxSpeed, Trial trial,
+						  float tolerance = STEPPER_CAPACITY_TOLERANCE,
+						  uint8_t iterations = 10) {
+	float low = 0;
+	float high = maxSpeed;
+	if (trial(high) >= tolerance) {
+		return steppers * high;
+	}
+	for (uint8_t i = 0; i < iterations; i++) {
+		float speed = (low + high) / 2;
+		if (trial(speed) >= tolerance) {
+			low = speed;
+		} else {
+			high = speed;
+		}
+	}
+	return steppers * low;
+}
+
+#endif
@@ -0,0 +1,305 @@
+#ifndef _ESPALLON_STORAGEBACKEND_H
+#define _ESPALLON_STORAGEBACKEND_H
+
+#include <map>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+#ifdef ARDUINO
+#include <LittleFS.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#ifndef STORAGE_LITTLEFS_ROOT
+#define STORAGE_LITTLEFS_ROOT "/cfg"
+#endif
+
+/**
+ * Capacity and usage of a storage backend
+ * Sizes are 0 when the backend cannot report them.
+ */
+struct StorageUsage {
+	size_t totalBytes = 0; // Capacity of the underlying medium
+	size_t usedBytes = 0;  // Bytes in use, including other users of the medium
+	size_t entries = 0;	   // Stored keys, files or NVS entries
+};
+
+/**
+ * Key/value storage used for persisted configuration
+ *
+ * Keys are short names ("espinners_a"); values are opaque byte strings,
+ * written as a whole. Implementations exist for NVS (Storage_Manager.h),
+ * LittleFS, RAM and, on the host, plain files.
+ */
+class IStorageBackend {
+  public:
+	virtual ~IStorageBackend() = default;
+
+	virtual const char *name() const = 0;
+	virtual bool begin() { return true; }
+
+	/**
+	 * @param value Output value, cleared when the key is missing
+	 * @return False if the key is missing or cannot be read
+	 */
+	virtual bool read(const char *key, std::string &value) = 0;
+	virtual bool write(const char *key, const char *data, size_t length) = 0;
+	virtual bool remove(const char *key) = 0;
+
+	virtual bool exists(const char *key) {
+		std::string value;
+		return read(key, value);
+	}
+
+	bool write(const char *key, const std::string &value) {
+		return write(key, value.data(), value.size());
+	}
+
+	virtual StorageUsage usage() = 0;
+};
+
+/**
+ * Storage kept in RAM, lost on reset
+ * Used by tests and as a baseline for benchmarks. A non-zero capacity makes
+ * writes fail like a full flash partition.
+ */
+class MemoryStorageBackend : public IStorageBackend {
+  private:
+	std::map<std::string, std::string> values;
+	size_t capacity;
+	size_t used = 0;
+
+  public:
+	using IStorageBackend::write;
+
+	explicit MemoryStorageBackend(size_t capacityBytes = 0)
+		: capacity(capacityBytes) {}
+
+	const char *name() const override { return "memory"; }
+
+	bool read(const char *key, std::string &value) override {
+		auto it = values.find(key);
+		if (it == values.end()) {
+			value.clear();
+			return false;
+		}
+		value = it->second;
+		return true;
+	}
+
+	bool write(const char *key, const char *data, size_t length) override {
+		auto it = values.find(key);
+		size_t previous = it != values.end() ? strlen(key) + it->second.size()
+											 : 0;
+		size_t next = used - previous + strlen(key) + length;
+		if (capacity > 0 && next > capacity) {
+			return false;
+		}
+		values[key].assign(data, length);
+		used = next;
+		return true;
+	}
+
+	bool remove(const char *key) override {
+		auto it = values.find(key);
+		if (it == values.end()) {
+			return false;
+		}
+		used -= it->first.size() + it->second.size();
+		values.erase(it);
+		return true;
+	}
+
+	bool exists(const char *key) override {
+		return values.find(key) != values.end();
+	}
+
+	StorageUsage usage() override {
+		StorageUsage info;
+		info.totalBytes = capacity;
+		info.usedBytes = used;
+		info.entries = values.size();
+		return info;
+	}
+};
+
+#ifndef ARDUINO
+/**
+ * One file per key in a host directory, used by native tests and
+ * benchmarks. Writes go to a temporary file renamed over the old one.
+ */
+class HostFileStorageBackend : public IStorageBackend {
+  private:
+	std::string root;
+
+	std::string keyPath(const char *key) const { return root + "/" + key; }
+
+  public:
+	using IStorageBackend::write;
+
+	explicit HostFileStorageBackend(const std::string &directory)
+		: root(directory) {}
+
+	const char *name() const override { return "hostfile"; }
+
+	bool begin() override {
+		mkdir(root.c_str(), 0755);
+		struct stat info;
+		return stat(root.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+	}
+
+	bool read(const char *key, std::string &value) override {
+		value.clear();
+		FILE *file = fopen(keyPath(key).c_str(), "rb");
+		if (file == nullptr) {
+			return false;
+		}
+		char buffer[512];
+		size_t count;
+		while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+			value.append(buffer, count);
+		}
+		fclose(file);
+		return true;
+	}
+
+	bool write(const char *key, const char *data, size_t length) override {
+		std::string path = keyPath(key);
+		std::string tmpPath = path + ".tmp";
+		FILE *file = fopen(tmpPath.c_str(), "wb");
+		if (file == nullptr) {
+			return false;
+		}
+		bool written = fwrite(data, 1, length, file) == length;
+		written = fclose(file) == 0 && written;
+		return written && rename(tmpPath.c_str(), path.c_str()) == 0;
+	}
+
+	bool remove(const char *key) override {
+		return ::remove(keyPath(key).c_str()) == 0;
+	}
+
+	bool exists(const char *key) override {
+		struct stat info;
+		return stat(keyPath(key).c_str(), &info) == 0;
+	}
+
+	StorageUsage usage() override {
+		StorageUsage info;
+		DIR *dir = opendir(root.c_str());
+		if (dir == nullptr) {
+			return info;
+		}
+		struct dirent *entry;
+		while ((entry = readdir(dir)) != nullptr) {
+			struct stat fileInfo;
+			std::string path = root + "/" + entry->d_name;
+			if (stat(path.c_str(), &fileInfo) == 0 &&
+				S_ISREG(fileInfo.st_mode)) {
+				info.usedBytes += fileInfo.st_size;
+				info.entries++;
+			}
+		}
+		closedir(dir);
+		return info;
+	}
+};
+#else
+/**
+ * One LittleFS file per key under STORAGE_LITTLEFS_ROOT
+ * Writes go to a temporary file renamed over the old one, so a power loss
+ * keeps the previous value.
+ */
+class LittleFSStorageBackend : public IStorageBackend {
+  private:
+	String root;
+
+	String keyPath(const char *key) const { return root + "/" + key; }
+
+  public:
+	using IStorageBackend::write;
+
+	explicit LittleFSStorageBackend(const char *directory = STORAGE_LITTLEFS_ROOT)
+		: root(directory) {}
+
+	const char *name() const override { return "littlefs"; }
+
+	bool begin() override {
+		if (!LittleFS.begin()) {
+			return false;
+		}
+		return LittleFS.exists(root) || LittleFS.mkdir(root);
+	}
+
+	bool read(const char *key, std::string &value) override {
+		value.clear();
+		String path = keyPath(key);
+		if (!LittleFS.exists(path)) {
+			return false;
+		}
+		File file = LittleFS.open(path, "r");
+		if (!file) {
+			return false;
+		}
+		value.resize(file.size());
+		size_t count =
+			file.read(reinterpret_cast<uint8_t *>(&value[0]), value.size());
+		value.resize(count);
+		file.close();
+		return true;
+	}
+
+	bool write(const char *key, const char *data, size_t length) override {
+		String path = keyPath(key);
+		String tmpPath = path + ".tmp";
+		File file = LittleFS.open(tmpPath, "w");
+		if (!file) {
+			return false;
+		}
+		bool written =
+			file.write(reinterpret_cast<const uint8_t *>(data), length) ==
+			length;
+		file.close();
+		return written && LittleFS.rename(tmpPath, path);
+	}
+
+	bool remove(const char *key) override {
+		return LittleFS.remove(keyPath(key));
+	}
+
+	bool exists(const char *key) override {
+		return LittleFS.exists(keyPath(key));
+	}
+
+	StorageUsage usage() override {
+		StorageUsage info;
+#if defined(ESP32)
+		info.totalBytes = LittleFS.totalBytes();
+		info.usedBytes = LittleFS.usedBytes();
+#else
+		FSInfo fsInfo;
+		if (LittleFS.info(fsInfo)) {
+			info.totalBytes = fsInfo.totalBytes;
+			info.usedBytes = fsInfo.usedBytes;
+		}
+#endif
+		File dir = LittleFS.open(root, "r");
+		if (dir) {
+			File file = dir.openNextFile();
+			while (file) {
+				info.entries++;
+				file.close();
+				file = dir.openNextFile();
+			}
+			dir.close();
+		}
+		return info;
+	}
+};
+#endif
+
+#endif
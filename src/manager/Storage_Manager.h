@@ -2,11 +2,110 @@
 #define _ESPALLON_STORAGE_MANAGER_H
 #define NVS
 
+#include "StorageBackend.h"
 #include <Persistance.h>
 
+#if defined(ESP32)
+#include <nvs.h>
+#endif
+
+#define STORAGE_BACKEND_NVS 0
+#define STORAGE_BACKEND_LITTLEFS 1
+#define STORAGE_BACKEND_MEMORY 2
+
+// Backend holding the ESPinner configuration (-D STORAGE_BACKEND=...)
+#ifndef STORAGE_BACKEND
+#define STORAGE_BACKEND STORAGE_BACKEND_NVS
+#endif
+
 NVS_Storage storage;
 
-// TODO : Utils Methods to check Files in Storage, Size and different
-// characteristics
+/**
+ * NVS backend over the Persistance storage model
+ * Keys are written the way Persistance always wrote them, so configurations
+ * stored by older firmware stay readable.
+ */
+class NVSStorageBackend : public IStorageBackend {
+  private:
+	Persistance persistance;
+
+  public:
+	using IStorageBackend::write;
+
+	NVSStorageBackend() : persistance(nullptr, &storage) {}
+
+	const char *name() const override { return "nvs"; }
+
+	bool begin() override {
+		storage.setRoot(ESPinner_File);
+		return true;
+	}
+
+	bool read(const char *key, std::string &value) override {
+		String data = persistance.loadData(key);
+		value.assign(data.c_str(), data.length());
+		return data.length() > 0;
+	}
+
+	/**
+	 * Persistance reports no save result: the value is read back instead
+	 */
+	bool write(const char *key, const char *data, size_t length) override {
+		std::string value(data, length);
+		persistance.getStorageModel()->save(String(value.c_str()), key);
+		std::string stored;
+		read(key, stored);
+		return stored == value;
+	}
+
+	bool remove(const char *key) override {
+		persistance.getStorageModel()->remove(key);
+		return persistance.loadData(key).length() == 0;
+	}
+
+	/**
+	 * NVS reports whole-partition entry counts; each entry is 32 bytes
+	 */
+	StorageUsage usage() override {
+		StorageUsage info;
+#if defined(ESP32)
+		nvs_stats_t stats;
+		if (nvs_get_stats(NULL, &stats) == ESP_OK) {
+			info.totalBytes = stats.total_entries * 32;
+			info.usedBytes = stats.used_entries * 32;
+			info.entries = stats.used_entries;
+		}
+#endif
+		return info;
+	}
+};
+
+/**
+ * Backend selected at build time for the ESPinner configuration
+ */
+IStorageBackend &getStorageBackend() {
+#if STORAGE_BACKEND == STORAGE_BACKEND_LITTLEFS
+	static LittleFSStorageBackend backend;
+#elif STORAGE_BACKEND == STORAGE_BACKEND_MEMORY
+	static MemoryStorageBackend backend;
+#else
+	static NVSStorageBackend backend;
+#endif
+	static bool started = backend.begin();
+	(void)started;
+	return backend;
+}
+
+/**
+ * Print capacity and usage of the configuration backend
+ */
+void DUMP_STORAGE() {
+	IStorageBackend &backend = getStorageBackend();
+	StorageUsage info = backend.usage();
+	DUMPLN("Storage backend: ", backend.name());
+	DUMPLN("Storage total bytes: ", info.totalBytes);
+	DUMPLN("Storage used bytes: ", info.usedBytes);
+	DUMPLN("Storage entries: ", info.entries);
+}
 
-#endif
\ No newline at end of file
+#endif
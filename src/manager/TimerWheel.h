@@ -0,0 +1,366 @@
+#ifndef _ESPALLON_TIMERWHEEL_H
+#define _ESPALLON_TIMERWHEEL_H
+
+#include "Clock.h"
+
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+
+// Timers registered at most: ESPinner tickers, controllers and services
+#ifndef TIMER_WHEEL_MAX_TIMERS
+#define TIMER_WHEEL_MAX_TIMERS 32
+#endif
+
+/**
+ * Hierarchical timer wheel, in ms
+ *
+ * Three levels of 64 slots cover 1 ms, 64 ms and 4096 ms per slot; timers
+ * beyond the current 262 s block wait in an overflow list. A timer sits in
+ * the level that holds its expiry and moves down when the wheel enters its
+ * slot, so arming, cancelling and firing are O(1) and advance() only visits
+ * due timers. The next expiry is read from per level occupancy bitmaps and
+ * cached until the timers change, which lets the loop ask how long it may
+ * idle.
+ *
+ * Timers live in a fixed pool of TIMER_WHEEL_MAX_TIMERS entries addressed
+ * by handle; callbacks may arm, stop or release any timer, itself included.
+ */
+class TimerWheel {
+  public:
+	typedef uint32_t (*Clock)();
+	typedef std::function<void()> TimerCallback;
+	typedef int TimerHandle; // -1 = invalid
+
+	static constexpr uint32_t NONE = UINT32_MAX;
+
+  private:
+	static constexpr uint8_t LEVELS = 3;
+	static constexpr uint8_t SLOT_BITS = 6;
+	static constexpr uint8_t SLOTS = 1 << SLOT_BITS;
+	static constexpr uint8_t OVERFLOW_LEVEL = LEVELS;
+	static constexpr int16_t END = -1;
+
+	enum TimerState : uint8_t { FREE, IDLE, ARMED, DUE };
+
+	struct Timer {
+		TimerCallback callback;
+		uint32_t expiry = 0;
+		uint32_t period = 0; // 0 = one shot
+		int16_t next = END;
+		int16_t prev = END;
+		uint8_t level = 0;
+		uint8_t slot = 0;
+		TimerState state = FREE;
+	};
+
+	Clock clock;
+	uint32_t current;
+	Timer timers[TIMER_WHEEL_MAX_TIMERS];
+	int16_t heads[LEVELS + 1][SLOTS]; // Overflow uses slot 0
+	uint64_t occupied[LEVELS] = {};
+	uint32_t cachedNext = 0;
+	bool hasCachedNext = false;
+	bool cacheValid = false;
+	uint32_t fired = 0;
+	uint32_t exhausted = 0;
+
+	static bool before(uint32_t a, uint32_t b) {
+		return static_cast<int32_t>(a - b) < 0;
+	}
+
+	static uint8_t shift(uint8_t level) { return level * SLOT_BITS; }
+
+	/**
+	 * A timer goes to the lowest level whose parent block it shares with
+	 * current: level 0 holds the current 64 ms block, level 1 the rest of
+	 * the current 4096 ms block, and so on. Slots never alias and a level
+	 * only expires after every level below it.
+	 */
+	void link(int index) {
+		Timer &timer = timers[index];
+		if (before(timer.expiry, current)) {
+			timer.expiry = current;
+		}
+		uint8_t level = 0;
+		while (level < LEVELS && (timer.expiry >> shift(level + 1)) !=
+									 (current >> shift(level + 1))) {
+			level++;
+		}
+		uint8_t slot = level == OVERFLOW_LEVEL
+						   ? 0
+						   : (timer.expiry >> shift(level)) & (SLOTS - 1);
+		timer.level = level;
+		timer.slot = slot;
+		timer.prev = END;
+		timer.next = heads[level][slot];
+		if (timer.next != END) {
+			timers[timer.next].prev = index;
+		}
+		heads[level][slot] = index;
+		if (level < LEVELS) {
+			occupied[level] |= 1ULL << slot;
+		}
+		timer.state = ARMED;
+		cacheValid = false;
+	}
+
+	void unlink(int index) {
+		Timer &timer = timers[index];
+		if (timer.state != ARMED) {
+			return;
+		}
+		if (timer.prev != END) {
+			timers[timer.prev].next = timer.next;
+		} else {
+			heads[timer.level][timer.slot] = timer.next;
+			if (timer.next == END && timer.level < LEVELS) {
+				occupied[timer.level] &= ~(1ULL << timer.slot);
+			}
+		}
+		if (timer.next != END) {
+			timers[timer.next].prev = timer.prev;
+		}
+		timer.next = timer.prev = END;
+		timer.state = IDLE;
+		cacheValid = false;
+	}
+
+	/**
+	 * Moves the timers of a slot one level down, relative to current
+	 */
+	void cascade(uint8_t level, uint8_t slot) {
+		int16_t index = heads[level][slot];
+		heads[level][slot] = END;
+		if (level < LEVELS) {
+			occupied[level] &= ~(1ULL << slot);
+		}
+		while (index != END) {
+			int16_t next = timers[index].next;
+			timers[index].state = IDLE;
+			link(index);
+			index = next;
+		}
+	}
+
+	/**
+	 * Advances current to a time no later than the next expiry, moving the
+	 * timers of the blocks entered one level down. Blocks skipped on the way
+	 * are empty, or the next expiry would be earlier.
+	 */
+	void moveTo(uint32_t time) {
+		uint32_t from = current;
+		current = time;
+		if ((from >> shift(LEVELS)) != (time >> shift(LEVELS))) {
+			cascade(OVERFLOW_LEVEL, 0);
+		}
+		for (uint8_t level = LEVELS - 1; level >= 1; level--) {
+			if ((from >> shift(level)) != (time >> shift(level))) {
+				cascade(level, (time >> shift(level)) & (SLOTS - 1));
+			}
+		}
+	}
+
+	/** First occupied slot of a level at or after the current one */
+	int firstSlot(uint8_t level) const {
+		uint8_t start = (current >> shift(level)) & (SLOTS - 1);
+		uint64_t bits = occupied[level] & (~0ULL << start);
+		return bits ? __builtin_ctzll(bits) : -1;
+	}
+
+	void considerList(int16_t index, bool &found, uint32_t &earliest) const {
+		for (; index != END; index = timers[index].next) {
+			if (!found || before(timers[index].expiry, earliest)) {
+				earliest = timers[index].expiry;
+				found = true;
+			}
+		}
+	}
+
+	/** Levels expire in order, so the earliest timer is in the first slot */
+	void computeNext() {
+		bool found = false;
+		uint32_t earliest = 0;
+		for (uint8_t level = 0; level < LEVELS && !found; level++) {
+			int slot = firstSlot(level);
+			if (slot >= 0) {
+				considerList(heads[level][slot], found, earliest);
+			}
+		}
+		if (!found) {
+			considerList(heads[OVERFLOW_LEVEL][0], found, earliest);
+		}
+		cachedNext = earliest;
+		hasCachedNext = found;
+		cacheValid = true;
+	}
+
+	bool valid(TimerHandle handle) const {
+		return handle >= 0 && handle < TIMER_WHEEL_MAX_TIMERS &&
+			   timers[handle].state != FREE;
+	}
+
+  public:
+	explicit TimerWheel(Clock clock) : clock(clock), current(clock()) {
+		for (uint8_t level = 0; level <= LEVELS; level++) {
+			for (uint8_t slot = 0; slot < SLOTS; slot++) {
+				heads[level][slot] = END;
+			}
+		}
+	}
+
+	/**
+	 * Allocates a stopped timer
+	 * @return Handle, -1 if the pool is exhausted (counted in
+	 * getExhausted())
+	 */
+	TimerHandle create(TimerCallback callback) {
+		for (int i = 0; i < TIMER_WHEEL_MAX_TIMERS; i++) {
+			if (timers[i].state == FREE) {
+				timers[i] = Timer();
+				timers[i].callback = callback;
+				timers[i].state = IDLE;
+				return i;
+			}
+		}
+		exhausted++;
+		return -1;
+	}
+
+	void release(TimerHandle handle) {
+		if (valid(handle)) {
+			unlink(handle);
+			timers[handle] = Timer();
+		}
+	}
+
+	void setCallback(TimerHandle handle, TimerCallback callback) {
+		if (valid(handle)) {
+			timers[handle].callback = callback;
+		}
+	}
+
+	/**
+	 * Arms a timer, replacing a pending expiry
+	 * @param delay First expiry, in ms from now
+	 * @param period Time between later expiries, 0 for a one shot timer
+	 */
+	void start(TimerHandle handle, uint32_t delay, uint32_t period = 0) {
+		if (!valid(handle)) {
+			return;
+		}
+		unlink(handle);
+		timers[handle].expiry = clock() + delay;
+		timers[handle].period = period;
+		link(handle);
+	}
+
+	void stop(TimerHandle handle) {
+		if (valid(handle)) {
+			unlink(handle);
+			timers[handle].state = IDLE;
+		}
+	}
+
+	bool isArmed(TimerHandle handle) const {
+		return valid(handle) && timers[handle].state == ARMED;
+	}
+
+	/**
+	 * Fires every timer due by now, call once per loop pass
+	 * @return Number of timers fired
+	 */
+	size_t advance() {
+		uint32_t now = clock();
+		size_t count = 0;
+		int16_t due[TIMER_WHEEL_MAX_TIMERS];
+		for (;;) {
+			uint32_t next;
+			if (!nextExpiry(next) || before(now, next)) {
+				moveTo(now);
+				break;
+			}
+			moveTo(next);
+
+			// Detach the slot first: callbacks may change any timer
+			uint8_t slot = next & (SLOTS - 1);
+			size_t dueCount = 0;
+			int16_t index = heads[0][slot];
+			while (index != END) {
+				int16_t following = timers[index].next;
+				unlink(index);
+				timers[index].state = DUE;
+				due[dueCount++] = index;
+				index = following;
+			}
+			for (size_t i = 0; i < dueCount; i++) {
+				Timer &timer = timers[due[i]];
+				if (timer.state != DUE) {
+					continue; // Stopped or re-armed by an earlier callback
+				}
+				timer.state = IDLE;
+				if (timer.period > 0) {
+					// Keep the period grid, resynchronize after a stall
+					timer.expiry += timer.period;
+					if (!before(now, timer.expiry)) {
+						timer.expiry = now + timer.period;
+					}
+					link(due[i]);
+				}
+				count++;
+				fired++;
+				if (timer.callback) {
+					timer.callback();
+				}
+			}
+		}
+		return count;
+	}
+
+	/**
+	 * Earliest expiry of the armed timers
+	 * @return false if no timer is armed
+	 */
+	bool nextExpiry(uint32_t &expiry) {
+		if (!cacheValid) {
+			computeNext();
+		}
+		expiry = cachedNext;
+		return hasCachedNext;
+	}
+
+	/**
+	 * Time the loop may idle before the next expiry
+	 * @return ms, 0 if a timer is due, NONE if no timer is armed
+	 */
+	uint32_t timeUntilNext() {
+		uint32_t next;
+		if (!nextExpiry(next)) {
+			return NONE;
+		}
+		uint32_t now = clock();
+		return before(now, next) ? next - now : 0;
+	}
+
+	size_t armedCount() const {
+		size_t count = 0;
+		for (const Timer &timer : timers) {
+			count += timer.state == ARMED;
+		}
+		return count;
+	}
+	uint32_t getFired() const { return fired; }
+
+	/** create() calls refused because every timer was in use */
+	uint32_t getExhausted() const { return exhausted; }
+};
+
+/**
+ * Timer wheel of the main loop, advanced by a scheduler task
+ */
+TimerWheel &getTimerWheel() {
+	static TimerWheel wheel(clockMillis);
+	return wheel;
+}
+
+#endif
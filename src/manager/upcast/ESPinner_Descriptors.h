@@ -0,0 +1,213 @@
+#ifndef _ESPINNER_DESCRIPTORS_H
+#define _ESPINNER_DESCRIPTORS_H
+
+#include "../../controllers/ESPinner.h"
+#include "../../models/BoardCapabilities.h"
+#include <ArduinoJson.h>
+#include <string.h>
+
+typedef std::unique_ptr<ESPinner> (*ESPinnerConstructor)();
+typedef void (*ESPinnerUIBuilder)(uint16_t parentRef);
+
+/**
+ * JSON key holding a GPIO number and the board capabilities the module
+ * needs on that pin (BOARD_CAP_* flags). Absent keys are optional pins.
+ * Capabilities that depend on the configuration are added when the JSON key
+ * modeKey holds modeValue, e.g. an output on a GPIO whose mode is OUTPUT.
+ */
+struct PinFieldSchema {
+	const char *key;
+	uint16_t requiredCaps;
+	const char *modeKey;   // nullptr if the needs do not depend on a mode
+	const char *modeValue; // Mode adding modeCaps
+	uint16_t modeCaps;
+};
+
+/**
+ * Board capabilities a pin field needs in one ESPinner configuration
+ * @param field Pin field schema
+ * @param config ESPinner JSON configuration
+ * @return BOARD_CAP_* flags
+ */
+inline uint16_t requiredPinCaps(const PinFieldSchema &field,
+								JsonVariantConst config) {
+	uint16_t caps = field.requiredCaps;
+	if (field.modeKey != nullptr) {
+		const char *mode = config[field.modeKey];
+		if (mode != nullptr && strcmp(mode, field.modeValue) == 0) {
+			caps |= field.modeCaps;
+		}
+	}
+	return caps;
+}
+
+/**
+ * Static description of an ESPinner module type
+ * Ties the JSON tag to the module enum, its constructor, the JSON keys that
+ * hold GPIO numbers and the UI builder for the configuration panel.
+ */
+struct ESPinner_Descriptor {
+	const char *tag;			   // ESPinner_Mod value in JSON config
+	ESPinner_Mod mod;			   // Module type enumeration
+	const char *label;			   // Label in ESPinner type selector
+	ESPinnerConstructor construct; // Creates an empty ESPinner
+	const PinFieldSchema *pinFields; // JSON keys holding GPIO numbers
+	uint8_t numPinFields;			 // 0 for modules without pins yet
+	ESPinnerUIBuilder buildUI;	   // Builds the configuration panel
+	const char *selectorLabel;	   // Control that marks the panel as built
+	bool pendingOnSave;			   // Panel styled PENDING when saved
+};
+
+template <typename T> std::unique_ptr<ESPinner> constructESPinner() {
+	return std::unique_ptr<ESPinner>(new T());
+}
+
+template <size_t N>
+constexpr uint8_t pinFieldCount(const PinFieldSchema (&)[N]) {
+	return N;
+}
+
+constexpr PinFieldSchema GPIO_PIN_FIELDS[] = {
+	{ESPINNER_GPIO_JSONCONFIG, 0, ESPINNER_IO_JSONCONFIG,
+	 ESPINNER_OUTPUT_CONFIG, BOARD_CAP_OUTPUT}};
+constexpr PinFieldSchema DC_PIN_FIELDS[] = {
+	{ESPINNER_DCA_JSONCONFIG, BOARD_CAP_PWM},
+	{ESPINNER_DCB_JSONCONFIG, BOARD_CAP_PWM}};
+constexpr PinFieldSchema NEOPIXEL_PIN_FIELDS[] = {
+	{ESPINNER_NEOPIXEL_GPIO_CONFIG, BOARD_CAP_OUTPUT}};
+constexpr PinFieldSchema STEPPER_PIN_FIELDS[] = {
+	{ESPINNER_STEPPER_STEP_CONFIG, BOARD_CAP_OUTPUT},
+	{ESPINNER_STEPPER_DIR_CONFIG, BOARD_CAP_OUTPUT},
+	{ESPINNER_STEPPER_EN_CONFIG, BOARD_CAP_OUTPUT},
+	{ESPINNER_STEPPER_CS_CONFIG, BOARD_CAP_OUTPUT},
+	{ESPINNER_STEPPER_DIAG0_CONFIG, 0},
+	{ESPINNER_STEPPER_DIAG1_CONFIG, 0}};
+
+/**
+ * Module descriptors, sorted by tag for binary search.
+ * Modules disabled in config.h are left out at compile time.
+ */
+constexpr ESPinner_Descriptor ESPinnerDescriptors[] = {
+#if ESPALLON_MOD_DC
+	{ESPINNER_DC_JSONCONFIG, ESPinner_Mod::DC, DC_LABEL,
+	 constructESPinner<ESPinner_DC>, DC_PIN_FIELDS,
+	 pinFieldCount(DC_PIN_FIELDS), DC_UI,
+	 DC_MODESELECTOR_LABEL, true},
+#endif
+#if ESPALLON_MOD_ENCODER
+	{ESPINNER_ENCODER_JSONCONFIG, ESPinner_Mod::Encoder, ENCODER_LABEL,
+	 constructESPinner<ESPinner_Encoder>, nullptr, 0, Encoder_UI,
+	 ENCODER_MODESELECTOR_LABEL, false},
+#endif
+	{ESPINNER_GPIO_JSONCONFIG, ESPinner_Mod::GPIO, GPIO_LABEL,
+	 constructESPinner<ESPinner_GPIO>, GPIO_PIN_FIELDS,
+	 pinFieldCount(GPIO_PIN_FIELDS), GPIO_UI,
+	 GPIO_MODESELECTOR_LABEL, true},
+#if ESPALLON_MOD_LCD
+	{ESPINNER_LCD_JSONCONFIG, ESPinner_Mod::LCD, LCD_LABEL,
+	 constructESPinner<ESPinner_LCD>, nullptr, 0, LCD_UI,
+	 LCD_MODESELECTOR_LABEL, false},
+#endif
+#if ESPALLON_MOD_MPU
+	{ESPINNER_MPU_JSONCONFIG, ESPinner_Mod::MPU, MPU_LABEL,
+	 constructESPinner<ESPinner_MPU>, nullptr, 0, MPU_UI,
+	 MPU_MODESELECTOR_LABEL, false},
+#endif
+#if ESPALLON_MOD_NEOPIXEL
+	{ESPINNER_NEOPIXEL_JSONCONFIG, ESPinner_Mod::NeoPixel, NEOPIXEL_LABEL,
+	 constructESPinner<ESPinner_Neopixel>, NEOPIXEL_PIN_FIELDS,
+	 pinFieldCount(NEOPIXEL_PIN_FIELDS),
+	 Neopixel_UI, NEOPIXEL_MODESELECTOR_LABEL, false},
+#endif
+#if ESPALLON_MOD_RFID
+	{ESPINNER_RFID_JSONCONFIG, ESPinner_Mod::RFID, RFID_LABEL,
+	 constructESPinner<ESPinner_RFID>, nullptr, 0, RFID_UI,
+	 RFID_MODESELECTOR_LABEL, false},
+#endif
+#if ESPALLON_MOD_STEPPER
+	{ESPINNER_STEPPER_JSONCONFIG, ESPinner_Mod::Stepper, STEPPER_LABEL,
+	 constructESPinner<ESPinner_Stepper>, STEPPER_PIN_FIELDS,
+	 pinFieldCount(STEPPER_PIN_FIELDS), Stepper_UI,
+	 STEPPER_MODESELECTOR_LABEL, false},
+#endif
+#if ESPALLON_MOD_TFT
+	{ESPINNER_TFT_JSONCONFIG, ESPinner_Mod::TFT, TFT_LABEL,
+	 constructESPinner<ESPinner_TFT>, nullptr, 0, TFT_UI,
+	 TFT_MODESELECTOR_LABEL, false},
+#endif
+};
+
+constexpr size_t ESPINNER_DESCRIPTORS_SIZE =
+	sizeof(ESPinnerDescriptors) / sizeof(ESPinnerDescriptors[0]);
+
+constexpr int descriptorTagCompare(const char *a, const char *b) {
+	return (*a != *b || *a == '\0') ? (*a - *b)
+									: descriptorTagCompare(a + 1, b + 1);
+}
+
+constexpr bool descriptorsSortedFrom(size_t i) {
+	return (i + 1 >= ESPINNER_DESCRIPTORS_SIZE)
+			   ? true
+			   : (descriptorTagCompare(ESPinnerDescriptors[i].tag,
+									   ESPinnerDescriptors[i + 1].tag) < 0 &&
+				  descriptorsSortedFrom(i + 1));
+}
+
+static_assert(descriptorsSortedFrom(0),
+			  "ESPinnerDescriptors must be sorted by tag");
+
+/**
+ * Find a module descriptor by JSON tag (binary search)
+ * @param tag ESPinner_Mod value from the JSON config
+ * @return Descriptor or nullptr if the module is unknown or not built
+ */
+const ESPinner_Descriptor *findDescriptorByTag(const char *tag) {
+	if (tag == nullptr) {
+		return nullptr;
+	}
+	size_t low = 0;
+	size_t high = ESPINNER_DESCRIPTORS_SIZE;
+	while (low < high) {
+		size_t mid = (low + high) / 2;
+		int cmp = strcmp(ESPinnerDescriptors[mid].tag, tag);
+		if (cmp == 0) {
+			return &ESPinnerDescriptors[mid];
+		}
+		if (cmp < 0) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * Find a module descriptor by selector label
+ * @param label Module label as shown in the ESPinner type selector
+ * @return Descriptor or nullptr if not found
+ */
+const ESPinner_Descriptor *findDescriptorByLabel(const char *label) {
+	for (const ESPinner_Descriptor &descriptor : ESPinnerDescriptors) {
+		if (strcmp(descriptor.label, label) == 0) {
+			return &descriptor;
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * Find a module descriptor by module type
+ * @param mod Module type enumeration
+ * @return Descriptor or nullptr if not found
+ */
+const ESPinner_Descriptor *findDescriptorByMod(ESPinner_Mod mod) {
+	for (const ESPinner_Descriptor &descriptor : ESPinnerDescriptors) {
+		if (descriptor.mod == mod) {
+			return &descriptor;
+		}
+	}
+	return nullptr;
+}
+
+#endif
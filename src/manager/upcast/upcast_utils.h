@@ -2,6 +2,7 @@
 #define _ESPINNER_UPCAST_UTILS_H
 
 #include "../../controllers/ESPinner.h"
+#include "ESPinner_Descriptors.h"
 
 // Compatibility layer for C++11 - provides make_unique if not available
 #if __cplusplus < 201402L
@@ -23,52 +24,16 @@ unique_ptr<T> make_unique(Args &&...args) {
 
 /**
  * Factory method implementation for creating ESPinner instances
- * Creates specific ESPinner types based on string identifier
- * @param type String identifier for the ESPinner type
+ * Looks the type up in the module descriptor table
+ * @param type JSON tag of the ESPinner type
  * @return Unique pointer to the created ESPinner instance
  */
 std::unique_ptr<ESPinner> ESPinner::create(const String &type) {
-	if (type == "ESPINNER_GPIO") {
-		auto ptr = std::make_unique<ESPinner_GPIO>();
-		return std::unique_ptr<ESPinner>(
-			static_cast<ESPinner *>(ptr.release()));
+	const ESPinner_Descriptor *descriptor = findDescriptorByTag(type.c_str());
+	if (descriptor == nullptr) {
+		return nullptr; // Unknown type or module not built
 	}
-	if (type == "ESPINNER_ENCODER") {
-		auto ptr = std::make_unique<ESPinner_Encoder>();
-		return std::unique_ptr<ESPinner>(
-			static_cast<ESPinner *>(ptr.release()));
-	}
-	if (type == "ESPINNER_DC") {
-		auto ptr = std::make_unique<ESPinner_DC>();
-		return std::unique_ptr<ESPinner>(
-			static_cast<ESPinner *>(ptr.release()));
-	}
-	if (type == "ESPINNER_MPU") {
-		auto ptr = std::make_unique<ESPinner_MPU>();
-		return std::unique_ptr<ESPinner>(
-			static_cast<ESPinner *>(ptr.release()));
-	}
-	if (type == "ESPINNER_NEOPIXEL") {
-		auto ptr = std::make_unique<ESPinner_Neopixel>();
-		return std::unique_ptr<ESPinner>(
-			static_cast<ESPinner *>(ptr.release()));
-	}
-	if (type == "ESPINNER_STEPPER") {
-		auto ptr = std::make_unique<ESPinner_Stepper>();
-		return std::unique_ptr<ESPinner>(
-			static_cast<ESPinner *>(ptr.release()));
-	}
-	if (type == "ESPINNER_RFID") {
-		auto ptr = std::make_unique<ESPinner_RFID>();
-		return std::unique_ptr<ESPinner>(
-			static_cast<ESPinner *>(ptr.release()));
-	}
-	if (type == "ESPINNER_LCD") {
-		auto ptr = std::make_unique<ESPinner_LCD>();
-		return std::unique_ptr<ESPinner>(
-			static_cast<ESPinner *>(ptr.release()));
-	}
-	return nullptr; // Return nullptr if type not found
+	return descriptor->construct();
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,210 @@
+#ifndef _ESPALLON_BOARD_CAPABILITIES_H
+#define _ESPALLON_BOARD_CAPABILITIES_H
+
+#include <stdint.h>
+
+#if defined(ESP8266)
+#include <pgmspace.h>
+#define BOARD_CAPS_STORAGE PROGMEM
+#define BOARD_CAPS_READ(address) pgm_read_word(address)
+#else
+// ESP32 keeps const data in flash already
+#define BOARD_CAPS_STORAGE
+#define BOARD_CAPS_READ(address) (*(address))
+#endif
+
+/** Capability flags of a GPIO on the selected chip, combined in a uint16_t */
+#define BOARD_CAP_EXISTS 0x0001		// Bonded out GPIO of the chip
+#define BOARD_CAP_OUTPUT 0x0002		// Can drive an output
+#define BOARD_CAP_INPUT_ONLY 0x0004 // No output driver
+#define BOARD_CAP_ADC1 0x0008
+#define BOARD_CAP_ADC2 0x0010 // Not usable while WiFi is on (ESP32)
+#define BOARD_CAP_TOUCH 0x0020
+#define BOARD_CAP_STRAPPING 0x0040 // Sampled at reset, boot mode may change
+#define BOARD_CAP_RTC 0x0080	   // RTC domain, wakes from deep sleep
+#define BOARD_CAP_PWM 0x0100	   // LEDC / PWM capable
+#define BOARD_CAP_DAC 0x0200
+#define BOARD_CAP_FLASH 0x0400	 // Wired to the SPI flash, never usable
+#define BOARD_CAP_USB 0x0800	 // Native USB D-/D+
+#define BOARD_CAP_ONBOARD 0x1000 // Wired to a peripheral of the board
+
+/**
+ * Pin sets are 64 bit masks indexed by GPIO, built at compile time
+ */
+constexpr uint64_t pinMask() { return 0; }
+
+template <typename... Pins>
+constexpr uint64_t pinMask(uint8_t pin, Pins... rest) {
+	return (1ULL << pin) | pinMask(rest...);
+}
+
+constexpr uint64_t pinRange(uint8_t first, uint8_t last) {
+	return first > last ? 0 : (1ULL << first) | pinRange(first + 1, last);
+}
+
+constexpr uint16_t pinFlag(uint64_t mask, uint8_t gpio, uint16_t flag) {
+	return gpio < 64 && ((mask >> gpio) & 1) ? flag : 0;
+}
+
+/**
+ * Board pin sets, from the chip datasheets. A board variant derives from its
+ * chip and overrides the sets it changes, usually ONBOARD.
+ */
+struct ESP32Pins {
+	static constexpr const char *name() { return "ESP32"; }
+	static constexpr uint8_t NUM_GPIO = 40;
+	static constexpr uint64_t EXISTS = pinRange(0, 19) | pinRange(21, 23) |
+									   pinRange(25, 27) | pinRange(32, 39);
+	static constexpr uint64_t INPUT_ONLY = pinRange(34, 39);
+	static constexpr uint64_t ADC1 = pinRange(32, 39);
+	static constexpr uint64_t ADC2 =
+		pinMask(0, 2, 4, 12, 13, 14, 15, 25, 26, 27);
+	static constexpr uint64_t TOUCH =
+		pinMask(0, 2, 4, 12, 13, 14, 15, 27, 32, 33);
+	static constexpr uint64_t STRAPPING = pinMask(0, 2, 5, 12, 15);
+	static constexpr uint64_t RTC = pinMask(0, 2, 4, 12, 13, 14, 15, 25, 26,
+											27) |
+									pinRange(32, 39);
+	static constexpr uint64_t DAC = pinMask(25, 26);
+	static constexpr uint64_t FLASH = pinRange(6, 11);
+	static constexpr uint64_t USB = 0;
+	static constexpr uint64_t ONBOARD = 0;
+	static constexpr uint64_t PWM = EXISTS & ~INPUT_ONLY & ~FLASH;
+};
+
+/** M5Stack Core: ESP32 with LCD, SD card, buttons, speaker and I2C wired */
+struct M5StackCorePins : ESP32Pins {
+	static constexpr const char *name() { return "M5Stack Core"; }
+	static constexpr uint64_t ONBOARD =
+		pinMask(4, 14, 18, 19, 21, 22, 23, 25, 27, 32, 33, 37, 38, 39);
+};
+
+struct ESP32S3Pins {
+	static constexpr const char *name() { return "ESP32-S3"; }
+	static constexpr uint8_t NUM_GPIO = 49;
+	static constexpr uint64_t EXISTS = pinRange(0, 21) | pinRange(26, 48);
+	static constexpr uint64_t INPUT_ONLY = 0;
+	static constexpr uint64_t ADC1 = pinRange(1, 10);
+	static constexpr uint64_t ADC2 = pinRange(11, 20);
+	static constexpr uint64_t TOUCH = pinRange(1, 14);
+	static constexpr uint64_t STRAPPING = pinMask(0, 3, 45, 46);
+	static constexpr uint64_t RTC = pinRange(0, 21);
+	static constexpr uint64_t DAC = 0;
+	static constexpr uint64_t FLASH = pinRange(26, 32);
+	static constexpr uint64_t USB = pinMask(19, 20);
+	static constexpr uint64_t ONBOARD = 0;
+	static constexpr uint64_t PWM = EXISTS & ~FLASH;
+};
+
+struct ESP32C3Pins {
+	static constexpr const char *name() { return "ESP32-C3"; }
+	static constexpr uint8_t NUM_GPIO = 22;
+	static constexpr uint64_t EXISTS = pinRange(0, 21);
+	static constexpr uint64_t INPUT_ONLY = 0;
+	static constexpr uint64_t ADC1 = pinRange(0, 4);
+	static constexpr uint64_t ADC2 = pinMask(5);
+	static constexpr uint64_t TOUCH = 0;
+	static constexpr uint64_t STRAPPING = pinMask(2, 8, 9);
+	static constexpr uint64_t RTC = pinRange(0, 5);
+	static constexpr uint64_t DAC = 0;
+	static constexpr uint64_t FLASH = pinRange(12, 17);
+	static constexpr uint64_t USB = pinMask(18, 19);
+	static constexpr uint64_t ONBOARD = 0;
+	static constexpr uint64_t PWM = EXISTS & ~FLASH;
+};
+
+/** ESP8266: A0 is not a GPIO, GPIO16 has no PWM and wakes from deep sleep */
+struct ESP8266Pins {
+	static constexpr const char *name() { return "ESP8266"; }
+	static constexpr uint8_t NUM_GPIO = 17;
+	static constexpr uint64_t EXISTS = pinRange(0, 16);
+	static constexpr uint64_t INPUT_ONLY = 0;
+	static constexpr uint64_t ADC1 = 0;
+	static constexpr uint64_t ADC2 = 0;
+	static constexpr uint64_t TOUCH = 0;
+	static constexpr uint64_t STRAPPING = pinMask(0, 2, 15);
+	static constexpr uint64_t RTC = pinMask(16);
+	static constexpr uint64_t DAC = 0;
+	static constexpr uint64_t FLASH = pinRange(6, 11);
+	static constexpr uint64_t USB = 0;
+	static constexpr uint64_t ONBOARD = 0;
+	static constexpr uint64_t PWM = pinRange(0, 15) & ~FLASH;
+};
+
+/**
+ * Capability flags of a GPIO, evaluated at compile time
+ */
+template <typename Pins> constexpr uint16_t pinCapabilities(uint8_t gpio) {
+	return pinFlag(Pins::EXISTS, gpio, BOARD_CAP_EXISTS) |
+		   pinFlag(Pins::EXISTS & ~Pins::INPUT_ONLY & ~Pins::FLASH, gpio,
+				   BOARD_CAP_OUTPUT) |
+		   pinFlag(Pins::INPUT_ONLY, gpio, BOARD_CAP_INPUT_ONLY) |
+		   pinFlag(Pins::ADC1, gpio, BOARD_CAP_ADC1) |
+		   pinFlag(Pins::ADC2, gpio, BOARD_CAP_ADC2) |
+		   pinFlag(Pins::TOUCH, gpio, BOARD_CAP_TOUCH) |
+		   pinFlag(Pins::STRAPPING, gpio, BOARD_CAP_STRAPPING) |
+		   pinFlag(Pins::RTC, gpio, BOARD_CAP_RTC) |
+		   pinFlag(Pins::PWM, gpio, BOARD_CAP_PWM) |
+		   pinFlag(Pins::DAC, gpio, BOARD_CAP_DAC) |
+		   pinFlag(Pins::FLASH, gpio, BOARD_CAP_FLASH) |
+		   pinFlag(Pins::USB, gpio, BOARD_CAP_USB) |
+		   pinFlag(Pins::ONBOARD, gpio, BOARD_CAP_ONBOARD);
+}
+
+/**
+ * Board selection. Host builds use the ESP32 tables.
+ */
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+typedef ESP32S3Pins BoardPins;
+#elif defined(CONFIG_IDF_TARGET_ESP32C3)
+typedef ESP32C3Pins BoardPins;
+#elif defined(ARDUINO_M5Stack_Core_ESP32)
+typedef M5StackCorePins BoardPins;
+#elif defined(ESP8266)
+typedef ESP8266Pins BoardPins;
+#else
+typedef ESP32Pins BoardPins;
+#endif
+
+#define BOARD_CAPS_8(P, b)                                                     \
+	pinCapabilities<P>(b), pinCapabilities<P>(b + 1),                          \
+		pinCapabilities<P>(b + 2), pinCapabilities<P>(b + 3),                  \
+		pinCapabilities<P>(b + 4), pinCapabilities<P>(b + 5),                  \
+		pinCapabilities<P>(b + 6), pinCapabilities<P>(b + 7)
+#define BOARD_CAPS_64(P, b)                                                    \
+	BOARD_CAPS_8(P, b), BOARD_CAPS_8(P, b + 8), BOARD_CAPS_8(P, b + 16),       \
+		BOARD_CAPS_8(P, b + 24), BOARD_CAPS_8(P, b + 32),                      \
+		BOARD_CAPS_8(P, b + 40), BOARD_CAPS_8(P, b + 48),                      \
+		BOARD_CAPS_8(P, b + 56)
+
+/**
+ * Capabilities of the selected board for every uint8_t GPIO value, so a
+ * lookup is a single indexed read with no range check. The table is
+ * constant initialized and lives in flash.
+ */
+const uint16_t boardCapabilityTable[256] BOARD_CAPS_STORAGE = {
+	BOARD_CAPS_64(BoardPins, 0), BOARD_CAPS_64(BoardPins, 64),
+	BOARD_CAPS_64(BoardPins, 128), BOARD_CAPS_64(BoardPins, 192)};
+
+inline uint16_t boardCapabilities(uint8_t gpio) {
+	return BOARD_CAPS_READ(&boardCapabilityTable[gpio]);
+}
+
+inline bool boardPinHas(uint8_t gpio, uint16_t flags) {
+	return (boardCapabilities(gpio) & flags) == flags;
+}
+
+/**
+ * GPIO that can be assigned to an ESPinner: present and not wired to flash
+ */
+inline bool boardPinUsable(uint8_t gpio) {
+	return (boardCapabilities(gpio) & (BOARD_CAP_EXISTS | BOARD_CAP_FLASH)) ==
+		   BOARD_CAP_EXISTS;
+}
+
+static_assert(pinCapabilities<ESP32Pins>(6) & BOARD_CAP_FLASH,
+			  "ESP32 flash pins");
+static_assert(!(pinCapabilities<ESP32Pins>(34) & BOARD_CAP_OUTPUT),
+			  "ESP32 input only pins");
+
+#endif
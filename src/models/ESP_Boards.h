@@ -1,6 +1,7 @@
 #ifndef _ESPALLON_BOARDS_H
 #define _ESPALLON_BOARDS_H
 
+#include "BoardCapabilities.h"
 #include "PinManager.h"
 
 #if defined(ESP32)
@@ -9,7 +10,7 @@
  * Defines pin layout and capabilities for ESP32 boards
  */
 struct ESP_BoardConf {
-	static constexpr size_t NUM_PINS = 40; // Total number of pins
+	static constexpr size_t NUM_PINS = BoardPins::NUM_GPIO; // Total pins
 	static ESP_PinMode PINOUT[NUM_PINS];   // Pin configuration array
 #if DEBUG
 	static constexpr size_t INITIAL_PINS = 7; // Debug mode initial pins
@@ -42,7 +43,7 @@ ESP_PinMode ESP_BoardConf::PINOUT[ESP_BoardConf::NUM_PINS] = {
  * Defines pin layout and capabilities for ESP8266 boards
  */
 struct ESP_BoardConf {
-	static constexpr size_t NUM_PINS = 17; // Total number of pins
+	static constexpr size_t NUM_PINS = BoardPins::NUM_GPIO; // Total pins
 	static ESP_PinMode PINOUT[NUM_PINS];   // Pin configuration array
 #if DEBUG
 	static constexpr size_t INITIAL_PINS = 7; // Debug mode initial pins
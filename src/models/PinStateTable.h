@@ -0,0 +1,211 @@
+#ifndef _ESPALLON_PINSTATETABLE_H
+#define _ESPALLON_PINSTATETABLE_H
+
+#include <bitset>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/** Capability flags of a GPIO, combined in a uint8_t */
+#define PIN_CAP_CONFIGURED 0x01 // Listed in the board PINOUT
+#define PIN_CAP_INPUT 0x02
+#define PIN_CAP_OUTPUT 0x04
+#define PIN_CAP_DEEPSLEEP 0x08
+#define PIN_CAP_WIFI 0x10 // Usable while WiFi is on
+#define PIN_CAP_TOUCH 0x20
+
+/**
+ * Fixed size state of every GPIO of a board, indexed by pin number
+ *
+ * Replaces the pin -> UI reference map of ESPAllOnPinManager: attached,
+ * broken and reserved pins are bitsets, capabilities one byte per pin and
+ * the UI control bound to each pin a dense array (0 = none). Every query is
+ * O(1) and nothing is allocated after construction. Pins out of range read
+ * as not configured and unbound; writes to them are ignored.
+ *
+ * A control selects one pin, so bindings are one to one and indexed both
+ * ways: the reverse control -> pin index is an open addressed table with
+ * linear probing, at least twice as large as the pin count, so full 16 bit
+ * control ids resolve in O(1) without a 64K array. ESPUI hands out ids
+ * sequentially, which spreads them over the slots without hashing.
+ */
+template <size_t N> class PinStateTable {
+	static_assert(N > 0 && N < 255, "pins are indexed as uint8_t");
+
+	static constexpr size_t slotsFor(size_t pins, size_t slots = 1) {
+		return slots >= 2 * pins ? slots : slotsFor(pins, slots * 2);
+	}
+	static constexpr size_t REF_SLOTS = slotsFor(N);
+	static constexpr size_t REF_MASK = REF_SLOTS - 1;
+
+  private:
+	std::bitset<N> attachedPins;
+	std::bitset<N> brokenPins;
+	std::bitset<N> reservedPins;
+	std::bitset<N> boundPins; // Pins with a UI control reference
+	uint8_t capabilities[N];
+	uint16_t controlRefs[N];
+	uint16_t slotRefs[REF_SLOTS]; // 0 = empty slot
+	uint8_t slotPins[REF_SLOTS];
+	uint32_t changes = 0;
+
+	int findSlot(uint16_t ref) const {
+		for (size_t i = ref & REF_MASK;; i = (i + 1) & REF_MASK) {
+			if (slotRefs[i] == ref) {
+				return i;
+			}
+			if (slotRefs[i] == 0) {
+				return -1;
+			}
+		}
+	}
+
+	void insertRef(uint16_t ref, uint8_t pin) {
+		size_t i = ref & REF_MASK;
+		while (slotRefs[i] != 0) {
+			i = (i + 1) & REF_MASK;
+		}
+		slotRefs[i] = ref;
+		slotPins[i] = pin;
+	}
+
+	/**
+	 * Empties a slot, shifting back later entries of the probe sequence so
+	 * lookups never stop at the hole
+	 */
+	void eraseSlot(size_t hole) {
+		for (size_t i = (hole + 1) & REF_MASK; slotRefs[i] != 0;
+			 i = (i + 1) & REF_MASK) {
+			size_t home = slotRefs[i] & REF_MASK;
+			// Entries whose home lies cyclically in (hole, i] stay put
+			bool stays = hole <= i ? (home > hole && home <= i)
+								   : (home > hole || home <= i);
+			if (!stays) {
+				slotRefs[hole] = slotRefs[i];
+				slotPins[hole] = slotPins[i];
+				hole = i;
+			}
+		}
+		slotRefs[hole] = 0;
+	}
+
+  public:
+	PinStateTable() { clear(); }
+
+	static constexpr size_t capacity() { return N; }
+	static bool inRange(int pin) { return pin >= 0 && pin < (int)N; }
+
+	void clear() {
+		changes++;
+		attachedPins.reset();
+		brokenPins.reset();
+		reservedPins.reset();
+		boundPins.reset();
+		memset(capabilities, 0, sizeof(capabilities));
+		memset(controlRefs, 0, sizeof(controlRefs));
+		memset(slotRefs, 0, sizeof(slotRefs));
+		memset(slotPins, 0, sizeof(slotPins));
+	}
+
+	void setAttached(int pin, bool attached) {
+		if (inRange(pin) && attachedPins[pin] != attached) {
+			attachedPins.set(pin, attached);
+			changes++;
+		}
+	}
+	bool isAttached(int pin) const { return inRange(pin) && attachedPins[pin]; }
+
+	void setBroken(int pin, bool broken) {
+		if (inRange(pin) && brokenPins[pin] != broken) {
+			brokenPins.set(pin, broken);
+			changes++;
+		}
+	}
+	bool isBroken(int pin) const { return inRange(pin) && brokenPins[pin]; }
+
+	void setReserved(int pin, bool reserved) {
+		if (inRange(pin) && reservedPins[pin] != reserved) {
+			reservedPins.set(pin, reserved);
+			changes++;
+		}
+	}
+	bool isReserved(int pin) const { return inRange(pin) && reservedPins[pin]; }
+
+	/**
+	 * Broken and reserved pins can never be assigned
+	 */
+	bool isBlocked(int pin) const {
+		return inRange(pin) && (brokenPins[pin] || reservedPins[pin]);
+	}
+
+	void setCapabilities(int pin, uint8_t flags) {
+		if (inRange(pin) && capabilities[pin] != flags) {
+			capabilities[pin] = flags;
+			changes++;
+		}
+	}
+	uint8_t getCapabilities(int pin) const {
+		return inRange(pin) ? capabilities[pin] : 0;
+	}
+	bool hasCapability(int pin, uint8_t flag) const {
+		return (getCapabilities(pin) & flag) == flag;
+	}
+
+	/**
+	 * Binds a UI control to a pin, 0 unbinds it. The previous control of the
+	 * pin and the previous pin of the control are released.
+	 */
+	void setControlRef(int pin, uint16_t ref) {
+		if (!inRange(pin) || controlRefs[pin] == ref) {
+			return;
+		}
+		int previous = controlRefs[pin] != 0 ? findSlot(controlRefs[pin]) : -1;
+		if (previous >= 0) {
+			eraseSlot(previous);
+		}
+		if (ref != 0) {
+			int slot = findSlot(ref);
+			if (slot >= 0) {
+				controlRefs[slotPins[slot]] = 0;
+				boundPins.reset(slotPins[slot]);
+				eraseSlot(slot);
+			}
+			insertRef(ref, pin);
+		}
+		controlRefs[pin] = ref;
+		boundPins.set(pin, ref != 0);
+		changes++;
+	}
+	uint16_t getControlRef(int pin) const {
+		return inRange(pin) ? controlRefs[pin] : 0;
+	}
+	void clearControlRef(int pin) { setControlRef(pin, 0); }
+
+	/**
+	 * Pin bound to a UI control
+	 * @return Pin number, -1 if the control is not bound
+	 */
+	int getControlPin(uint16_t ref) const {
+		if (ref == 0) {
+			return -1;
+		}
+		int slot = findSlot(ref);
+		return slot < 0 ? -1 : slotPins[slot];
+	}
+
+	/**
+	 * Generation counter, incremented by every change of the table. Equal
+	 * generations mean an identical state, so snapshots can be cached.
+	 */
+	uint32_t generation() const { return changes; }
+
+	size_t attachedCount() const { return attachedPins.count(); }
+
+	/**
+	 * Pins that are blocked or bound to a UI control; the entry count of the
+	 * former pin map
+	 */
+	size_t size() const { return (brokenPins | reservedPins | boundPins).count(); }
+};
+
+#endif
@@ -5,15 +5,16 @@
 #include <ESPUI.h>
 
 enum class DCPin { PinA, PinB };
-class ESPinner_DC : public ESPinner {
+class ESPinner_DC : public ESPinner, public ICheckpointProvider {
   public:
 	uint8_t gpioA, gpioB;
-	bool direction;
-	bool running;
-	uint8_t speed;
+	bool direction = false;
+	bool running = false;
+	uint8_t speed = 0;
 
 	ESPinner_DC(ESPinner_Mod espinner_mod) : ESPinner(espinner_mod) {}
 	ESPinner_DC() : ESPinner(ESPinner_Mod::DC) {}
+	~ESPinner_DC() { getCheckpointService().remove(this); }
 
 	void setup() override { DUMPSLN("Iniciacion configuración de DC..."); }
 	void update() override { DUMPSLN("Update configuración de DC..."); }
@@ -36,6 +37,29 @@ class ESPinner_DC : public ESPinner {
 	void setGPIOB(uint8_t gpio_Bpin) { gpioB = gpio_Bpin; }
 	uint8_t getGPIOB() { return getGPIO(DCPin::PinB); }
 
+	// Checkpointed runtime state: run flag, direction and speed
+	ICheckpointProvider *getCheckpointProvider() override { return this; }
+	const char *checkpointID() override { return ID.c_str(); }
+	uint8_t checkpointChannels(const CheckpointChannel *&channels) override {
+		static const CheckpointChannel dcChannels[] = {
+			{"run", 0}, {"dir", 0}, {"speed", DC_CHECKPOINT_SPEED}};
+		channels = dcChannels;
+		return 3;
+	}
+	bool sampleCheckpoint(uint8_t channel, int32_t &value) override {
+		value = channel == 0 ? running : channel == 1 ? direction : speed;
+		return true;
+	}
+	void restoreCheckpoint(uint8_t channel, int32_t value) override {
+		if (channel == 0) {
+			running = value != 0;
+		} else if (channel == 1) {
+			direction = value != 0;
+		} else {
+			speed = static_cast<uint8_t>(value);
+		}
+	}
+
 	ESP_PinMode getPinModeConf(DCPin pinType) {
 		ESP_PinMode pinMode = {getGPIO(pinType), OutputPin(true),
 							   PinType::BusPWM};
@@ -41,6 +41,8 @@ void DC_action(uint16_t parentRef) {
 		}
 	}
 	// Create ESpinner with Configuration
+	espinnerDC->setPanelRef(parentRef);
+	getCheckpointService().add(espinnerDC.get());
 	ESPinner_Manager::getInstance().push(std::move(espinnerDC));
 	ESPinner_Manager::getInstance().saveESPinnersInStorage();
 }
@@ -239,6 +241,7 @@ void ESPinner_DC::implement() {
 		ControlType::Text, ESPINNERID_LABEL, ESPinner_DC::getID(),
 		ControlColor::Wetasphalt, parentRef, DCSelector_callback);
 	ESPUI.getControl(DCPIN_selector)->enabled = false;
+	setPanelRef(DCPIN_selector);
 	addElementWithParent(elementToParentMap, DCPIN_selector, DCPIN_selector);
 
 	GUI_setLabel(DCPIN_selector, DC_PINA_SELECT_LABEL, DC_PINA_SELECT_VALUE,
@@ -269,6 +272,10 @@ void ESPinner_DC::implement() {
 		ESP_PinMode(ESPinner_DC::getGPIOB(), OutputPin(), PinType::BusPWM);
 	ESPAllOnPinManager::getInstance().attach(pinModelB);
 
+	// Resume the last checkpointed run state
+	getCheckpointService().add(this);
+	getCheckpointService().restore(this);
+
 	// ------- Create Controllers ----------- //
 	DC_Controller(ESPinner_DC::getID(), DCPIN_selector);
 }
@@ -36,4 +36,10 @@ class ESPinner_Encoder : public ESPinner {
 	};
 };
 
+/**
+ * Creates the Encoder configuration UI
+ * @param Encoder_ptr Parent UI element reference
+ */
+void Encoder_UI(uint16_t Encoder_ptr);
+
 #endif
\ No newline at end of file
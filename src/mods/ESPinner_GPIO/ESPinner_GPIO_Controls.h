@@ -49,6 +49,7 @@ void gpio_action(uint16_t parentRef) {
 	}
 	// Create ESpinner with Configuration
 
+	espinnerGPIO->setPanelRef(parentRef);
 	ESPinner_Manager::getInstance().push(std::move(espinnerGPIO));
 
 	ESPinner_Manager::getInstance().saveESPinnersInStorage();
@@ -225,6 +226,7 @@ void ESPinner_GPIO::implement() {
 		ControlType::Text, ESPINNERID_LABEL, ESPinner_GPIO::getID(),
 		ControlColor::Wetasphalt, parentRef, GPIOSelector_callback);
 	ESPUI.getControl(GPIOPIN_selector)->enabled = false;
+	setPanelRef(GPIOPIN_selector);
 	addElementWithParent(elementToParentMap, GPIOPIN_selector,
 						 GPIOPIN_selector);
 
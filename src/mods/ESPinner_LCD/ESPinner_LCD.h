@@ -36,4 +36,10 @@ class ESPinner_LCD : public ESPinner {
 	};
 };
 
+/**
+ * Creates the LCD configuration UI
+ * @param LCD_ptr Parent UI element reference
+ */
+void LCD_UI(uint16_t LCD_ptr);
+
 #endif
\ No newline at end of file
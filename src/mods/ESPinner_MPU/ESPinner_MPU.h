@@ -36,4 +36,10 @@ class ESPinner_MPU : public ESPinner {
 	};
 };
 
+/**
+ * Creates the MPU configuration UI
+ * @param MPU_ptr Parent UI element reference
+ */
+void MPU_UI(uint16_t MPU_ptr);
+
 #endif
\ No newline at end of file
@@ -4,10 +4,13 @@
 #include "../../controllers/ESPAllOnPinManager.h"
 #include "NeopixelRunner.h"
 
+#include "../../controllers/WheelTicker.h"
+
 #include <ESPUI.h>
-#include <TickerFree.h>
 
-class ESPinner_Neopixel : public ESPinner, public INeopixelRunnable {
+class ESPinner_Neopixel : public ESPinner,
+						  public INeopixelRunnable,
+						  public ICheckpointProvider {
   private:
 	bool _enabled = true;
 	bool _rainbowMode = false;
@@ -37,19 +40,27 @@ class ESPinner_Neopixel : public ESPinner, public INeopixelRunnable {
   public:
 	ESPinner_Neopixel()
 		: ESPinner(ESPinner_Mod::NeoPixel),
-		  neopixelTicker([this]() { this->clearLeds(); }, NEOPIXEL_INTERVAL_MS,
-						 1, MILLIS) {
+		  neopixelTicker(combinedCallback([this]() { this->clearLeds(); }),
+						 NEOPIXEL_INTERVAL_MS, 1, MILLIS) {
 		this->setup();
 	}
 
 	ESPinner_Neopixel(int gpioPin, int numPixels)
 		: ESPinner(ESPinner_Mod::NeoPixel),
 		  strip(numPixels, gpioPin, NEO_GRB + NEO_KHZ800),
-		  neopixelTicker([this]() { this->clearLeds(); }, NEOPIXEL_INTERVAL_MS,
-						 1, MILLIS) {
+		  neopixelTicker(combinedCallback([this]() { this->clearLeds(); }),
+						 NEOPIXEL_INTERVAL_MS, 1, MILLIS) {
 		this->setup();
 	}
 
+	/**
+	 * Leave the NeopixelRunner before the ESPinner memory is released
+	 */
+	~ESPinner_Neopixel() {
+		NeopixelRunner::getInstance().unregisterRunnable(runnerHandle);
+		getCheckpointService().remove(this);
+	}
+
 	ESP_PinMode getPinModeConf() {
 		ESP_PinMode pinMode = {this->getGPIO(), OutputPin(true),
 							   PinType::BusDigital};
@@ -98,11 +109,8 @@ class ESPinner_Neopixel : public ESPinner, public INeopixelRunnable {
 		strip.clear();
 		strip.show();
 	}
-	void run() override {
-		if (neopixelTicker.state() == status_t::RUNNING) {
-			neopixelTicker.update();
-		}
-	}
+	// Animation steps fire from the timer wheel, see combinedCallback()
+	void run() override {}
 	bool isActive() const override { return INeopixelRunnable::isEnabled(); }
 
 	/**
@@ -288,6 +296,28 @@ class ESPinner_Neopixel : public ESPinner, public INeopixelRunnable {
 	uint32_t getCurrentColor() const { return _currentColor; }
 	NEOPIXEL_ANIMATION getCurrentAnimation() const { return _currentAnimation; }
 
+	// Checkpointed runtime state: current color and animation
+	ICheckpointProvider *getCheckpointProvider() override { return this; }
+	const char *checkpointID() override { return ID.c_str(); }
+	uint8_t checkpointChannels(const CheckpointChannel *&channels) override {
+		static const CheckpointChannel neopixelChannels[] = {{"color", 0},
+															 {"anim", 0}};
+		channels = neopixelChannels;
+		return 2;
+	}
+	bool sampleCheckpoint(uint8_t channel, int32_t &value) override {
+		value = channel == 0 ? static_cast<int32_t>(_currentColor)
+							 : static_cast<int32_t>(_currentAnimation);
+		return true;
+	}
+	void restoreCheckpoint(uint8_t channel, int32_t value) override {
+		if (channel == 0) {
+			setColor(static_cast<uint32_t>(value));
+		} else if (value >= SOLID && value <= CLEAR) {
+			setAnimation(static_cast<NEOPIXEL_ANIMATION>(value));
+		}
+	}
+
 	// Animation configuration getters/setters
 	void setLoopAnimation(bool loop) { _loopAnimation = loop; }
 	void setBounceAnimation(bool bounce) { _bounceAnimation = bounce; }
@@ -305,12 +335,12 @@ class ESPinner_Neopixel : public ESPinner, public INeopixelRunnable {
 		// Set the ID for the runnable interface
 		// this->ID = id;
 
-		// Create shared_ptr without taking ownership of the object
-		// (no-op deleter since it's managed by ESPinner_Manager)
-		auto neopixelPtr = std::shared_ptr<INeopixelRunnable>(
-			this, [](INeopixelRunnable *) {});
-
-		return NeopixelRunner::getInstance().registerRunnable(neopixelPtr);
+		// Not owned, ESPinner_Manager keeps the ESPinner
+		if (runnerHandle < 0) {
+			runnerHandle = NeopixelRunner::getInstance().registerRunnable(
+				static_cast<INeopixelRunnable *>(this));
+		}
+		return runnerHandle >= 0;
 	}
 
 	JsonDocument serializeJSON() override {
@@ -340,7 +370,8 @@ class ESPinner_Neopixel : public ESPinner, public INeopixelRunnable {
 	}
 
   private:
-	TickerFree<> neopixelTicker;
+	WheelTicker neopixelTicker;
+	NeopixelRunner::Handle runnerHandle = -1; // -1 = not registered
 
 	// =============== ANIMATION METHODS ===============
 
@@ -564,6 +595,15 @@ class ESPinner_Neopixel : public ESPinner, public INeopixelRunnable {
 
 	CallbackType combinedCallback(CallbackType cb) {
 		return [this, cb]() {
+			// The runner skips inactive strips
+			if (!isActive()) {
+				return;
+			}
+#if LOOP_PROFILER_ENABLED
+			LoopProfiler::Scope scope(
+				&getLoopProfiler(),
+				NeopixelRunner::getInstance().getStage(runnerHandle));
+#endif
 			if (cb) {
 				cb();
 			}
@@ -572,4 +612,6 @@ class ESPinner_Neopixel : public ESPinner, public INeopixelRunnable {
 	}
 };
 
+void Neopixel_UI(uint16_t NP_ptr);
+
 #endif
\ No newline at end of file
@@ -34,6 +34,8 @@ void Neopixel_action(uint16_t parentRef) {
 		}
 	}
 	// Create ESpinner with Configuration
+	espinnerNeopixel->setPanelRef(parentRef);
+	getCheckpointService().add(espinnerNeopixel.get());
 	ESPinner_Manager::getInstance().push(std::move(espinnerNeopixel));
 	ESPinner_Manager::getInstance().saveESPinnersInStorage();
 }
@@ -53,12 +55,10 @@ void Neopixel_updateState_callback(Control *sender, int type) {
 	bool isAnimation_Ref =
 		(String(sender->label) == NEOPIXEL_ANIMATION_SELECTOR_LABEL);
 
-	ESPinner *espinner = ESPinner_Manager::getInstance().findESPinnerById(
-		ESPUI.getControl(parentRef)->value);
+	ESPinner_Neopixel *neopixelPtr =
+		ESPinner_Manager::getInstance().findNeopixelByControllerRef(parentRef);
 
-	if (espinner && espinner->getType() == ESPinner_Mod::NeoPixel) {
-		ESPinner_Neopixel *neopixelPtr =
-			static_cast<ESPinner_Neopixel *>(espinner);
+	if (neopixelPtr) {
 
 		if (isEN_Ref) {
 			neopixelPtr->enable(sender->value.toInt() == 1);
@@ -201,6 +201,8 @@ void Neopixel_Controller(String ID_LABEL, uint16_t parentRef) {
 
 	ESPinner_Manager::getInstance().addESPinnerControllerMapping(
 		ID_LABEL, NEOPIXEL_Controller_ID);
+	ESPinner_Manager::getInstance().bindControllerHandle(
+		NEOPIXEL_Controller_ID, ID_LABEL);
 
 	ESPinner_Manager::getInstance().addUIRelation(parentRef,
 												  NEOPIXEL_Controller_ID);
@@ -241,11 +243,9 @@ void Neopixel_color_callback(Control *sender, int type) {
 	uint16_t parentRef = getParentId(elementToParentMap, sender->id);
 	String neopixelId = ESPUI.getControl(parentRef)->value;
 
-	auto neopixel = NeopixelRunner::getInstance().getRunnable(neopixelId);
-	if (neopixel) {
-		// Cast to ESPinner_Neopixel to access setColor method
-		ESPinner_Neopixel *neopixelPtr =
-			static_cast<ESPinner_Neopixel *>(neopixel.get());
+	ESPinner_Neopixel *neopixelPtr =
+		ESPinner_Manager::getInstance().findNeopixelById(neopixelId);
+	if (neopixelPtr) {
 		// Convert hex color string to uint32_t
 		uint32_t color = strtoul(sender->value.c_str(), NULL, 16);
 		neopixelPtr->setColor(color);
@@ -297,13 +297,11 @@ void saveNeopixel_callback(Control *sender, int type) {
 
 				// Get the NeoPixel instance that was just saved
 				String neopixelId = ESPUI.getControl(NeopixelIDRef)->value;
-				ESPinner *espinner =
-					ESPinner_Manager::getInstance().findESPinnerById(
+				ESPinner_Neopixel *neopixelPtr =
+					ESPinner_Manager::getInstance().findNeopixelById(
 						neopixelId);
 
-				if (espinner && espinner->getType() == ESPinner_Mod::NeoPixel) {
-					ESPinner_Neopixel *neopixelPtr =
-						static_cast<ESPinner_Neopixel *>(espinner);
+				if (neopixelPtr) {
 					// Register the NeoPixel with the runner using its ID
 					bool registered =
 						neopixelPtr->registerRunner(neopixelPtr->getID());
@@ -361,6 +359,7 @@ void ESPinner_Neopixel::implement() {
 		ControlColor::Wetasphalt, parentRef, NeopixelSelector_callback);
 
 	ESPUI.getControl(Neopixel_PIN_selector)->enabled = false;
+	setPanelRef(Neopixel_PIN_selector);
 	addElementWithParent(elementToParentMap, Neopixel_PIN_selector,
 						 Neopixel_PIN_selector);
 
@@ -390,6 +389,10 @@ void ESPinner_Neopixel::implement() {
 											OutputPin(), PinType::BusDigital);
 	ESPAllOnPinManager::getInstance().attach(NP_GPIO_Model);
 
+	// Resume the last checkpointed color and animation
+	getCheckpointService().add(this);
+	getCheckpointService().restore(this);
+
 	// ------- Create Controllers ----------- //
 	Neopixel_Controller(ESPinner_Neopixel::getID(), Neopixel_PIN_selector);
 }
@@ -1,9 +1,10 @@
 #ifndef _NEOPIXEL_RUNNER_H
 #define _NEOPIXEL_RUNNER_H
 
+#include "../../manager/LoopProfiler.h"
+#include "../../manager/RunnableTable.h"
+
 #include <Adafruit_NeoPixel.h>
-#include <memory>
-#include <vector>
 
 enum NEOPIXEL_ANIMATION {
 	SOLID = 0,
@@ -49,17 +50,32 @@ class INeopixelRunnable {
 };
 
 /**
- * Singleton class to manage multiple NeoPixel instances
- * and execute them using Ticker for non-blocking operation
+ * Singleton registry of the NeoPixel instances
+ *
+ * Animation steps fire from each strip's WheelTicker on the timer wheel,
+ * so nothing is dispatched from here: the registry hands out the handles
+ * and, with LOOP_PROFILER_ENABLED, the profiler stage "neopixel <handle>"
+ * each strip times its animation steps with.
  */
 class NeopixelRunner {
-  private:
+  public:
 	static constexpr size_t MAX_NEOPIXELS = 8; // Maximum number of NeoPixels
-	std::vector<std::shared_ptr<INeopixelRunnable>> _runnables;
+	typedef RunnableTable<INeopixelRunnable, MAX_NEOPIXELS>::Handle Handle;
+
+  private:
+	RunnableTable<INeopixelRunnable, MAX_NEOPIXELS> _runnables;
 	static NeopixelRunner *_instance;
-	bool _isRunning = false;
+#if LOOP_PROFILER_ENABLED
+	LoopProfiler::StageId _stages[MAX_NEOPIXELS];
+#endif
 
-	NeopixelRunner() { _runnables.reserve(MAX_NEOPIXELS); }
+	NeopixelRunner() {
+#if LOOP_PROFILER_ENABLED
+		for (LoopProfiler::StageId &stage : _stages) {
+			stage = -1;
+		}
+#endif
+	}
 
   public:
 	/**
@@ -74,45 +90,38 @@ class NeopixelRunner {
 
 	/**
 	 * Register a NeoPixel runnable object
-	 * @param runnable Shared pointer to the runnable object
-	 * @return True if registered successfully, false if array is full
+	 * @param runnable Runnable object, not owned
+	 * @return Handle to unregister and look up the profiler stage, -1 if
+	 * full
 	 */
-	bool registerRunnable(std::shared_ptr<INeopixelRunnable> runnable) {
-		if (_runnables.size() < MAX_NEOPIXELS) {
-			_runnables.push_back(runnable);
-			return true;
+	Handle registerRunnable(INeopixelRunnable *runnable) {
+		Handle handle = _runnables.add(runnable, false);
+#if LOOP_PROFILER_ENABLED
+		if (handle >= 0 && _stages[handle] < 0) {
+			char name[LoopProfiler::NAME_LENGTH];
+			snprintf(name, sizeof(name), "neopixel %u", (uint8_t)handle);
+			_stages[handle] = getLoopProfiler().stage(name);
 		}
-		return false;
+#endif
+		return handle;
 	}
 
 	/**
-	 * Unregister a runnable object by ID
-	 * @param id ID of the object to unregister
+	 * Unregister a runnable object by handle
 	 * @return True if found and removed, false otherwise
 	 */
-	bool unregisterRunnable(const String &id) {
-		auto it =
-			std::remove_if(_runnables.begin(), _runnables.end(),
-						   [&id](const std::shared_ptr<INeopixelRunnable> &r) {
-							   return r->get_ID() == id;
-						   });
-		if (it != _runnables.end()) {
-			_runnables.erase(it, _runnables.end());
-			return true;
-		}
-		return false;
+	bool unregisterRunnable(Handle handle) {
+		return _runnables.remove(handle);
 	}
 
+#if LOOP_PROFILER_ENABLED
 	/**
-	 * Update all active NeoPixel runnables
+	 * Profiler stage of a runnable, -1 if not registered
 	 */
-	void runAll() {
-		for (auto &runnable : _runnables) {
-			if (runnable && runnable->isActive()) {
-				runnable->run();
-			}
-		}
+	LoopProfiler::StageId getStage(Handle handle) const {
+		return _runnables.isValid(handle) ? _stages[handle] : -1;
 	}
+#endif
 
 	/**
 	 * Get number of registered runnables
@@ -123,18 +132,6 @@ class NeopixelRunner {
 	 * Clear all registered runnables
 	 */
 	void clear() { _runnables.clear(); }
-
-	/**
-	 * Get runnable by ID
-	 */
-	std::shared_ptr<INeopixelRunnable> getRunnable(const String &id) {
-		for (auto &runnable : _runnables) {
-			if (runnable && runnable->get_ID() == id) {
-				return runnable;
-			}
-		}
-		return nullptr;
-	}
 };
 
 // Static member definition
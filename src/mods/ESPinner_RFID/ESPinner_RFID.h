@@ -36,4 +36,10 @@ class ESPinner_RFID : public ESPinner {
 	};
 };
 
+/**
+ * Creates the RFID configuration UI
+ * @param RFID_ptr Parent UI element reference
+ */
+void RFID_UI(uint16_t RFID_ptr);
+
 #endif
\ No newline at end of file
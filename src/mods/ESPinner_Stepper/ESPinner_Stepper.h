@@ -8,7 +8,7 @@
 #include "./IStepperDriver.h"
 
 /* Stepper ESPinner class only used for software instantiation */
-class ESPinner_Stepper : public ESPinner {
+class ESPinner_Stepper : public ESPinner, public ICheckpointProvider {
   public:
 	uint8_t DIR, STEP, EN;
 	uint8_t CS, DIAG0, DIAG1;
@@ -19,9 +19,12 @@ class ESPinner_Stepper : public ESPinner {
 	bool isDIAG = false;
 	Stepper_Driver driver = Stepper_Driver::UNKNOWN;
 	std::unique_ptr<IStepperDriver> stepper;
+	// Typed alias of stepper when the driver is ACCELSTEPPER
+	AccelStepperAdapter *accelAdapter = nullptr;
 
 	ESPinner_Stepper(ESPinner_Mod espinner_mod) : ESPinner(espinner_mod) {}
 	ESPinner_Stepper() : ESPinner(ESPinner_Mod::Stepper) {}
+	~ESPinner_Stepper() { getCheckpointService().remove(this); }
 	void setup() override {
 		DUMPSLN("Iniciacion configuración de Stepper ...");
 	}
@@ -93,19 +96,18 @@ class ESPinner_Stepper : public ESPinner {
 				stepper->begin();
 			}
 			if (driver == Stepper_Driver::ACCELSTEPPER) {
-				stepper = std::unique_ptr<IStepperDriver>(
-					new AccelStepperAdapter(getDIR(), getSTEP(), getEN()));
+				accelAdapter =
+					new AccelStepperAdapter(getDIR(), getSTEP(), getEN());
+				stepper = std::unique_ptr<IStepperDriver>(accelAdapter);
 				if (stepper) {
 					bool registered = stepper->registerRunner(this->getID());
 
 					if (registered) {
 						DUMPLN("Stepper registered with ID: ", this->getID());
 
-						// Cast to AccelStepperAdapter
-						AccelStepperAdapter *adapter =
-							static_cast<AccelStepperAdapter *>(stepper.get());
-						adapter->begin();
-						adapter->setStepsPerRevolution(getStepsPerRevolution());
+						accelAdapter->begin();
+						accelAdapter->setStepsPerRevolution(
+							getStepsPerRevolution());
 					} else {
 						DUMPLN("Error registering stepper with ID: ",
 							   this->getID());
@@ -117,6 +119,14 @@ class ESPinner_Stepper : public ESPinner {
 		}
 	}
 
+	/**
+	 * Get the AccelStepper adapter driving this ESPinner
+	 * @return Adapter or nullptr if the driver is not ACCELSTEPPER
+	 */
+	AccelStepperAdapter *getAccelStepperAdapter() {
+		return stepper ? accelAdapter : nullptr;
+	}
+
 	Stepper_Driver getDriver() { return driver; }
 	String get_driverName() { return getDriverName(getDriver()); }
 
@@ -142,6 +152,29 @@ class ESPinner_Stepper : public ESPinner {
 	void setStepsPerRevolution(uint16_t steps) { stepsPerRevolution = steps; }
 	uint16_t getStepsPerRevolution() { return stepsPerRevolution; }
 
+	// Checkpointed runtime state: the AccelStepper position
+	ICheckpointProvider *getCheckpointProvider() override { return this; }
+	const char *checkpointID() override { return ID.c_str(); }
+	uint8_t checkpointChannels(const CheckpointChannel *&channels) override {
+		static const CheckpointChannel stepperChannels[] = {
+			{"pos", STEPPER_CHECKPOINT_STEPS}};
+		channels = stepperChannels;
+		return 1;
+	}
+	bool sampleCheckpoint(uint8_t channel, int32_t &value) override {
+		if (getAccelStepperAdapter() == nullptr) {
+			return false;
+		}
+		value = accelAdapter->getAccelStepper()->currentPosition();
+		return true;
+	}
+	void restoreCheckpoint(uint8_t channel, int32_t value) override {
+		if (getAccelStepperAdapter() != nullptr) {
+			accelAdapter->send(MotionCommand::setPosition(value));
+			DUMPLN("Stepper position restored: ", value);
+		}
+	}
+
 	ESP_PinMode getPinModeConf(StepperPin pinType) {
 		ESP_PinMode pinMode = {getGPIO(pinType), OutputPin(true),
 							   PinType::BusPWM};
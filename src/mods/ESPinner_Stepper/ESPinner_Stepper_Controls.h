@@ -87,6 +87,8 @@ void Stepper_action(uint16_t parentRef) {
 		}
 	}
 	// Create ESpinner with Configuration
+	espinnerStepper->setPanelRef(parentRef);
+	getCheckpointService().add(espinnerStepper.get());
 	ESPinner_Manager::getInstance().push(std::move(espinnerStepper));
 	ESPinner_Manager::getInstance().saveESPinnersInStorage();
 }
@@ -215,12 +217,10 @@ void removeStepper_callback(Control *sender, int type) {
 					espinner_value);
 
 				// Reset the stepper instance
-				ESPinner *espinner =
-					ESPinner_Manager::getInstance().findESPinnerById(
+				ESPinner_Stepper *espinnerStepper =
+					ESPinner_Manager::getInstance().findStepperById(
 						espinner_value);
-				if (espinner) {
-					ESPinner_Stepper *espinnerStepper =
-						static_cast<ESPinner_Stepper *>(espinner);
+				if (espinnerStepper) {
 					espinnerStepper->stepper.reset();
 				}
 			}
@@ -292,23 +292,33 @@ void Stepper_updateState_callback(Control *sender, int type) {
 	}
 
 	// Get stepper motor instance
-	ESPinner *espinner = ESPinner_Manager::getInstance().findESPinnerById(
-		ESPUI.getControl(parentRef)->value);
+	ESPinner_Stepper *stepperESPinner =
+		ESPinner_Manager::getInstance().findStepperByControllerRef(parentRef);
 	AccelStepperAdapter *stepperAdapter = nullptr;
-	AccelStepper *stepper = nullptr;
 
-	if (espinner && espinner->getType() == ESPinner_Mod::Stepper) {
-		ESPinner_Stepper *stepperESPinner =
-			static_cast<ESPinner_Stepper *>(espinner);
-		stepperAdapter =
-			static_cast<AccelStepperAdapter *>(stepperESPinner->stepper.get());
+	if (stepperESPinner) {
+		stepperAdapter = stepperESPinner->getAccelStepperAdapter();
 
 		if (stepperAdapter) {
-			stepper = stepperAdapter->getAccelStepper();
+			// Motion changes are queued, the runner applies them
 			if (isVel_Ref) {
 				float speed = (sender->value.toInt() / 100.0) * 1000.0;
 				DUMPLN("Setting speed: ", speed);
-				stepper->setSpeed(speed);
+				Admission admission = stepperAdapter->setMoveSpeed(speed);
+				if (admission.overCapacity) {
+					// The loop can not deliver it with the moving steppers
+					DUMPLN("Total step rate over capacity: ", admission.total);
+					DUMPLN("Speed granted: ", admission.granted);
+					char *backgroundStyle = getBackground(DANGER_COLOR);
+					ESPUI.setElementStyle(sender->id, backgroundStyle);
+					if (admission.granted != admission.requested) {
+						ESPUI.updateSlider(sender->id,
+										   (int)(admission.granted / 10.0));
+					}
+				} else {
+					char *backgroundStyle = getBackground(SELECTED_COLOR);
+					ESPUI.setElementStyle(sender->id, backgroundStyle);
+				}
 			}
 			if (isEN_Ref) {
 				bool enableState = sender->value.toInt() == 1 ? true : false;
@@ -320,10 +330,10 @@ void Stepper_updateState_callback(Control *sender, int type) {
 				stepperAdapter->setTarget(sender->value.toInt());
 			}
 			if (isHome_Ref) {
-				stepperAdapter->getAccelStepper()->moveTo(0);
+				stepperAdapter->send(MotionCommand::moveTo(0));
 			}
 			if (isZero_Ref) {
-				stepperAdapter->getAccelStepper()->setCurrentPosition(0);
+				stepperAdapter->send(MotionCommand::setPosition(0));
 			}
 		}
 	}
@@ -345,49 +355,44 @@ void Stepper_Pad_callback(Control *sender, int type) {
 						   parentRef, STEPPER_SLIDER_TARGET_LABEL);
 
 	// Get stepper motor instance
-	ESPinner *espinner = ESPinner_Manager::getInstance().findESPinnerById(
-		ESPUI.getControl(parentRef)->value);
+	ESPinner_Stepper *stepperESPinner =
+		ESPinner_Manager::getInstance().findStepperByControllerRef(parentRef);
 	AccelStepperAdapter *stepperAdapter = nullptr;
-	AccelStepper *stepper = nullptr;
 
-	if (espinner && espinner->getType() == ESPinner_Mod::Stepper) {
-		ESPinner_Stepper *stepperESPinner =
-			static_cast<ESPinner_Stepper *>(espinner);
-		stepperAdapter =
-			static_cast<AccelStepperAdapter *>(stepperESPinner->stepper.get());
-		if (stepperAdapter) {
-			stepper = stepperAdapter->getAccelStepper();
-		}
+	if (stepperESPinner) {
+		stepperAdapter = stepperESPinner->getAccelStepperAdapter();
 	}
+	if (stepperAdapter == nullptr)
+		return;
 
 	switch (type) {
 	case P_CENTER_DOWN: // Execute target movement
 		if (targetRef) {
 			int targetSteps = stepperAdapter->getTarget();
-			stepperAdapter->getAccelStepper()->moveTo(targetSteps);
+			stepperAdapter->send(MotionCommand::moveTo(targetSteps));
 		}
 		break;
 	case P_LEFT_DOWN: // Start continuous movement left
-		stepperAdapter->getAccelStepper()->move(
-			stepperAdapter->getStepsPerRevolution() * -1);
+		stepperAdapter->send(MotionCommand::move(
+			stepperAdapter->getStepsPerRevolution() * -1));
 		break;
 	case P_RIGHT_DOWN: // Start continuous movement right
-		stepperAdapter->getAccelStepper()->move(
-			stepperAdapter->getStepsPerRevolution());
+		stepperAdapter->send(
+			MotionCommand::move(stepperAdapter->getStepsPerRevolution()));
 		break;
 	case P_FOR_DOWN: // Discrete movement - start
-		stepperAdapter->getAccelStepper()->move(10000);
+		stepperAdapter->send(MotionCommand::move(10000));
 		break;
 	case P_FOR_UP: // Discrete movement - stop
-		stepperAdapter->getAccelStepper()->stop();
-		stepperAdapter->getAccelStepper()->disableOutputs();
+		stepperAdapter->send(MotionCommand::stop());
+		stepperAdapter->send(MotionCommand::disableOutputs());
 		break;
 	case P_BACK_DOWN: // Discrete movement - start
-		stepperAdapter->getAccelStepper()->move(-10000);
+		stepperAdapter->send(MotionCommand::move(-10000));
 		break;
 	case P_BACK_UP: // Discrete movement - stop
-		stepperAdapter->getAccelStepper()->stop();
-		stepperAdapter->getAccelStepper()->disableOutputs();
+		stepperAdapter->send(MotionCommand::stop());
+		stepperAdapter->send(MotionCommand::disableOutputs());
 		break;
 	default:
 		break;
@@ -453,6 +458,8 @@ void Stepper_Controller(String ID_LABEL, uint16_t parentRef) {
 	// Add direct mapping for O(1) controller lookup
 	ESPinner_Manager::getInstance().addESPinnerControllerMapping(
 		ID_LABEL, STEPPER_Controller_ID);
+	ESPinner_Manager::getInstance().bindControllerHandle(STEPPER_Controller_ID,
+														 ID_LABEL);
 }
 
 void saveStepper_callback(Control *sender, int type) {
@@ -511,6 +518,7 @@ void ESPinner_Stepper::implement() {
 		ControlType::Text, ESPINNERID_LABEL, ESPinner_Stepper::getID(),
 		ControlColor::Wetasphalt, parentRef, StepperSelector_callback);
 	ESPUI.getControl(Stepper_PIN_selector)->enabled = false;
+	setPanelRef(Stepper_PIN_selector);
 	addElementWithParent(elementToParentMap, Stepper_PIN_selector,
 						 Stepper_PIN_selector);
 
@@ -604,6 +612,10 @@ void ESPinner_Stepper::implement() {
 						REMOVEESPINNER_VALUE, saveStepper_callback,
 						removeStepper_callback);
 
+	// Resume from the last checkpointed position instead of re-homing
+	getCheckpointService().add(this);
+	getCheckpointService().restore(this);
+
 	// ------- Create Controllers ----------- //
 	Stepper_Controller(ESPinner_Stepper::getID(), Stepper_PIN_selector);
 }
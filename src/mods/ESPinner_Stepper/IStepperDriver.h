@@ -1,14 +1,17 @@
 #ifndef _IESPINNER_STEPPER_H
 #define _IESPINNER_STEPPER_H
 
+#include "StepperMotionState.h"
 #include "StepperRunner.h"
 #include <Arduino.h>
+#include <atomic>
 #include <map>
 
 #include "A4988.h"
 #include <AccelStepper.h>
 #include <TMCStepper.h>
-#include <TickerFree.h>
+
+#include "../../controllers/WheelTicker.h"
 
 enum class Stepper_Driver {
 	TMC2208,
@@ -57,8 +60,12 @@ Stepper_Driver findDriverByName(const String &name) {
 struct IStepperDriver {
 	virtual ~IStepperDriver() = default;
 	virtual void begin() = 0;
-	virtual void enable(bool on) { _active = on; }
-	virtual bool isEnabled() const { return _active; }
+	virtual void enable(bool on) {
+		_active.store(on, std::memory_order_release);
+	}
+	virtual bool isEnabled() const {
+		return _active.load(std::memory_order_acquire);
+	}
 	virtual void setMicrosteps(uint16_t ms) {}
 	virtual void setRMSCurrent(uint16_t mA) {}
 
@@ -77,14 +84,12 @@ struct IStepperDriver {
 	/**
 	 * Unregister this stepper from the global StepperRunner
 	 */
-	virtual bool unregisterRunner(const String &id) {
-		return StepperRunner::getInstance().unregisterRunnable(id);
-	}
+	virtual bool unregisterRunner(const String &id) { return false; }
 
 	virtual void updateActions() {}
 
   private:
-	bool _active = false;
+	std::atomic<bool> _active{false}; // Read by the task stepping the motor
 };
 
 // ===================== Adapter AccelStepper =====================
@@ -94,12 +99,24 @@ class AccelStepperAdapter : public IStepperDriver, IRunnable {
   public:
 	AccelStepperAdapter(uint8_t stepPin, uint8_t dirPin, uint8_t enPin = 0)
 		: stepper(AccelStepper::DRIVER, stepPin, dirPin), step(stepPin),
-		  dir(dirPin), en(enPin),
-		  stepperActions([this]() { this->updateActions(); },
-						 STEPPER_ACTIONS_INTERVAL_MS, 0, MILLIS) {
+		  dir(dirPin), en(enPin), motion(stepper, STEPPER_DEFAULT_MAX_SPEED),
+		  stepperActions(
+			  [this]() {
+				  if (isEnabled()) {
+					  this->updateActions();
+				  }
+			  },
+			  STEPPER_ACTIONS_INTERVAL_MS, 0, MILLIS) {
 		this->begin();
 	}
 
+	/**
+	 * Leave the StepperRunner before the adapter memory is released
+	 */
+	~AccelStepperAdapter() {
+		StepperRunner::getInstance().unregisterRunnable(motion.getHandle());
+	}
+
 	/**
 	 * Initialize the AccelStepper driver
 	 */
@@ -121,16 +138,53 @@ class AccelStepperAdapter : public IStepperDriver, IRunnable {
 		stepperActions.start();
 	}
 
+	/**
+	 * Safe point of the stepper: queued commands apply between two steps.
+	 * The StepperRunner runs enabled steppers and steppers with pending
+	 * commands; actions fire from the timer wheel. A disabled stepper only
+	 * leaves the runner once its queue is empty after the drain. The speed
+	 * of a move is held in the admission control until the stepper stops
+	 * or is disabled.
+	 */
 	void run() override {
-		if (isEnabled()) {
-			stepper.run();
-			if (stepperActions.state() == status_t::RUNNING) {
-				stepperActions.update();
-			}
-		}
+		motion.drain();
+		motion.step(isEnabled());
+	}
+
+	/**
+	 * Read by the StepperRunner only: a disabled stepper runs once more to
+	 * release its move speed
+	 */
+	bool isActive() const override {
+		return motion.isActive(IStepperDriver::isEnabled());
+	}
+
+	/**
+	 * Queues a command for the task stepping the motor, see
+	 * StepperMotionState::send()
+	 * @return false if the queue was full and the command dropped
+	 */
+	bool send(const MotionCommand &command) {
+		return motion.send(command, isEnabled());
+	}
+
+	/**
+	 * Sets the speed of the moves, limited to STEPPER_DEFAULT_MAX_SPEED.
+	 * The stepper admits it with the StepperRunner when a move starts, or
+	 * at once while it moves, and moves at the granted speed.
+	 * @param speed steps/s
+	 * @return What the admission control would grant now
+	 */
+	Admission setMoveSpeed(float speed) {
+		speed = constrain(fabsf(speed), 0.0f, (float)STEPPER_DEFAULT_MAX_SPEED);
+		send(MotionCommand::setMaxSpeed(speed));
+		return StepperRunner::getInstance().previewSpeed(motion.getHandle(),
+														 speed);
 	}
 
-	bool isActive() const override { return IStepperDriver::isEnabled(); }
+	MotionCommandStats getCommandStats() const {
+		return motion.getCommandStats();
+	}
 
 	/**
 	 * Get the ID of the stepper
@@ -150,13 +204,15 @@ class AccelStepperAdapter : public IStepperDriver, IRunnable {
 	 */
 	void enable(bool on) override {
 		IStepperDriver::enable(on); // Update _active in base class
+		StepperRunner::getInstance().wake(motion.getHandle());
 		if (en != 0) {
 			digitalWrite(en, on ? LOW : HIGH); // LOW = enabled for most drivers
 		}
 	}
 
 	/**
-	 * Get AccelStepper instance for direct access
+	 * Get AccelStepper instance for direct access. Once registered, read
+	 * only outside the StepperRunner: changes go through send().
 	 */
 	AccelStepper *getAccelStepper() override { return &stepper; }
 
@@ -165,20 +221,26 @@ class AccelStepperAdapter : public IStepperDriver, IRunnable {
 	 */
 	bool registerRunner(const String &id) override {
 		_id = id;
-
-		// Create shared_ptr without taking ownership of the object
-		// (no-op deleter)
-		std::shared_ptr<IRunnable> runnable(static_cast<IRunnable *>(this),
-											[](IRunnable *) {});
-		return StepperRunner::getInstance().registerRunnable(runnable);
+		if (motion.getHandle() < 0) {
+			motion.setHandle(StepperRunner::getInstance().registerRunnable(
+				static_cast<IRunnable *>(this)));
+		}
+		return motion.getHandle() >= 0;
 	}
 
 	bool unregisterRunner(const String &id) override {
-		return StepperRunner::getInstance().unregisterRunnable(id);
+		bool removed =
+			StepperRunner::getInstance().unregisterRunnable(motion.getHandle());
+		motion.setHandle(-1);
+		return removed;
 	}
 
 	void setAction(std::function<void()> action) {
-		stepperActions.setCallback(action);
+		stepperActions.setCallback([this, action]() {
+			if (isEnabled() && action) {
+				action();
+			}
+		});
 	}
 
 	void updateActions() override;
@@ -208,7 +270,8 @@ class AccelStepperAdapter : public IStepperDriver, IRunnable {
 	uint8_t dir;	// direction pin
 	AccelStepper stepper;
 	int target; // target position
-	TickerFree<> stepperActions;
+	StepperMotionState motion; // Commands and move admission
+	WheelTicker stepperActions;
 };
 
 // ===================== Adapter TMC2130 =====================
@@ -0,0 +1,66 @@
+#ifndef _STEP_CAPACITY_H
+#define _STEP_CAPACITY_H
+
+#include "../../manager/Clock.h"
+#include "../../manager/StepAdmission.h"
+
+#include <AccelStepper.h>
+#include <math.h>
+#include <vector>
+
+/** Step function of the calibration steppers: no pin moves */
+inline void calibrationStep() {}
+
+/**
+ * Measures the aggregate step rate the calling task sustains
+ *
+ * Runs a number of AccelSteppers round robin, like StepperRunner::runAll(),
+ * for trialUs per speed and searches the highest speed all of them still
+ * deliver (measureStepCapacity()). The steppers use the FUNCTION interface
+ * with stepFunction in place of the pin writes, so nothing moves; the pin
+ * writes of a real step and the rest of the loop are what the share leaves
+ * time for. Meant for boot, before the steppers move: it busies the task
+ * for about 11 trials.
+ * @param steppers Steppers run by each trial
+ * @param maxSpeed Highest per stepper speed tried, steps/s
+ * @param trialUs Time one speed is run
+ * @param share Part of the measured rate returned, 0 to 1
+ * @param clock Time in us, read once per round of the steppers
+ * @param stepFunction Called on every step of the calibration steppers
+ * @return Aggregate steps/s: share of the sustained rate
+ */
+inline float calibrateStepCapacity(size_t steppers, float maxSpeed,
+								   uint32_t trialUs, float share,
+								   uint32_t (*clock)() = clockMicros,
+								   void (*stepFunction)() = calibrationStep) {
+	float sustained = measureStepCapacity(
+		steppers, maxSpeed,
+		[steppers, trialUs, clock, stepFunction](float speed) -> float {
+			std::vector<AccelStepper> motors;
+			motors.reserve(steppers);
+			for (size_t i = 0; i < steppers; i++) {
+				motors.emplace_back(stepFunction, stepFunction);
+				motors.back().setMaxSpeed(speed);
+				// At full speed from the first step
+				motors.back().setAcceleration(1e9);
+				motors.back().moveTo(1000000000L);
+			}
+			uint32_t start = clock();
+			uint32_t now = start;
+			while (now - start < trialUs) {
+				for (AccelStepper &motor : motors) {
+					motor.run();
+				}
+				now = clock();
+			}
+			float expected = speed * (now - start) / 1e6f;
+			float worst = 1;
+			for (AccelStepper &motor : motors) {
+				worst = fminf(worst, motor.currentPosition() / expected);
+			}
+			return worst;
+		});
+	return sustained * share;
+}
+
+#endif
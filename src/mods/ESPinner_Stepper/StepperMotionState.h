@@ -0,0 +1,151 @@
+#ifndef _STEPPER_MOTION_STATE_H
+#define _STEPPER_MOTION_STATE_H
+
+#include "../../manager/MotionCommandQueue.h"
+#include "StepperRunner.h"
+
+#include <AccelStepper.h>
+
+/**
+ * Command queue and move admission of one stepper run by the StepperRunner
+ *
+ * Holds what AccelStepperAdapter and the host simulation share: commands
+ * queue while the stepper is registered and apply from drain(), between
+ * two steps; step() runs an enabled stepper and takes a disabled one out
+ * of the active set once its queue is empty. The speed of a move is
+ * admitted with the StepperRunner when the move starts and released when
+ * it ends, stops or the stepper is disabled. drain() and step() belong to
+ * the task stepping the motor; send() and the stats to any task.
+ */
+class StepperMotionState {
+  public:
+	/**
+	 * @param stepper Stepped by step(), must outlive this state
+	 * @param moveSpeed Speed of the moves until a SetMaxSpeed, steps/s
+	 */
+	StepperMotionState(AccelStepper &stepper, float moveSpeed)
+		: stepper(stepper), moveSpeed(moveSpeed) {}
+
+	void setHandle(StepperRunner::Handle handle) { this->handle = handle; }
+	StepperRunner::Handle getHandle() const { return handle; }
+
+	/** Applies the queued commands */
+	void drain() {
+		commands.drain(
+			[this](const MotionCommand &command) { this->apply(command); });
+	}
+
+	/**
+	 * Steps an enabled stepper, releasing its move speed once it stops. A
+	 * disabled stepper releases its speed and leaves the runner once its
+	 * queue is empty.
+	 */
+	void step(bool enabled) {
+		if (enabled) {
+			stepper.run();
+			if (moveAdmitted && !stepper.isRunning()) {
+				releaseMove();
+			}
+		} else {
+			releaseMove();
+			if (!commands.pending()) {
+				StepperRunner::getInstance().deactivate(handle);
+			}
+		}
+	}
+
+	/** A disabled stepper runs once more to release its move speed */
+	bool isActive(bool enabled) const {
+		return enabled || commands.pending() || moveAdmitted;
+	}
+
+	/**
+	 * Queues a command for the task stepping the motor. Before the stepper
+	 * is registered with the StepperRunner nothing steps it, so the command
+	 * applies at once.
+	 * @param enabled A disabled stepper is woken to drain the command
+	 * @return false if the queue was full and the command dropped
+	 */
+	bool send(const MotionCommand &command, bool enabled) {
+		if (handle < 0) {
+			apply(command);
+			return true;
+		}
+		bool queued = commands.send(command);
+		if (queued && !enabled) {
+			// Drained on the next pass even though the stepper is disabled
+			StepperRunner::getInstance().wake(handle);
+		}
+		return queued;
+	}
+
+	MotionCommandStats getCommandStats() const { return commands.getStats(); }
+
+  private:
+	AccelStepper &stepper;
+	StepperRunner::Handle handle = -1; // -1 = not registered
+	MotionCommandQueue<STEPPER_COMMAND_QUEUE_SIZE> commands;
+	// Owned by the task stepping the motor
+	float moveSpeed; // Requested, steps/s
+	bool moveAdmitted = false;
+
+	/**
+	 * Admits the move speed and moves at the granted one
+	 * @return false if nothing was granted, the move is dropped
+	 */
+	bool admitMove() {
+		Admission admission =
+			StepperRunner::getInstance().admitSpeed(handle, moveSpeed);
+		if (admission.granted < 1) {
+			releaseMove();
+			return false;
+		}
+		stepper.setMaxSpeed(admission.granted);
+		moveAdmitted = true;
+		return true;
+	}
+
+	void releaseMove() {
+		if (moveAdmitted) {
+			StepperRunner::getInstance().releaseSpeed(handle);
+			moveAdmitted = false;
+		}
+	}
+
+	void apply(const MotionCommand &command) {
+		switch (command.type) {
+		case MotionCommandType::MoveTo:
+			if (admitMove()) {
+				stepper.moveTo(command.steps);
+			}
+			break;
+		case MotionCommandType::Move:
+			if (admitMove()) {
+				stepper.move(command.steps);
+			}
+			break;
+		case MotionCommandType::SetSpeed:
+			stepper.setSpeed(command.speed);
+			break;
+		case MotionCommandType::SetMaxSpeed:
+			moveSpeed = command.speed;
+			if (moveAdmitted && !admitMove()) {
+				stepper.stop();
+			}
+			break;
+		case MotionCommandType::Stop:
+			stepper.stop();
+			releaseMove();
+			break;
+		case MotionCommandType::SetPosition:
+			stepper.setCurrentPosition(command.steps);
+			releaseMove();
+			break;
+		case MotionCommandType::DisableOutputs:
+			stepper.disableOutputs();
+			break;
+		}
+	}
+};
+
+#endif
@@ -1,10 +1,15 @@
 #ifndef _STEPPER_RUNNER_H
 #define _STEPPER_RUNNER_H
 
-#include <memory>
-#include <vector>
+#include "../../manager/Clock.h"
+#include "../../manager/LoopProfiler.h"
+#include "../../manager/MotionTask.h"
+#include "../../manager/StepAdmission.h"
+#include "../../manager/RunnableTable.h"
+#include "StepCapacity.h"
 
 #include <Arduino.h>
+#include <atomic>
 
 /**
  * Interface for objects that need to run continuously in the main loop
@@ -18,18 +23,82 @@ class IRunnable {
 	virtual String getDriverName() const = 0;
 };
 
+#if MOTION_TASK_ENABLED
+MotionTask &getMotionTask();
+#endif
+
 /**
  * Singleton class to manage multiple AccelStepper instances
  * and execute them in a non-blocking manner in the main loop
+ *
+ * Runnables sit in a RunnableTable: runAll() only visits the active ones.
+ * Only the task running the steppers moves entries between the active and
+ * inactive sets. Other tasks report a change of isActive() with wake(),
+ * which sets the runnable's bit in an atomic mask; runAll() re-reads
+ * isActive() of the woken runnables before its pass. A runnable leaves the
+ * active set from its own run() with deactivate(). With MOTION_TASK_ENABLED
+ * runAll() runs on the motion task, and registrations are executed there
+ * so they never interleave with a pass.
+ *
+ * With LOOP_PROFILER_ENABLED every run() is timed as the profiler stage
+ * "stepper <handle>".
+ *
+ * Moves go through admitSpeed(): the runner keeps the aggregate step rate
+ * of the moving steppers within a capacity, STEPPER_STEP_CAPACITY or the
+ * one calibrateCapacity() measures at boot; unlimited until either is set.
+ * Steppers admit the speed of a move when it starts and release it when it
+ * ends, from their run(); other tasks only previewSpeed().
  */
 class StepperRunner {
-  private:
+  public:
 	static constexpr size_t MAX_STEPPERS =
 		STEPPER_MAX_STEPPERS; // Maximum number of steppers
-	std::vector<std::shared_ptr<IRunnable>> _runnables;
+	typedef RunnableTable<IRunnable, MAX_STEPPERS>::Handle Handle;
+	static_assert(MAX_STEPPERS <= 32, "wake() requests are a 32 bit mask");
+
+  private:
+	RunnableTable<IRunnable, MAX_STEPPERS> _runnables;
+	std::atomic<uint32_t> _wakeups{0}; // Handles to re-read isActive() of
+	StepAdmission<MAX_STEPPERS> _admission;
 	static StepperRunner *_instance;
+#if LOOP_PROFILER_ENABLED
+	LoopProfiler::StageId _stages[MAX_STEPPERS];
+#endif
 
-	StepperRunner() { _runnables.reserve(MAX_STEPPERS); }
+	StepperRunner()
+		: _admission(STEPPER_STEP_CAPACITY > 0 ? STEPPER_STEP_CAPACITY
+											   : INFINITY,
+					 STEPPER_ADMISSION_CLAMP ? AdmissionPolicy::Clamp
+											 : AdmissionPolicy::Warn) {
+#if LOOP_PROFILER_ENABLED
+		for (LoopProfiler::StageId &stage : _stages) {
+			stage = -1;
+		}
+#endif
+	}
+
+	template <typename F> void modify(F change) {
+#if MOTION_TASK_ENABLED
+		getMotionTask().execute(change);
+#else
+		change();
+#endif
+	}
+
+	/**
+	 * Applies the wake() requests, on the task running the steppers
+	 */
+	void applyWakeups() {
+		uint32_t requests = _wakeups.exchange(0, std::memory_order_acquire);
+		while (requests != 0) {
+			Handle handle = __builtin_ctz(requests);
+			requests &= requests - 1;
+			IRunnable *runnable = _runnables.get(handle);
+			if (runnable != nullptr) {
+				_runnables.setActive(handle, runnable->isActive());
+			}
+		}
+	}
 
   public:
 	/**
@@ -44,44 +113,117 @@ class StepperRunner {
 
 	/**
 	 * Register a runnable object (stepper, motor controller, etc.)
-	 * @param runnable Shared pointer to the runnable object
-	 * @return True if registered successfully, false if array is full
+	 * @param runnable Runnable object, not owned
+	 * @return Handle to unregister and report activity, -1 if full
 	 */
-	bool registerRunnable(std::shared_ptr<IRunnable> runnable) {
-		if (_runnables.size() < MAX_STEPPERS) {
-			_runnables.push_back(runnable);
-			return true;
+	Handle registerRunnable(IRunnable *runnable) {
+		Handle handle = -1;
+		modify([&]() { handle = _runnables.add(runnable, false); });
+		wake(handle);
+#if LOOP_PROFILER_ENABLED
+		// Stage names follow the handle, so a reused handle keeps its stage
+		if (handle >= 0 && _stages[handle] < 0) {
+			char name[LoopProfiler::NAME_LENGTH];
+			snprintf(name, sizeof(name), "stepper %u", (uint8_t)handle);
+			_stages[handle] = getLoopProfiler().stage(name);
 		}
-		return false;
+#endif
+		return handle;
 	}
 
 	/**
-	 * Unregister a runnable object by ID
-	 * @param id ID of the object to unregister
+	 * Unregister a runnable object by handle
 	 * @return True if found and removed, false otherwise
 	 */
-	bool unregisterRunnable(const String &id) {
-		auto it = std::remove_if(_runnables.begin(), _runnables.end(),
-								 [&id](const std::shared_ptr<IRunnable> &r) {
-									 return r->getID() == id;
-								 });
-		if (it != _runnables.end()) {
-			_runnables.erase(it, _runnables.end());
-			return true;
+	bool unregisterRunnable(Handle handle) {
+		bool removed = false;
+		modify([&]() { removed = _runnables.remove(handle); });
+		if (removed) {
+			_admission.release(handle);
+		}
+		return removed;
+	}
+
+	/**
+	 * Admission control of the speed of a runnable, from its run() when a
+	 * move starts or changes speed. Held until releaseSpeed().
+	 * @param speed steps/s
+	 * @return Speed to move at and whether the total is over capacity
+	 */
+	Admission admitSpeed(Handle handle, float speed) {
+		return _admission.request(handle >= 0 ? handle : MAX_STEPPERS, speed);
+	}
+
+	/**
+	 * What admitSpeed() would grant now, from any task
+	 */
+	Admission previewSpeed(Handle handle, float speed) const {
+		return _admission.preview(handle >= 0 ? handle : MAX_STEPPERS, speed);
+	}
+
+	/**
+	 * Frees the speed of a runnable, from its run() when a move ends
+	 */
+	void releaseSpeed(Handle handle) {
+		if (handle >= 0) {
+			_admission.release(handle);
+		}
+	}
+
+	const StepAdmission<MAX_STEPPERS> &getAdmission() const {
+		return _admission;
+	}
+	/** Capacity and policy, set before the steppers move */
+	StepAdmission<MAX_STEPPERS> &getAdmission() { return _admission; }
+
+	/**
+	 * Measures the step capacity on the task running the steppers and
+	 * admits moves within it, see calibrateStepCapacity(). Call at boot,
+	 * before the steppers move.
+	 * @return Capacity set, steps/s
+	 */
+	float calibrateCapacity(float maxSpeed, uint32_t trialUs, float share) {
+		float capacity = 0;
+		modify([this, &capacity, maxSpeed, trialUs, share]() {
+			capacity = calibrateStepCapacity(MAX_STEPPERS, maxSpeed, trialUs,
+											 share);
+			_admission.setCapacity(capacity);
+		});
+		return capacity;
+	}
+
+	/**
+	 * Report a change of IRunnable::isActive(), from any task. Applied at
+	 * the start of the next runAll(), after the changes made before it.
+	 */
+	void wake(Handle handle) {
+		if (handle >= 0 && handle < (Handle)MAX_STEPPERS) {
+			_wakeups.fetch_or(1u << handle, std::memory_order_release);
 		}
-		return false;
 	}
 
 	/**
-	 * Execute all registered runnable objects
+	 * Leave the active set, from the runnable's own run() only. A wake()
+	 * racing with it is applied on the next pass, so check for pending work
+	 * first and a later request is never lost.
+	 */
+	void deactivate(Handle handle) { _runnables.setActive(handle, false); }
+
+	/**
+	 * Execute all active runnable objects
 	 * This method should be called in the main loop
 	 */
 	void runAll() {
-		for (auto &runnable : _runnables) {
-			if (runnable && runnable->isActive()) {
-				runnable->run();
-			}
-		}
+		applyWakeups();
+#if LOOP_PROFILER_ENABLED
+		LoopProfiler &profiler = getLoopProfiler();
+		_runnables.runAll([this, &profiler](Handle handle, IRunnable *item) {
+			LoopProfiler::Scope scope(&profiler, _stages[handle]);
+			item->run();
+		});
+#else
+		_runnables.runAll();
+#endif
 	}
 
 	/**
@@ -89,12 +231,35 @@ class StepperRunner {
 	 */
 	size_t getCount() const { return _runnables.size(); }
 
+	/**
+	 * Get number of runnables run by runAll()
+	 */
+	size_t getActiveCount() const { return _runnables.activeCount(); }
+
 	/**
 	 * Clear all registered runnables
 	 */
-	void clear() { _runnables.clear(); }
+	void clear() {
+		modify([&]() { _runnables.clear(); });
+		for (size_t i = 0; i < MAX_STEPPERS; i++) {
+			_admission.release(i);
+		}
+	}
 };
 
 // Static member definition
 StepperRunner *StepperRunner::_instance = nullptr;
+
+#if MOTION_TASK_ENABLED
+/**
+ * Motion task running the steppers, started by registerLoopTasks()
+ */
+MotionTask &getMotionTask() {
+	static MotionTask task(clockMicros, []() {
+		StepperRunner::getInstance().runAll();
+		return StepperRunner::getInstance().getActiveCount() > 0;
+	});
+	return task;
+}
+#endif
 #endif
\ No newline at end of file
@@ -36,4 +36,10 @@ class ESPinner_TFT : public ESPinner {
 	};
 };
 
+/**
+ * Creates the TFT configuration UI
+ * @param TFT_ptr Parent UI element reference
+ */
+void TFT_UI(uint16_t TFT_ptr);
+
 #endif
\ No newline at end of file
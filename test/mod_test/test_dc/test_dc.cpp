@@ -124,8 +124,6 @@ void assertControlValues(const std::vector<ControlAssertion> &assertions) {
 	}
 }
 
-Persistance ESPinnerManager(nullptr, &storage);
-
 bool compareESPinnerDC(const ESPinner_DC &expected_ESPinner_DC,
 					   const ESPinner_DC &actual_ESPinner_DC) {
 	return expected_ESPinner_DC.gpioA == actual_ESPinner_DC.gpioA &&
@@ -136,7 +134,7 @@ bool compareESPinnerDC(const ESPinner_DC &expected_ESPinner_DC,
 
 void loadStorage(const ESPinner_DC expectedList[]) {
 	DynamicJsonDocument doc(256);
-	String serialized = ESPinnerManager.loadData(ESPinner_Path);
+	String serialized = ESPinner_Manager::getInstance().loadConfigFromStorage();
 	DUMP("Dataloaded: ", serialized);
 	DeserializationError error = deserializeJson(doc, serialized);
 	uint8_t espinner_index = 0;
@@ -117,8 +117,6 @@ void removedControl(uint16_t input_ref, const String &label) {
 	TEST_ASSERT_EQUAL_INT16(0, ref);
 }
 
-Persistance ESPinnerManager(nullptr, &storage);
-
 bool compareESPinnerGPIO(const ESPinner_GPIO &expected_ESPinner_GPIO,
 						 const ESPinner_GPIO &actual_ESPinner_GPIO) {
 	return expected_ESPinner_GPIO.gpio == actual_ESPinner_GPIO.gpio &&
@@ -129,7 +127,7 @@ bool compareESPinnerGPIO(const ESPinner_GPIO &expected_ESPinner_GPIO,
 
 void loadStorage(const ESPinner_GPIO expectedList[]) {
 	DynamicJsonDocument doc(256);
-	String serialized = ESPinnerManager.loadData(ESPinner_Path);
+	String serialized = ESPinner_Manager::getInstance().loadConfigFromStorage();
 	DUMP("Dataloaded: ", serialized);
 	DeserializationError error = deserializeJson(doc, serialized);
 	uint8_t espinner_index = 0;
@@ -105,8 +105,6 @@ void assertControlValues(const std::vector<ControlAssertion> &assertions) {
 	}
 }
 
-Persistance ESPinnerManager(nullptr, &storage);
-
 bool compareESPinnerNeopixel(ESPinner_Neopixel &expected_ESPinner_Neopixel,
 							 ESPinner_Neopixel &actual_ESPinner_Neopixel) {
 	return expected_ESPinner_Neopixel.getGPIO() ==
@@ -121,7 +119,7 @@ bool compareESPinnerNeopixel(ESPinner_Neopixel &expected_ESPinner_Neopixel,
 
 void loadStorage(ESPinner_Neopixel *expectedList, uint8_t expectedCount) {
 	DynamicJsonDocument doc(256);
-	String serialized = ESPinnerManager.loadData(ESPinner_Path);
+	String serialized = ESPinner_Manager::getInstance().loadConfigFromStorage();
 	DUMP("Dataloaded: ", serialized);
 	DeserializationError error = deserializeJson(doc, serialized);
 	uint8_t espinner_index = 0;
@@ -106,8 +106,6 @@ void assertControlValues(const std::vector<ControlAssertion> &assertions) {
 	}
 }
 
-Persistance ESPinnerManager(nullptr, &storage);
-
 bool compareESPinnerStepper(ESPinner_Stepper &expected_ESPinner_Stepper,
 							ESPinner_Stepper &actual_ESPinner_Stepper) {
 	return expected_ESPinner_Stepper.getSTEP() ==
@@ -123,7 +121,7 @@ bool compareESPinnerStepper(ESPinner_Stepper &expected_ESPinner_Stepper,
 
 void loadStorage(ESPinner_Stepper *expectedList, uint8_t expectedCount) {
 	DynamicJsonDocument doc(256);
-	String serialized = ESPinnerManager.loadData(ESPinner_Path);
+	String serialized = ESPinner_Manager::getInstance().loadConfigFromStorage();
 	DUMP("Dataloaded: ", serialized);
 	DeserializationError error = deserializeJson(doc, serialized);
 	uint8_t espinner_index = 0;
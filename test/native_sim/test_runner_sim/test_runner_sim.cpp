@@ -0,0 +1,177 @@
+/**
+ * Runner Simulation Test
+ *
+ * This test runs on the host (pio test -e native_sim) and drives the
+ * StepperRunner, NeopixelRunner and wheel tickers on a virtual clock,
+ * checking the step pulses recorded on the simulated pins.
+ *
+ * Test Steps:
+ * 1. Validate the loop clocks and tickers follow the virtual clock
+ * 2. Validate a stepper reaches its target at its max speed
+ * 3. Validate commands sent to a disabled stepper around its drain apply
+ * 4. Validate NeoPixel shows delay step pulses by their duration
+ * 5. Benchmark step rate and jitter for 1 to 8 steppers under UI load
+ */
+
+#include <unity.h>
+
+#include "../../sim/Simulation.h"
+
+#include <memory>
+#include <vector>
+
+void setUp() {}
+void tearDown() { getGpioTrace().setWriteCost(0); }
+
+void test_virtual_clock_drives_loop() {
+	uint64_t start = getVirtualClock().nowMicros();
+	TEST_ASSERT_EQUAL((uint32_t)start, clockMicros());
+	getVirtualClock().advance(2500);
+	TEST_ASSERT_EQUAL((uint32_t)(start + 2500), clockMicros());
+	TEST_ASSERT_EQUAL((uint32_t)(start + 2500), micros());
+	TEST_ASSERT_EQUAL((uint32_t)((start + 2500) / 1000), millis());
+
+	Simulation sim;
+	int fired = 0;
+	WheelTicker ticker([&fired]() { fired++; }, 100);
+	ticker.start();
+	sim.run(1000000);
+	TEST_ASSERT_EQUAL(10, fired);
+	TEST_ASSERT_TRUE(sim.elapsedMicros() >= 1000000);
+
+	ticker.stop();
+	sim.run(500000);
+	TEST_ASSERT_EQUAL(10, fired);
+}
+
+void test_stepper_reaches_target() {
+	Simulation sim;
+	SimStepper stepper(12, 13, 1000, 20000);
+	TEST_ASSERT_TRUE(stepper.isRegistered());
+	stepper.send(MotionCommand::moveTo(2000));
+	stepper.enable(true);
+	// Activity changes apply at the start of the next pass
+	TEST_ASSERT_EQUAL(0, StepperRunner::getInstance().getActiveCount());
+	sim.run(1);
+	TEST_ASSERT_EQUAL(1, StepperRunner::getInstance().getActiveCount());
+
+	sim.run(2500000);
+	TEST_ASSERT_EQUAL(2000, stepper.getStepper().currentPosition());
+	TEST_ASSERT_EQUAL(2000, getGpioTrace().risingEdges(12).size());
+
+	// Cruise phase: one pulse per ms, give or take a loop pass
+	PulseStats cruise = getGpioTrace().pulseStats(12, sim.nanosAt(500000),
+												  sim.nanosAt(1500000));
+	TEST_ASSERT_TRUE(cruise.rate > 990 && cruise.rate < 1010);
+	TEST_ASSERT_TRUE(cruise.maxInterval < 1000 + 5);
+
+	stepper.enable(false);
+	sim.run(1000);
+	TEST_ASSERT_EQUAL(0, StepperRunner::getInstance().getActiveCount());
+}
+
+void test_disabled_send_around_drain() {
+	Simulation sim;
+	StepperRunner &runner = StepperRunner::getInstance();
+	SimStepper stepper(12, 13, 1000, 20000);
+	sim.run(1000);
+	TEST_ASSERT_EQUAL(0, runner.getActiveCount());
+
+	// A command sent after the drain emptied the queue, before the disabled
+	// stepper leaves the runner
+	stepper.send(MotionCommand::moveTo(100));
+	stepper.interleaveAfterDrain(
+		[&stepper]() { stepper.send(MotionCommand::moveTo(150)); });
+	sim.run(1000);
+	TEST_ASSERT_EQUAL(150, stepper.getStepper().targetPosition());
+	TEST_ASSERT_EQUAL(0, runner.getActiveCount());
+
+	// Disabled and sent to while its drain runs: still drained, never steps
+	stepper.enable(true);
+	stepper.send(MotionCommand::moveTo(0));
+	stepper.interleaveAfterDrain([&stepper]() {
+		stepper.enable(false);
+		stepper.send(MotionCommand::moveTo(-20));
+	});
+	sim.run(5000);
+	TEST_ASSERT_EQUAL(-20, stepper.getStepper().targetPosition());
+	TEST_ASSERT_EQUAL(0, stepper.getStepper().currentPosition());
+	TEST_ASSERT_EQUAL(0, runner.getActiveCount());
+
+	// Woken after it left the runner: the next pass takes it back
+	stepper.send(MotionCommand::moveTo(10));
+	sim.run(1000);
+	TEST_ASSERT_EQUAL(10, stepper.getStepper().targetPosition());
+	TEST_ASSERT_EQUAL(0, runner.getActiveCount());
+}
+
+void test_neopixel_show_delays_steps() {
+	Simulation sim;
+	SimStepper stepper(12, 13, 1000, 20000);
+	SimNeopixel strip(5, 60, 20); // 60 LEDs: 1.8 ms per show, 50 Hz
+	stepper.send(MotionCommand::moveTo(100000));
+	stepper.enable(true);
+	strip.enable(true);
+
+	sim.run(1000000);
+	TEST_ASSERT_TRUE(strip.getStrip().getShows() >= 49);
+	TEST_ASSERT_TRUE(getGpioTrace().risingEdges(5).size() >= 49);
+
+	// A step due during a show waits for it, and AccelStepper times the
+	// next step from the late one: the lost time is never made up
+	PulseStats steps = getGpioTrace().pulseStats(12, sim.nanosAt(500000));
+	TEST_ASSERT_TRUE(steps.maxInterval > 1000 + 500);
+	TEST_ASSERT_TRUE(steps.rate < 1000);
+	TEST_ASSERT_TRUE(steps.jitter > 100);
+}
+
+void test_benchmark_step_rate_and_jitter() {
+	const float speed = 1000;		   // steps/s, the UI slider maximum
+	const uint32_t runCostNs = 20000;  // Assumed AccelStepper::run() cost
+	const uint32_t writeCostNs = 100;  // Assumed digitalWrite() cost
+	const uint64_t warmUpUs = 200000;  // Acceleration ramp and more
+	const uint64_t measureUs = 1000000;
+
+	for (size_t count : {1, 2, 4, 8}) {
+		Simulation sim;
+		getGpioTrace().setWriteCost(writeCostNs);
+		sim.addLoad("ui", 2000, 50000); // Websocket burst, 2 ms every 50 ms
+		std::vector<std::unique_ptr<SimStepper>> steppers;
+		for (size_t i = 0; i < count; i++) {
+			steppers.emplace_back(new SimStepper(20 + 2 * i, 21 + 2 * i, speed,
+												 20000, runCostNs));
+			steppers.back()->send(MotionCommand::moveTo(1000000));
+			steppers.back()->enable(true);
+		}
+
+		sim.run(warmUpUs + measureUs);
+		double rate = 0;
+		double jitter = 0;
+		double worst = 0;
+		for (const std::unique_ptr<SimStepper> &stepper : steppers) {
+			PulseStats stats = getGpioTrace().pulseStats(
+				stepper->getStepPin(), sim.nanosAt(warmUpUs));
+			rate += stats.rate;
+			jitter = fmax(jitter, stats.jitter);
+			worst = fmax(worst, stats.maxInterval);
+		}
+		TEST_ASSERT_TRUE(rate > 0);
+
+		char report[160];
+		snprintf(report, sizeof(report),
+				 "%u steppers at %.0f steps/s: %.0f steps/s delivered, "
+				 "jitter %.1f us, worst interval %.0f us",
+				 (unsigned)count, speed, rate, jitter, worst);
+		TEST_MESSAGE(report);
+	}
+}
+
+int main(int argc, char **argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_virtual_clock_drives_loop);
+	RUN_TEST(test_stepper_reaches_target);
+	RUN_TEST(test_disabled_send_around_drain);
+	RUN_TEST(test_neopixel_show_delays_steps);
+	RUN_TEST(test_benchmark_step_rate_and_jitter);
+	return UNITY_END();
+}
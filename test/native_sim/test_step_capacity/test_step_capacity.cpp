@@ -0,0 +1,166 @@
+/**
+ * Step Capacity Native Simulation Test
+ *
+ * This test runs on the host (pio test -e native_sim) and validates the
+ * boot calibration of the step capacity on the virtual clock: a loop with
+ * known stepping costs, calibrated like StepperRunner::calibrateCapacity()
+ * does on the device, and the admission control at the calibrated capacity
+ * under UI load.
+ *
+ * Test Steps:
+ * 1. Validate the calibration finds the step rate of a loop of known cost
+ * 2. Validate moves admitted at the calibrated capacity are delivered
+ * 3. Validate moves hold their speed until they end, stop or are disabled
+ */
+
+#include <unity.h>
+
+#include "../../sim/Simulation.h"
+#include "../../../src/manager/StepAdmission.h"
+#include "../../../src/mods/ESPinner_Stepper/StepCapacity.h"
+
+#include <memory>
+#include <vector>
+
+// Loop under test: AccelStepper::run() that does not step, and the extra
+// of a step (pin writes and the speed update)
+#define RUN_COST_NS 1500
+#define STEP_COST_NS 15000
+// Websocket burst of the UI: 2 ms every 50 ms
+#define UI_LOAD_US 2000
+#define UI_PERIOD_US 50000
+// Highest per stepper speed tried, steps/s
+#define MAX_TRIAL_SPEED 20000
+#define TRIAL_US 20000
+
+size_t calibrationSteppers = 1;
+
+void setUp() {}
+void tearDown() {}
+
+/** Read once per round: the run() cost of every calibration stepper */
+uint32_t costedClock() {
+	getVirtualClock().advanceNanos(RUN_COST_NS * calibrationSteppers);
+	return clockMicros();
+}
+
+void costedStep() { getVirtualClock().advanceNanos(STEP_COST_NS); }
+
+float calibrate(size_t steppers, float share) {
+	calibrationSteppers = steppers;
+	return calibrateStepCapacity(steppers, MAX_TRIAL_SPEED, TRIAL_US, share,
+								 costedClock, costedStep);
+}
+
+void test_calibration_finds_loop_rate() {
+	float capacity[STEPPER_MAX_STEPPERS + 1] = {};
+	for (size_t count : {1, 2, 4, 8}) {
+		// No more steps than the step cost leaves time for or the speeds
+		// tried ask for
+		const float bound =
+			fminf(1e9f / STEP_COST_NS, count * (float)MAX_TRIAL_SPEED);
+		Simulation sim;
+		capacity[count] = calibrate(count, 1);
+		char report[96];
+		snprintf(report, sizeof(report), "%u steppers: %.0f steps/s",
+				 (unsigned)count, capacity[count]);
+		TEST_MESSAGE(report);
+		TEST_ASSERT_TRUE(capacity[count] <= bound);
+		TEST_ASSERT_TRUE(capacity[count] >= bound * 0.75f);
+	}
+	// The run() cost of more steppers leaves fewer steps
+	TEST_ASSERT_TRUE(capacity[8] < capacity[4]);
+
+	// The share scales the measured rate
+	Simulation sim;
+	TEST_ASSERT_FLOAT_WITHIN(capacity[4] * 0.01f, capacity[4] / 2,
+							 calibrate(4, 0.5f));
+}
+
+void test_admission_at_calibrated_capacity() {
+	Simulation sim;
+	float capacity = calibrate(STEPPER_MAX_STEPPERS, STEPPER_CAPACITY_SHARE);
+	TEST_ASSERT_TRUE(capacity > 0 && capacity < INFINITY);
+
+	sim.addLoad("ui", UI_LOAD_US, UI_PERIOD_US);
+	StepAdmission<STEPPER_MAX_STEPPERS> &admission =
+		StepperRunner::getInstance().getAdmission();
+	admission.setCapacity(capacity);
+	admission.setPolicy(AdmissionPolicy::Clamp);
+
+	// Every stepper moving, as calibrated, the last one over capacity
+	std::vector<std::unique_ptr<SimStepper>> steppers;
+	for (size_t i = 0; i < STEPPER_MAX_STEPPERS; i++) {
+		float speed = capacity / (STEPPER_MAX_STEPPERS - 1);
+		steppers.emplace_back(new SimStepper(20 + 2 * i, 21 + 2 * i, speed,
+											 1000000, RUN_COST_NS,
+											 STEP_COST_NS));
+		steppers.back()->send(MotionCommand::moveTo(100000000));
+		steppers.back()->enable(true);
+	}
+	sim.run(50000);
+	TEST_ASSERT_TRUE(admission.getTotal() <= capacity + 0.5f);
+
+	// What was granted is sustainable for the loop
+	std::vector<long> start;
+	for (const std::unique_ptr<SimStepper> &stepper : steppers) {
+		start.push_back(stepper->getStepper().currentPosition());
+	}
+	sim.run(400000);
+	float delivered = 0;
+	for (size_t i = 0; i < steppers.size(); i++) {
+		delivered +=
+			(steppers[i]->getStepper().currentPosition() - start[i]) / 0.4f;
+	}
+	TEST_ASSERT_TRUE(delivered >=
+					 STEPPER_CAPACITY_TOLERANCE * admission.getTotal());
+	TEST_ASSERT_TRUE(delivered <= capacity * 1.02f);
+}
+
+void test_moves_hold_their_speed() {
+	Simulation sim;
+	StepAdmission<STEPPER_MAX_STEPPERS> &admission =
+		StepperRunner::getInstance().getAdmission();
+	admission.setCapacity(2500);
+	admission.setPolicy(AdmissionPolicy::Clamp);
+
+	SimStepper first(20, 21, 1000, 1000000);
+	SimStepper second(22, 23, 1000, 1000000);
+	SimStepper third(24, 25, 1000, 1000000);
+	for (SimStepper *stepper : {&first, &second, &third}) {
+		stepper->enable(true);
+	}
+	first.send(MotionCommand::moveTo(100000));
+	second.send(MotionCommand::moveTo(100000));
+	sim.run(1000);
+	third.send(MotionCommand::moveTo(200));
+	sim.run(100000);
+	// The third move only gets what is left of the capacity
+	TEST_ASSERT_EQUAL_FLOAT(2500, admission.getTotal());
+	TEST_ASSERT_EQUAL_FLOAT(500, third.getStepper().maxSpeed());
+
+	// Released when the target is reached, on Stop and on disable
+	sim.run(500000);
+	TEST_ASSERT_EQUAL(200, third.getStepper().currentPosition());
+	TEST_ASSERT_EQUAL_FLOAT(2000, admission.getTotal());
+	first.send(MotionCommand::stop());
+	sim.run(1000);
+	TEST_ASSERT_EQUAL_FLOAT(1000, admission.getTotal());
+	second.enable(false);
+	sim.run(1000);
+	TEST_ASSERT_EQUAL_FLOAT(0, admission.getTotal());
+
+	// A new move gets the full speed back
+	third.send(MotionCommand::moveTo(0));
+	sim.run(1000);
+	TEST_ASSERT_EQUAL_FLOAT(1000, third.getStepper().maxSpeed());
+	TEST_ASSERT_EQUAL_FLOAT(1000, admission.getTotal());
+}
+
+int main(int argc, char **argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_calibration_finds_loop_rate);
+	RUN_TEST(test_admission_at_calibrated_capacity);
+	RUN_TEST(test_moves_hold_their_speed);
+	return UNITY_END();
+}
@@ -0,0 +1,78 @@
+/**
+ * Board Capabilities Native Test
+ *
+ * This test runs on the host (pio test -e native) and validates the compile
+ * time GPIO capability tables against the chip datasheets.
+ *
+ * Test Steps:
+ * 1. Validate ESP32 flash, input only, touch and ADC pins
+ * 2. Validate ESP32-S3, ESP32-C3 and ESP8266 specific pins
+ * 3. Validate the M5Stack Core variant marks its wired pins
+ * 4. Validate the runtime table of the selected board
+ */
+
+#include <unity.h>
+
+#include "../../../src/models/BoardCapabilities.h"
+
+void setUp() {}
+void tearDown() {}
+
+void test_esp32_pins() {
+	TEST_ASSERT_TRUE(pinCapabilities<ESP32Pins>(6) & BOARD_CAP_FLASH);
+	TEST_ASSERT_FALSE(pinCapabilities<ESP32Pins>(6) & BOARD_CAP_OUTPUT);
+	TEST_ASSERT_TRUE(pinCapabilities<ESP32Pins>(36) & BOARD_CAP_INPUT_ONLY);
+	TEST_ASSERT_FALSE(pinCapabilities<ESP32Pins>(36) & BOARD_CAP_PWM);
+	TEST_ASSERT_TRUE(pinCapabilities<ESP32Pins>(4) & BOARD_CAP_TOUCH);
+	TEST_ASSERT_TRUE(pinCapabilities<ESP32Pins>(4) & BOARD_CAP_ADC2);
+	TEST_ASSERT_TRUE(pinCapabilities<ESP32Pins>(32) & BOARD_CAP_ADC1);
+	TEST_ASSERT_TRUE(pinCapabilities<ESP32Pins>(12) & BOARD_CAP_STRAPPING);
+	TEST_ASSERT_TRUE(pinCapabilities<ESP32Pins>(25) & BOARD_CAP_DAC);
+	TEST_ASSERT_EQUAL_UINT16(0, pinCapabilities<ESP32Pins>(20));
+	TEST_ASSERT_EQUAL_UINT16(0, pinCapabilities<ESP32Pins>(40));
+}
+
+void test_other_chips() {
+	TEST_ASSERT_TRUE(pinCapabilities<ESP32S3Pins>(48) & BOARD_CAP_PWM);
+	TEST_ASSERT_TRUE(pinCapabilities<ESP32S3Pins>(19) & BOARD_CAP_USB);
+	TEST_ASSERT_TRUE(pinCapabilities<ESP32S3Pins>(6) & BOARD_CAP_OUTPUT);
+	TEST_ASSERT_TRUE(pinCapabilities<ESP32S3Pins>(28) & BOARD_CAP_FLASH);
+	TEST_ASSERT_EQUAL_UINT16(0, pinCapabilities<ESP32S3Pins>(23));
+
+	TEST_ASSERT_TRUE(pinCapabilities<ESP32C3Pins>(9) & BOARD_CAP_STRAPPING);
+	TEST_ASSERT_TRUE(pinCapabilities<ESP32C3Pins>(12) & BOARD_CAP_FLASH);
+	TEST_ASSERT_FALSE(pinCapabilities<ESP32C3Pins>(2) & BOARD_CAP_TOUCH);
+	TEST_ASSERT_EQUAL_UINT16(0, pinCapabilities<ESP32C3Pins>(22));
+
+	TEST_ASSERT_FALSE(pinCapabilities<ESP8266Pins>(16) & BOARD_CAP_PWM);
+	TEST_ASSERT_TRUE(pinCapabilities<ESP8266Pins>(16) & BOARD_CAP_RTC);
+	TEST_ASSERT_EQUAL_UINT16(0, pinCapabilities<ESP8266Pins>(17));
+}
+
+void test_m5stack_variant() {
+	TEST_ASSERT_TRUE(pinCapabilities<M5StackCorePins>(23) & BOARD_CAP_ONBOARD);
+	TEST_ASSERT_FALSE(pinCapabilities<ESP32Pins>(23) & BOARD_CAP_ONBOARD);
+	TEST_ASSERT_FALSE(pinCapabilities<M5StackCorePins>(26) &
+					  BOARD_CAP_ONBOARD);
+	// Chip capabilities are inherited
+	TEST_ASSERT_EQUAL_UINT16(pinCapabilities<ESP32Pins>(26),
+							 pinCapabilities<M5StackCorePins>(26));
+}
+
+void test_selected_board_table() {
+	for (int gpio = 0; gpio < 256; gpio++) {
+		TEST_ASSERT_EQUAL_UINT16(pinCapabilities<BoardPins>(gpio),
+								 boardCapabilities(gpio));
+	}
+	TEST_ASSERT_FALSE(boardPinUsable(BoardPins::NUM_GPIO));
+	TEST_ASSERT_TRUE(boardPinUsable(5));
+}
+
+int main(int argc, char **argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_esp32_pins);
+	RUN_TEST(test_other_chips);
+	RUN_TEST(test_m5stack_variant);
+	RUN_TEST(test_selected_board_table);
+	return UNITY_END();
+}
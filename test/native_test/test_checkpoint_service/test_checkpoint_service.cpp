@@ -0,0 +1,153 @@
+/**
+ * Checkpoint Service Native Test
+ *
+ * This test runs on the host (pio test -e native) and validates the throttled
+ * checkpointing of runtime state into the state journal, using a fake
+ * stepper as state provider.
+ *
+ * Test Steps:
+ * 1. Validate providers are only sampled once the interval elapsed
+ * 2. Validate a moving value is written only past its threshold
+ * 3. Validate the exact value is written once it settles
+ * 4. Restore the position in a new service, as on reboot
+ * 5. Validate forget drops the stored values
+ */
+
+#include <unity.h>
+
+#include "../../../src/manager/CheckpointService.h"
+
+const char *journalPath = "checkpoint_test.bin";
+
+class FakeStepper : public ICheckpointProvider {
+  public:
+	int32_t position = 0;
+	bool restored = false;
+
+	const char *checkpointID() override { return "STEPPER1"; }
+	uint8_t checkpointChannels(const CheckpointChannel *&channels) override {
+		static const CheckpointChannel fakeChannels[] = {{"pos", 50}};
+		channels = fakeChannels;
+		return 1;
+	}
+	bool sampleCheckpoint(uint8_t channel, int32_t &value) override {
+		value = position;
+		return true;
+	}
+	void restoreCheckpoint(uint8_t channel, int32_t value) override {
+		position = value;
+		restored = true;
+	}
+};
+
+void setUp() {}
+void tearDown() {}
+
+void test_sampling_follows_interval() {
+	HostJournalFile file(journalPath);
+	StateJournal journal(file);
+	journal.clear();
+	CheckpointService service(journal, 500);
+	FakeStepper stepper;
+	service.add(&stepper);
+
+	TEST_ASSERT_TRUE(service.update(1000));
+	TEST_ASSERT_FALSE(service.update(1200));
+	TEST_ASSERT_TRUE(service.update(1500));
+	TEST_ASSERT_EQUAL_UINT32(2, service.getSamples());
+
+	// First sample writes the initial value, the second one is unchanged
+	TEST_ASSERT_EQUAL_UINT32(1, service.getWrites());
+}
+
+void test_moving_value_is_throttled() {
+	HostJournalFile file(journalPath);
+	StateJournal journal(file);
+	journal.clear();
+	CheckpointService service(journal);
+	FakeStepper stepper;
+	service.add(&stepper);
+	service.sample();
+
+	// 10 steps per sample, below the 50 steps threshold
+	for (int i = 0; i < 4; i++) {
+		stepper.position += 10;
+		service.sample();
+	}
+	TEST_ASSERT_EQUAL_UINT32(1, service.getWrites());
+
+	stepper.position += 10;
+	service.sample();
+	TEST_ASSERT_EQUAL_UINT32(2, service.getWrites());
+
+	int32_t stored = 0;
+	TEST_ASSERT_TRUE(journal.get("STEPPER1/pos", stored));
+	TEST_ASSERT_EQUAL_INT32(50, stored);
+}
+
+void test_settled_value_is_written() {
+	HostJournalFile file(journalPath);
+	StateJournal journal(file);
+	journal.replay();
+	CheckpointService service(journal);
+	FakeStepper stepper;
+	service.add(&stepper);
+	service.restore(&stepper);
+
+	stepper.position = 57;
+	service.sample();
+	int32_t stored = 0;
+	journal.get("STEPPER1/pos", stored);
+	TEST_ASSERT_EQUAL_INT32(50, stored);
+
+	// Same value on the next sample: the stepper stopped there
+	service.sample();
+	journal.get("STEPPER1/pos", stored);
+	TEST_ASSERT_EQUAL_INT32(57, stored);
+}
+
+void test_restore_after_reboot() {
+	HostJournalFile file(journalPath);
+	StateJournal journal(file);
+	journal.replay();
+	CheckpointService service(journal);
+	FakeStepper stepper;
+	service.add(&stepper);
+
+	TEST_ASSERT_EQUAL_UINT8(1, service.restore(&stepper));
+	TEST_ASSERT_TRUE(stepper.restored);
+	TEST_ASSERT_EQUAL_INT32(57, stepper.position);
+
+	// Restored value is not written again
+	service.sample();
+	TEST_ASSERT_EQUAL_UINT32(0, service.getWrites());
+}
+
+void test_forget_drops_values() {
+	HostJournalFile file(journalPath);
+	StateJournal journal(file);
+	journal.replay();
+	CheckpointService service(journal);
+	FakeStepper stepper;
+	service.add(&stepper);
+
+	service.forget(&stepper);
+	TEST_ASSERT_FALSE(journal.contains("STEPPER1/pos"));
+
+	service.remove(&stepper);
+	TEST_ASSERT_EQUAL_UINT32(0, service.size());
+	TEST_ASSERT_EQUAL_UINT8(0, service.restore(&stepper));
+}
+
+int main(int argc, char **argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_sampling_follows_interval);
+	RUN_TEST(test_moving_value_is_throttled);
+	RUN_TEST(test_settled_value_is_written);
+	RUN_TEST(test_restore_after_reboot);
+	RUN_TEST(test_forget_drops_values);
+
+	HostJournalFile file(journalPath);
+	file.remove();
+	return UNITY_END();
+}
@@ -0,0 +1,185 @@
+/**
+ * Loop Profiler Native Test
+ *
+ * This test runs on the host (pio test -e native) and validates the
+ * latency histograms and scoped stage timing of the loop profiler.
+ *
+ * Test Steps:
+ * 1. Validate percentiles stay within the bucket precision
+ * 2. Validate counts halve instead of overflowing
+ * 3. Validate scopes record the ticks of their stage and deferred resets
+ * 4. Validate the scheduler profiles its passes and tasks
+ * 5. Benchmark the cost of a scope with the host clock
+ */
+
+#include <unity.h>
+
+#include "../../../src/manager/LoopProfiler.h"
+#include "../../../src/manager/Scheduler.h"
+
+#include <stdio.h>
+
+uint32_t fakeTicks = 0;
+uint32_t fakeTickSource() { return fakeTicks; }
+
+void setUp() { fakeTicks = 0; }
+void tearDown() {}
+
+/** True if value is within the 1/8 relative precision of the buckets */
+bool near(uint32_t expected, uint32_t value) {
+	uint32_t error = value > expected ? value - expected : expected - value;
+	return error <= expected / LatencyHistogram::SUB_BUCKETS + 1;
+}
+
+void test_percentiles() {
+	LatencyHistogram histogram;
+	TEST_ASSERT_EQUAL(0, histogram.percentile(50));
+
+	for (uint32_t value = 1; value <= 1000; value++) {
+		histogram.record(value);
+	}
+	TEST_ASSERT_EQUAL(1000, histogram.getSamples());
+	TEST_ASSERT_EQUAL(1000, histogram.getMax());
+	TEST_ASSERT_TRUE(near(500, histogram.percentile(50)));
+	TEST_ASSERT_TRUE(near(990, histogram.percentile(99)));
+	TEST_ASSERT_EQUAL(1000, histogram.percentile(100));
+
+	// Small values are exact, large ones keep their relative precision
+	LatencyHistogram exact;
+	exact.record(3);
+	TEST_ASSERT_EQUAL(3, exact.percentile(50));
+	LatencyHistogram tail;
+	for (int i = 0; i < 99; i++) {
+		tail.record(200);
+	}
+	tail.record(4000000000u);
+	TEST_ASSERT_TRUE(near(200, tail.percentile(50)));
+	TEST_ASSERT_TRUE(near(200, tail.percentile(99)));
+	TEST_ASSERT_EQUAL(4000000000u, tail.percentile(100));
+
+	histogram.reset();
+	TEST_ASSERT_EQUAL(0, histogram.getSamples());
+	TEST_ASSERT_EQUAL(0, histogram.percentile(99));
+}
+
+void test_counts_halve() {
+	LatencyHistogram histogram;
+	for (uint32_t i = 0; i < 200000; i++) {
+		histogram.record(i % 4 == 0 ? 1000 : 10);
+	}
+	TEST_ASSERT_EQUAL(200000, histogram.getSamples());
+	TEST_ASSERT_TRUE(near(10, histogram.percentile(50)));
+	TEST_ASSERT_TRUE(near(1000, histogram.percentile(90)));
+}
+
+void test_scopes_record_stage() {
+	LoopProfiler profiler(fakeTickSource, 10);
+	LoopProfiler::StageId wifi = profiler.stage("wifi");
+	LoopProfiler::StageId serial = profiler.stage("serial");
+	TEST_ASSERT_EQUAL(wifi, profiler.stage("wifi"));
+	TEST_ASSERT_TRUE(wifi != serial);
+	TEST_ASSERT_EQUAL_STRING("serial", profiler.getName(serial));
+
+	for (int i = 0; i < 10; i++) {
+		LoopProfiler::Scope scope(&profiler, wifi);
+		fakeTicks += 250;
+	}
+	{
+		LoopProfiler::Scope scope(&profiler, serial);
+		fakeTicks += 5;
+	}
+	{
+		// Unprofiled stages and missing profilers are ignored
+		LoopProfiler::Scope none(&profiler, -1);
+		LoopProfiler::Scope detached(nullptr, wifi);
+		fakeTicks += 100000;
+	}
+
+	TEST_ASSERT_EQUAL(10, profiler.getHistogram(wifi).getSamples());
+	TEST_ASSERT_EQUAL(250, profiler.getHistogram(wifi).getMax());
+	TEST_ASSERT_EQUAL(
+		25, profiler.toMicros(profiler.getHistogram(wifi).getMax()));
+	TEST_ASSERT_EQUAL(1, profiler.toMicros(5)); // Rounded up
+	TEST_ASSERT_EQUAL(1, profiler.getHistogram(serial).getSamples());
+
+	// Long names are truncated, stages are bounded
+	LoopProfiler::StageId longName = profiler.stage("a-very-long-stage-name");
+	TEST_ASSERT_EQUAL(LoopProfiler::NAME_LENGTH - 1,
+					  strlen(profiler.getName(longName)));
+	while (profiler.size() < LOOP_PROFILER_MAX_STAGES) {
+		char name[LoopProfiler::NAME_LENGTH];
+		snprintf(name, sizeof(name), "stage %u", (unsigned)profiler.size());
+		TEST_ASSERT_TRUE(profiler.stage(name) >= 0);
+	}
+	TEST_ASSERT_EQUAL(-1, profiler.stage("one too many"));
+	TEST_ASSERT_EQUAL(wifi, profiler.stage("wifi"));
+
+	// Reset applies on the next sample of the stage
+	profiler.reset();
+	TEST_ASSERT_EQUAL(0, profiler.getHistogram(wifi).getSamples());
+	profiler.record(wifi, 7);
+	TEST_ASSERT_EQUAL(1, profiler.getHistogram(wifi).getSamples());
+	TEST_ASSERT_EQUAL(7, profiler.getHistogram(wifi).getMax());
+	TEST_ASSERT_EQUAL(0, profiler.getHistogram(serial).getSamples());
+}
+
+void test_scheduler_stages() {
+	LoopProfiler profiler(fakeTickSource, 1);
+	Scheduler scheduler(fakeTickSource);
+	scheduler.addTask("early", TaskClass::Background,
+					  []() { fakeTicks += 40; });
+	scheduler.setProfiler(&profiler);
+	scheduler.addTask("late", TaskClass::Background,
+					  []() { fakeTicks += 300; });
+
+	for (int i = 0; i < 4; i++) {
+		scheduler.run();
+	}
+
+	LoopProfiler::StageId loop = profiler.stage("loop");
+	LoopProfiler::StageId early = profiler.stage("early");
+	LoopProfiler::StageId late = profiler.stage("late");
+	TEST_ASSERT_EQUAL(3, profiler.size());
+	TEST_ASSERT_EQUAL(4, profiler.getHistogram(loop).getSamples());
+	TEST_ASSERT_EQUAL(340, profiler.getHistogram(loop).getMax());
+	TEST_ASSERT_EQUAL(4, profiler.getHistogram(early).getSamples());
+	TEST_ASSERT_EQUAL(40, profiler.getHistogram(early).getMax());
+	TEST_ASSERT_EQUAL(300, profiler.getHistogram(late).percentile(50));
+
+	scheduler.setProfiler(nullptr);
+	scheduler.run();
+	TEST_ASSERT_EQUAL(4, profiler.getHistogram(loop).getSamples());
+}
+
+void test_scope_cost() {
+	LoopProfiler profiler(hostProfilerTicks, 1000);
+	LoopProfiler::StageId stage = profiler.stage("empty");
+	const int runs = 200000;
+	volatile uint32_t sink = 0;
+
+	uint32_t start = hostProfilerTicks();
+	for (int i = 0; i < runs; i++) {
+		LoopProfiler::Scope scope(&profiler, stage);
+		sink = sink + 1;
+	}
+	uint32_t elapsed = hostProfilerTicks() - start;
+
+	const LatencyHistogram &histogram = profiler.getHistogram(stage);
+	TEST_ASSERT_EQUAL(runs, histogram.getSamples());
+	char report[128];
+	snprintf(report, sizeof(report),
+			 "scope %.1f ns per stage run, p50 %u ns p99 %u ns",
+			 (double)elapsed / runs, (unsigned)histogram.percentile(50),
+			 (unsigned)histogram.percentile(99));
+	TEST_MESSAGE(report);
+}
+
+int main(int argc, char **argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_percentiles);
+	RUN_TEST(test_counts_halve);
+	RUN_TEST(test_scopes_record_stage);
+	RUN_TEST(test_scheduler_stages);
+	RUN_TEST(test_scope_cost);
+	return UNITY_END();
+}
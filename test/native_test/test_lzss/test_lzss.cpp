@@ -0,0 +1,129 @@
+/**
+ * LZSS Native Test
+ *
+ * This test runs on the host (pio test -e native) and validates the LZSS
+ * codec and base64 encoding used to store compressed configurations.
+ *
+ * Test Steps:
+ * 1. Round trip a stored configuration and report the compression ratio
+ * 2. Round trip edge cases: empty, short and incompressible input
+ * 3. Validate corrupt input is rejected instead of overrunning
+ * 4. Round trip base64 for every padding length
+ */
+
+#include <unity.h>
+
+#include "../../../src/manager/Lzss.h"
+
+#include <stdio.h>
+#include <string.h>
+
+std::string makeConfig(int espinners) {
+	std::string config = "[";
+	char entry[160];
+	for (int i = 0; i < espinners; i++) {
+		snprintf(entry, sizeof(entry),
+				 "%s{\"ESPinner_Mod\":\"ESPINNER_STEPPER\",\"ID\":\"STEPPER%d\","
+				 "\"STEP\":%d,\"DIR\":%d,\"EN\":%d,\"DRIVER\":\"ACCELSTEPPER\","
+				 "\"STEPS_PER_REV\":200}",
+				 i == 0 ? "" : ",", i, 12 + i, 14 + i, 27);
+		config += entry;
+	}
+	config += "]";
+	return config;
+}
+
+void roundtrip(const std::string &input) {
+	std::string packed;
+	std::string unpacked;
+	lzssCompress(reinterpret_cast<const uint8_t *>(input.data()),
+				 input.size(), packed);
+	TEST_ASSERT_TRUE(lzssDecompress(
+		reinterpret_cast<const uint8_t *>(packed.data()), packed.size(),
+		unpacked, input.size()));
+	TEST_ASSERT_TRUE(unpacked == input);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_config_roundtrip_and_ratio() {
+	std::string config = makeConfig(12);
+	roundtrip(config);
+
+	std::string packed;
+	std::string text;
+	lzssCompress(reinterpret_cast<const uint8_t *>(config.data()),
+				 config.size(), packed);
+	base64Encode(reinterpret_cast<const uint8_t *>(packed.data()),
+				 packed.size(), text);
+
+	char report[120];
+	snprintf(report, sizeof(report),
+			 "config %u B -> lzss %u B -> base64 %u B",
+			 static_cast<unsigned>(config.size()),
+			 static_cast<unsigned>(packed.size()),
+			 static_cast<unsigned>(text.size()));
+	TEST_MESSAGE(report);
+	TEST_ASSERT_LESS_THAN_UINT32(config.size() / 2, text.size());
+}
+
+void test_edge_cases_roundtrip() {
+	roundtrip("");
+	roundtrip("a");
+	roundtrip("abc");
+	roundtrip(std::string(1000, 'x'));
+
+	std::string noise;
+	uint32_t seed = 12345;
+	for (int i = 0; i < 5000; i++) {
+		seed = seed * 1103515245u + 12345u;
+		noise.push_back(static_cast<char>(seed >> 16));
+	}
+	roundtrip(noise);
+}
+
+void test_corrupt_input_is_rejected() {
+	// Back reference with nothing decoded yet
+	const uint8_t badReference[] = {0x00, 0x00, 0x10};
+	std::string output;
+	TEST_ASSERT_FALSE(lzssDecompress(badReference, sizeof(badReference),
+									 output, 100));
+
+	// Output limit
+	std::string config = makeConfig(4);
+	std::string packed;
+	lzssCompress(reinterpret_cast<const uint8_t *>(config.data()),
+				 config.size(), packed);
+	TEST_ASSERT_FALSE(
+		lzssDecompress(reinterpret_cast<const uint8_t *>(packed.data()),
+					   packed.size(), output, config.size() - 1));
+}
+
+void test_base64_roundtrip() {
+	const char *inputs[] = {"", "f", "fo", "foo", "foob", "fooba", "foobar"};
+	const char *expected[] = {"",	  "Zg==",	  "Zm8=",	 "Zm9v",
+							  "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy"};
+	for (int i = 0; i < 7; i++) {
+		std::string text;
+		std::string decoded;
+		base64Encode(reinterpret_cast<const uint8_t *>(inputs[i]),
+					 strlen(inputs[i]), text);
+		TEST_ASSERT_EQUAL_STRING(expected[i], text.c_str());
+		TEST_ASSERT_TRUE(base64Decode(text.data(), text.size(), decoded));
+		TEST_ASSERT_EQUAL_STRING(inputs[i], decoded.c_str());
+	}
+
+	std::string decoded;
+	TEST_ASSERT_FALSE(base64Decode("Zm9", 3, decoded));
+	TEST_ASSERT_FALSE(base64Decode("Zm!v", 4, decoded));
+}
+
+int main(int argc, char **argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_config_roundtrip_and_ratio);
+	RUN_TEST(test_edge_cases_roundtrip);
+	RUN_TEST(test_corrupt_input_is_rejected);
+	RUN_TEST(test_base64_roundtrip);
+	return UNITY_END();
+}
@@ -0,0 +1,167 @@
+/**
+ * Motion Command Queue Native Test
+ *
+ * This test runs on the host (pio test -e native) and validates the
+ * per-stepper command queue between UI callbacks and the runner.
+ *
+ * Test Steps:
+ * 1. Validate commands apply in order with their arguments
+ * 2. Validate the overflow policy: drop and count, latch Stop
+ * 3. Validate concurrent senders against a draining thread
+ */
+
+#include <unity.h>
+
+#include "../../../src/manager/MotionCommandQueue.h"
+
+#include <thread>
+#include <vector>
+
+/** AccelStepper stand-in, updated by the drain side only */
+struct FakeStepper {
+	long target = 0;
+	long position = 0;
+	float speed = 0;
+	float maxSpeed = 0;
+	int stops = 0;
+	bool outputs = true;
+	std::vector<MotionCommandType> applied;
+
+	void apply(const MotionCommand &command) {
+		applied.push_back(command.type);
+		switch (command.type) {
+		case MotionCommandType::MoveTo:
+			target = command.steps;
+			break;
+		case MotionCommandType::Move:
+			target = position + command.steps;
+			break;
+		case MotionCommandType::SetSpeed:
+			speed = command.speed;
+			break;
+		case MotionCommandType::SetMaxSpeed:
+			maxSpeed = command.speed;
+			break;
+		case MotionCommandType::Stop:
+			target = position;
+			stops++;
+			break;
+		case MotionCommandType::SetPosition:
+			position = target = command.steps;
+			break;
+		case MotionCommandType::DisableOutputs:
+			outputs = false;
+			break;
+		}
+	}
+};
+
+void setUp() {}
+void tearDown() {}
+
+void test_commands_apply_in_order() {
+	MotionCommandQueue<8> queue;
+	FakeStepper stepper;
+	auto apply = [&stepper](const MotionCommand &c) { stepper.apply(c); };
+
+	TEST_ASSERT_FALSE(queue.pending());
+	queue.send(MotionCommand::setPosition(100));
+	queue.send(MotionCommand::move(-30));
+	queue.send(MotionCommand::setSpeed(250.5f));
+	TEST_ASSERT_TRUE(queue.pending());
+	TEST_ASSERT_EQUAL(0, stepper.target); // Nothing applied yet
+
+	TEST_ASSERT_EQUAL(3, queue.drain(apply));
+	TEST_ASSERT_EQUAL(70, stepper.target);
+	TEST_ASSERT_EQUAL(100, stepper.position);
+	TEST_ASSERT_TRUE(stepper.speed == 250.5f);
+	TEST_ASSERT_FALSE(queue.pending());
+
+	queue.send(MotionCommand::stop());
+	queue.send(MotionCommand::disableOutputs());
+	queue.drain(apply);
+	TEST_ASSERT_EQUAL(100, stepper.target);
+	TEST_ASSERT_FALSE(stepper.outputs);
+
+	MotionCommandStats stats = queue.getStats();
+	TEST_ASSERT_EQUAL(5, stats.sent);
+	TEST_ASSERT_EQUAL(5, stats.applied);
+	TEST_ASSERT_EQUAL(3, stats.maxDepth);
+}
+
+void test_overflow_policy() {
+	MotionCommandQueue<4> queue; // Holds 3
+	FakeStepper stepper;
+	auto apply = [&stepper](const MotionCommand &c) { stepper.apply(c); };
+
+	TEST_ASSERT_TRUE(queue.send(MotionCommand::moveTo(10)));
+	TEST_ASSERT_TRUE(queue.send(MotionCommand::moveTo(20)));
+	TEST_ASSERT_TRUE(queue.send(MotionCommand::moveTo(30)));
+	TEST_ASSERT_FALSE(queue.send(MotionCommand::moveTo(40)));
+	TEST_ASSERT_EQUAL(1, queue.getStats().dropped);
+
+	queue.drain(apply);
+	TEST_ASSERT_EQUAL(30, stepper.target);
+
+	// A Stop that does not fit overrides what is queued
+	queue.send(MotionCommand::moveTo(50));
+	queue.send(MotionCommand::moveTo(60));
+	queue.send(MotionCommand::moveTo(70));
+	TEST_ASSERT_TRUE(queue.send(MotionCommand::stop()));
+	stepper.applied.clear();
+	TEST_ASSERT_EQUAL(1, queue.drain(apply));
+	TEST_ASSERT_EQUAL(1, stepper.applied.size());
+	TEST_ASSERT_TRUE(stepper.applied[0] == MotionCommandType::Stop);
+	TEST_ASSERT_EQUAL(0, stepper.target);
+
+	MotionCommandStats stats = queue.getStats();
+	TEST_ASSERT_EQUAL(3, stats.flushed);
+	TEST_ASSERT_EQUAL(1, stats.dropped);
+	TEST_ASSERT_EQUAL(7, stats.sent);
+	TEST_ASSERT_EQUAL(4, stats.applied);
+}
+
+void test_concurrent_senders() {
+	MotionCommandQueue<16> queue;
+	const int perSender = 20000;
+	std::atomic<bool> done{false};
+	long sum = 0;
+	long applied = 0;
+
+	std::thread runner([&]() {
+		auto apply = [&](const MotionCommand &c) {
+			sum += c.steps;
+			applied++;
+		};
+		while (!done.load()) {
+			queue.drain(apply);
+		}
+		queue.drain(apply);
+	});
+	auto sender = [&queue]() {
+		for (int i = 0; i < perSender; i++) {
+			while (!queue.send(MotionCommand::move(1))) {
+				std::this_thread::yield();
+			}
+		}
+	};
+	std::thread ui(sender);
+	std::thread serial(sender);
+	ui.join();
+	serial.join();
+	done = true;
+	runner.join();
+
+	TEST_ASSERT_EQUAL(2 * perSender, applied);
+	TEST_ASSERT_EQUAL(2 * perSender, sum);
+	TEST_ASSERT_EQUAL(2 * perSender, queue.getStats().sent);
+	TEST_ASSERT_EQUAL(queue.getStats().sent, queue.getStats().applied);
+}
+
+int main(int argc, char **argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_commands_apply_in_order);
+	RUN_TEST(test_overflow_policy);
+	RUN_TEST(test_concurrent_senders);
+	return UNITY_END();
+}
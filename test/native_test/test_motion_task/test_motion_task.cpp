@@ -0,0 +1,139 @@
+/**
+ * Motion Task Native Test
+ *
+ * This test runs on the host (pio test -e native) where a std::thread
+ * stands in for the FreeRTOS motion task of the ESP32.
+ *
+ * Test Steps:
+ * 1. Validate the SPSC queue order and capacity
+ * 2. Validate commands run on the motion task, in order
+ * 3. Validate commands run inline while the task is stopped
+ * 4. Measure step gaps and command latency while loop() blocks
+ */
+
+#include <unity.h>
+
+#include "../../../src/manager/MotionTask.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <thread>
+
+uint32_t hostMicros() {
+	static const auto origin = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+			   std::chrono::steady_clock::now() - origin)
+		.count();
+}
+
+std::atomic<uint32_t> steps{0};
+std::atomic<bool> moving{true};
+long position = 0; // Motion state, only touched on the motion task
+
+bool countSteps() {
+	steps.fetch_add(1, std::memory_order_relaxed);
+	return moving.load(std::memory_order_relaxed);
+}
+
+void setUp() {
+	steps = 0;
+	moving = true;
+	position = 0;
+}
+void tearDown() {}
+
+void test_spsc_queue() {
+	SpscQueue<int, 4> queue;
+	int value = 0;
+	TEST_ASSERT_EQUAL(3, queue.capacity());
+	TEST_ASSERT_FALSE(queue.pop(value));
+	for (int round = 0; round < 3; round++) {
+		TEST_ASSERT_TRUE(queue.push(1));
+		TEST_ASSERT_TRUE(queue.push(2));
+		TEST_ASSERT_TRUE(queue.push(3));
+		TEST_ASSERT_FALSE(queue.push(4));
+		TEST_ASSERT_EQUAL(3, queue.size());
+		for (int expected = 1; expected <= 3; expected++) {
+			TEST_ASSERT_TRUE(queue.pop(value));
+			TEST_ASSERT_EQUAL(expected, value);
+		}
+		TEST_ASSERT_TRUE(queue.empty());
+	}
+}
+
+void test_commands_run_on_motion_task() {
+	MotionTask task(hostMicros, countSteps);
+	TEST_ASSERT_TRUE(task.start());
+	TEST_ASSERT_FALSE(task.start());
+
+	std::thread::id motionThread;
+	task.execute([&motionThread, &task]() {
+		motionThread = std::this_thread::get_id();
+		TEST_ASSERT_TRUE(task.inMotionTask());
+	});
+	TEST_ASSERT_TRUE(motionThread != std::this_thread::get_id());
+
+	// More commands than the queue holds, each applied in order
+	for (long i = 1; i <= 100; i++) {
+		task.execute([i]() {
+			if (position == i - 1) {
+				position = i;
+			}
+		});
+	}
+	long seen = 0;
+	task.execute([&seen]() { seen = position; });
+	TEST_ASSERT_EQUAL(100, seen);
+	TEST_ASSERT_TRUE(steps.load() > 0);
+
+	task.stop();
+	TEST_ASSERT_FALSE(task.isRunning());
+	TEST_ASSERT_EQUAL(102, task.getStats().commands);
+}
+
+void test_inline_while_stopped() {
+	MotionTask task(hostMicros, countSteps);
+	bool ran = false;
+	task.execute([&ran]() { ran = true; });
+	TEST_ASSERT_TRUE(ran);
+
+	// loop() can drive the step itself when no task runs
+	TEST_ASSERT_TRUE(task.iterate());
+	TEST_ASSERT_EQUAL(1, steps.load());
+}
+
+void test_latency_while_loop_blocks() {
+	MotionTask task(hostMicros, countSteps);
+	task.start();
+	// loop() busy in a 20 ms HTTP request, posting now and then
+	uint32_t worstRoundTrip = 0;
+	uint32_t start = hostMicros();
+	while (hostMicros() - start < 20000) {
+		uint32_t posted = hostMicros();
+		task.execute([]() { position++; });
+		uint32_t roundTrip = hostMicros() - posted;
+		worstRoundTrip = roundTrip > worstRoundTrip ? roundTrip : worstRoundTrip;
+		std::this_thread::sleep_for(std::chrono::microseconds(500));
+	}
+	task.stop();
+
+	MotionTaskStats stats = task.getStats();
+	char report[120];
+	snprintf(report, sizeof(report),
+			 "%u steps, max step gap %u us, max command wait %u us, worst "
+			 "execute() %u us",
+			 (unsigned)steps.load(), (unsigned)stats.maxStepGap,
+			 (unsigned)stats.maxCommandWait, (unsigned)worstRoundTrip);
+	TEST_MESSAGE(report);
+	TEST_ASSERT_TRUE(stats.iterations > 1000);
+	TEST_ASSERT_EQUAL(stats.iterations, steps.load());
+}
+
+int main(int argc, char **argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_spsc_queue);
+	RUN_TEST(test_commands_run_on_motion_task);
+	RUN_TEST(test_inline_while_stopped);
+	RUN_TEST(test_latency_while_loop_blocks);
+	return UNITY_END();
+}
@@ -0,0 +1,186 @@
+/**
+ * Pin Solver Native Test
+ *
+ * This test runs on the host (pio test -e native) and validates the
+ * automatic pin assignment of project configurations, with its solve time
+ * on a full ESP32 board.
+ *
+ * Test Steps:
+ * 1. Validate assigned GPIOs hold the required capabilities
+ * 2. Validate a demand is moved when a later one needs its GPIO
+ * 3. Validate infeasible projects assign as much as possible
+ * 4. Validate requirement names
+ * 5. Benchmark worst case projects on a 40 GPIO board
+ */
+
+#include <unity.h>
+
+#include "../../../src/manager/PinSolver.h"
+
+#include <chrono>
+#include <stdio.h>
+
+typedef PinSolver<ESP32Pins::NUM_GPIO> ESP32Solver;
+
+uint16_t esp32Capabilities(uint8_t gpio) {
+	return pinCapabilities<ESP32Pins>(gpio);
+}
+
+// GPIO 0 output, GPIO 1 output and PWM, GPIO 2 output and ADC
+uint16_t tinyCapabilities(uint8_t gpio) {
+	const uint16_t caps[] = {BOARD_CAP_OUTPUT, BOARD_CAP_OUTPUT | BOARD_CAP_PWM,
+							 BOARD_CAP_OUTPUT | BOARD_CAP_ADC1};
+	return gpio < 3 ? BOARD_CAP_EXISTS | caps[gpio] : 0;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_assignments_hold_capabilities() {
+	ESP32Solver solver(esp32Capabilities);
+	solver.block(0);
+	solver.block(12);
+	int pwm = solver.addDemand(BOARD_CAP_PWM);
+	int input = solver.addDemand(0);
+	int adc = solver.addDemand(BOARD_CAP_ADC1);
+	int output = solver.addDemand(BOARD_CAP_OUTPUT);
+	TEST_ASSERT_TRUE(solver.solve());
+
+	int used[] = {solver.getAssignment(pwm), solver.getAssignment(input),
+				  solver.getAssignment(adc), solver.getAssignment(output)};
+	uint16_t required[] = {BOARD_CAP_PWM, 0, BOARD_CAP_ADC1, BOARD_CAP_OUTPUT};
+	for (int i = 0; i < 4; i++) {
+		TEST_ASSERT_TRUE(used[i] > 0);
+		TEST_ASSERT_TRUE(used[i] != 12);
+		TEST_ASSERT_FALSE(pinCapabilities<ESP32Pins>(used[i]) &
+						  (BOARD_CAP_FLASH | BOARD_CAP_STRAPPING));
+		TEST_ASSERT_TRUE((pinCapabilities<ESP32Pins>(used[i]) & required[i]) ==
+						 required[i]);
+		for (int j = 0; j < i; j++) {
+			TEST_ASSERT_TRUE(used[i] != used[j]);
+		}
+	}
+	// A plain input takes an input only GPIO and keeps outputs free
+	TEST_ASSERT_TRUE(pinCapabilities<ESP32Pins>(used[1]) &
+					 BOARD_CAP_INPUT_ONLY);
+
+	// Same input, same assignment
+	ESP32Solver again(esp32Capabilities);
+	again.block(0);
+	again.block(12);
+	again.addDemand(BOARD_CAP_PWM);
+	again.addDemand(0);
+	again.addDemand(BOARD_CAP_ADC1);
+	again.addDemand(BOARD_CAP_OUTPUT);
+	again.solve();
+	for (int i = 0; i < 4; i++) {
+		TEST_ASSERT_EQUAL(used[i], again.getAssignment(i));
+	}
+}
+
+void test_demands_are_moved_to_make_room() {
+	PinSolver<3> solver(tinyCapabilities);
+	int input = solver.addDemand(0);
+	int output = solver.addDemand(BOARD_CAP_OUTPUT);
+	int pwm = solver.addDemand(BOARD_CAP_PWM);
+	TEST_ASSERT_TRUE(solver.solve());
+	// The input takes GPIO 0 first and is moved when the output needs it
+	TEST_ASSERT_EQUAL(2, solver.getAssignment(input));
+	TEST_ASSERT_EQUAL(0, solver.getAssignment(output));
+	TEST_ASSERT_EQUAL(1, solver.getAssignment(pwm));
+}
+
+void test_infeasible_project() {
+	PinSolver<3> solver(tinyCapabilities);
+	solver.addDemand(BOARD_CAP_PWM);
+	solver.addDemand(BOARD_CAP_PWM);
+	TEST_ASSERT_FALSE(solver.solve());
+	TEST_ASSERT_EQUAL(1, solver.getAssignment(0));
+	TEST_ASSERT_EQUAL(-1, solver.getAssignment(1));
+
+	PinSolver<2> crowded(tinyCapabilities);
+	crowded.addDemand(0);
+	crowded.addDemand(0);
+	TEST_ASSERT_EQUAL(-1, crowded.addDemand(0));
+	TEST_ASSERT_EQUAL(2, crowded.size());
+	TEST_ASSERT_FALSE(crowded.solve());
+}
+
+void test_requirement_names() {
+	uint16_t flags = 0xFFFF;
+	TEST_ASSERT_TRUE(parsePinRequirement("auto", flags));
+	TEST_ASSERT_EQUAL(0, flags);
+	TEST_ASSERT_TRUE(parsePinRequirement("pwm", flags));
+	TEST_ASSERT_TRUE(flags & BOARD_CAP_PWM);
+	TEST_ASSERT_TRUE(parsePinRequirement("SPI_CS", flags));
+	TEST_ASSERT_EQUAL(BOARD_CAP_OUTPUT, flags);
+	TEST_ASSERT_FALSE(parsePinRequirement("12", flags));
+	TEST_ASSERT_FALSE(parsePinRequirement(nullptr, flags));
+}
+
+/**
+ * Fills the board: steppers (3 outputs), DC motors (2 PWM), ADC sensors and
+ * limit switches, then more demands than GPIOs
+ */
+size_t addWorstCaseProject(ESP32Solver &solver, int modules) {
+	for (int i = 0; i < modules; i++) {
+		switch (i % 4) {
+		case 0:
+			solver.addDemand(BOARD_CAP_OUTPUT);
+			solver.addDemand(BOARD_CAP_OUTPUT);
+			solver.addDemand(BOARD_CAP_OUTPUT);
+			break;
+		case 1:
+			solver.addDemand(BOARD_CAP_PWM);
+			solver.addDemand(BOARD_CAP_PWM);
+			break;
+		case 2:
+			solver.addDemand(BOARD_CAP_ADC1);
+			break;
+		default:
+			solver.addDemand(0);
+			break;
+		}
+	}
+	return solver.size();
+}
+
+void benchmark(int modules, bool feasible) {
+	const int runs = 200;
+	bool solved = false;
+	size_t demands = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int run = 0; run < runs; run++) {
+		ESP32Solver solver(esp32Capabilities);
+		solver.block(0);
+		demands = addWorstCaseProject(solver, modules);
+		solved = solver.solve();
+	}
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - start);
+	long perSolve = static_cast<long>(elapsed.count() / runs);
+
+	char report[100];
+	snprintf(report, sizeof(report), "%u demands on 40 GPIOs: %ld us/solve",
+			 static_cast<unsigned>(demands), perSolve);
+	TEST_MESSAGE(report);
+	TEST_ASSERT_EQUAL(feasible, solved);
+	TEST_ASSERT_LESS_THAN_UINT32(5000, perSolve);
+}
+
+void test_benchmark_worst_case() {
+	// 26 demands, 20 of them outputs: all 21 output GPIOs but one
+	benchmark(14, true);
+	// 40 demands, more than the 27 usable GPIOs
+	benchmark(22, false);
+}
+
+int main(int argc, char **argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_assignments_hold_capabilities);
+	RUN_TEST(test_demands_are_moved_to_make_room);
+	RUN_TEST(test_infeasible_project);
+	RUN_TEST(test_requirement_names);
+	RUN_TEST(test_benchmark_worst_case);
+	return UNITY_END();
+}
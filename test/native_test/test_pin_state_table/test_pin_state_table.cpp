@@ -0,0 +1,188 @@
+/**
+ * Pin State Table Native Test
+ *
+ * This test runs on the host (pio test -e native) and validates the fixed
+ * size pin state used by ESPAllOnPinManager for conflict checks.
+ *
+ * Test Steps:
+ * 1. Validate flags are independent per pin
+ * 2. Validate blocked pins and the entry count of the former pin map
+ * 3. Validate UI references bind and unbind pins
+ * 4. Validate pins out of range are ignored
+ * 5. Resolve controls to pins, including ids above 255
+ * 6. Validate rebinding keeps both directions consistent
+ * 7. Validate the reverse index against a reference model
+ * 8. Validate the generation only moves on real changes
+ */
+
+#include <unity.h>
+
+#include "../../../src/models/PinStateTable.h"
+
+#include <map>
+
+PinStateTable<40> table;
+
+void setUp() { table.clear(); }
+void tearDown() {}
+
+void test_flags_are_independent() {
+	table.setAttached(12, true);
+	table.setCapabilities(12, PIN_CAP_CONFIGURED | PIN_CAP_OUTPUT);
+
+	TEST_ASSERT_TRUE(table.isAttached(12));
+	TEST_ASSERT_FALSE(table.isAttached(13));
+	TEST_ASSERT_FALSE(table.isBroken(12));
+	TEST_ASSERT_TRUE(table.hasCapability(12, PIN_CAP_OUTPUT));
+	TEST_ASSERT_FALSE(table.hasCapability(12, PIN_CAP_INPUT));
+	TEST_ASSERT_EQUAL_UINT32(1, table.attachedCount());
+
+	table.setAttached(12, false);
+	TEST_ASSERT_FALSE(table.isAttached(12));
+}
+
+void test_blocked_pins_and_size() {
+	table.setBroken(6, true);
+	table.setReserved(2, true);
+	TEST_ASSERT_TRUE(table.isBlocked(6));
+	TEST_ASSERT_TRUE(table.isBlocked(2));
+	TEST_ASSERT_FALSE(table.isBlocked(4));
+	TEST_ASSERT_EQUAL_UINT32(2, table.size());
+
+	// A reference on a blocked pin is not counted twice
+	table.setControlRef(6, 30);
+	TEST_ASSERT_EQUAL_UINT32(2, table.size());
+
+	table.setReserved(2, false);
+	TEST_ASSERT_FALSE(table.isBlocked(2));
+	TEST_ASSERT_EQUAL_UINT32(1, table.size());
+}
+
+void test_control_refs() {
+	table.setControlRef(13, 42);
+	TEST_ASSERT_EQUAL_UINT16(42, table.getControlRef(13));
+	TEST_ASSERT_EQUAL_UINT16(0, table.getControlRef(14));
+	TEST_ASSERT_EQUAL_UINT32(1, table.size());
+
+	// Lookups never add entries
+	for (int pin = 0; pin < 40; pin++) {
+		table.getControlRef(pin);
+	}
+	TEST_ASSERT_EQUAL_UINT32(1, table.size());
+
+	table.clearControlRef(13);
+	TEST_ASSERT_EQUAL_UINT16(0, table.getControlRef(13));
+	TEST_ASSERT_EQUAL_UINT32(0, table.size());
+}
+
+void test_out_of_range_is_ignored() {
+	table.setAttached(40, true);
+	table.setControlRef(-1, 5);
+	table.setBroken(255, true);
+	TEST_ASSERT_FALSE(table.isAttached(40));
+	TEST_ASSERT_EQUAL_UINT16(0, table.getControlRef(-1));
+	TEST_ASSERT_FALSE(table.isBlocked(255));
+	TEST_ASSERT_EQUAL_UINT8(0, table.getCapabilities(40));
+	TEST_ASSERT_EQUAL_UINT32(0, table.size());
+}
+
+void test_reverse_lookup() {
+	table.setControlRef(13, 42);
+	table.setControlRef(14, 300);
+	table.setControlRef(15, 65535);
+
+	TEST_ASSERT_EQUAL_INT32(13, table.getControlPin(42));
+	TEST_ASSERT_EQUAL_INT32(14, table.getControlPin(300));
+	TEST_ASSERT_EQUAL_INT32(15, table.getControlPin(65535));
+	// 300 narrowed to uint8_t is 44, which is bound to nothing
+	TEST_ASSERT_EQUAL_INT32(-1, table.getControlPin(44));
+	TEST_ASSERT_EQUAL_INT32(-1, table.getControlPin(0));
+}
+
+void test_rebinding_is_consistent() {
+	table.setControlRef(13, 42);
+
+	// Selector moved to another pin
+	table.setControlRef(16, 42);
+	TEST_ASSERT_EQUAL_INT32(16, table.getControlPin(42));
+	TEST_ASSERT_EQUAL_UINT16(0, table.getControlRef(13));
+	TEST_ASSERT_EQUAL_UINT32(1, table.size());
+
+	// Pin taken over by another selector
+	table.setControlRef(16, 43);
+	TEST_ASSERT_EQUAL_INT32(-1, table.getControlPin(42));
+	TEST_ASSERT_EQUAL_INT32(16, table.getControlPin(43));
+
+	table.clearControlRef(16);
+	TEST_ASSERT_EQUAL_INT32(-1, table.getControlPin(43));
+	TEST_ASSERT_EQUAL_UINT32(0, table.size());
+}
+
+void test_reverse_index_matches_model() {
+	std::map<int, uint16_t> model;
+	uint32_t seed = 7;
+	for (int step = 0; step < 20000; step++) {
+		seed = seed * 1103515245u + 12345u;
+		int pin = (seed >> 16) % 40;
+		// Ids that collide on the low bits to exercise probing and deletion
+		uint16_t ref = (seed >> 8) % 4 == 0 ? 0 : ((seed >> 4) % 12) * 128 + 1;
+
+		for (auto it = model.begin(); it != model.end();) {
+			if (it->second == ref && ref != 0) {
+				it = model.erase(it);
+			} else {
+				++it;
+			}
+		}
+		if (ref == 0) {
+			model.erase(pin);
+		} else {
+			model[pin] = ref;
+		}
+		table.setControlRef(pin, ref);
+
+		TEST_ASSERT_EQUAL_UINT32(model.size(), table.size());
+		for (uint16_t id = 1; id <= 11 * 128 + 1; id += 128) {
+			int expected = -1;
+			for (const auto &binding : model) {
+				if (binding.second == id) {
+					expected = binding.first;
+				}
+			}
+			if (table.getControlPin(id) != expected) {
+				TEST_FAIL_MESSAGE("reverse index out of sync");
+				return;
+			}
+		}
+	}
+}
+
+void test_generation_tracks_changes() {
+	uint32_t generation = table.generation();
+	table.setAttached(5, false);
+	table.clearControlRef(5);
+	table.getControlPin(42);
+	TEST_ASSERT_EQUAL_UINT32(generation, table.generation());
+
+	table.setAttached(5, true);
+	TEST_ASSERT_TRUE(table.generation() != generation);
+	generation = table.generation();
+	table.setControlRef(5, 42);
+	TEST_ASSERT_TRUE(table.generation() != generation);
+	generation = table.generation();
+	table.setControlRef(5, 42);
+	TEST_ASSERT_EQUAL_UINT32(generation, table.generation());
+}
+
+int main(int argc, char **argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_flags_are_independent);
+	RUN_TEST(test_blocked_pins_and_size);
+	RUN_TEST(test_control_refs);
+	RUN_TEST(test_out_of_range_is_ignored);
+	RUN_TEST(test_reverse_lookup);
+	RUN_TEST(test_rebinding_is_consistent);
+	RUN_TEST(test_reverse_index_matches_model);
+	RUN_TEST(test_generation_tracks_changes);
+	return UNITY_END();
+}
@@ -0,0 +1,97 @@
+/**
+ * Pin Telemetry Native Test
+ *
+ * This test runs on the host (pio test -e native) and validates the pin
+ * level sampler behind the live view of the pin status page.
+ *
+ * Test Steps:
+ * 1. Validate digital pins are reported once, then only when they flip
+ * 2. Validate the sample interval and unwatched pins reported as null
+ * 3. Validate invalidate() reports every watched pin again
+ */
+
+#include <unity.h>
+
+#include "../../../src/manager/PinTelemetry.h"
+
+#include <string.h>
+
+const size_t PINS = 40;
+int32_t levels[PINS];
+
+int32_t fakeReader(uint8_t pin) { return levels[pin]; }
+
+char buffer[256];
+
+const char *diff(PinTelemetry<PINS> &telemetry, uint32_t now) {
+	TEST_ASSERT_TRUE(telemetry.format(buffer, sizeof(buffer), now) > 0);
+	return buffer;
+}
+
+void setUp() { memset(levels, 0, sizeof(levels)); }
+void tearDown() {}
+
+void test_digital_pins_report_flips() {
+	PinTelemetry<PINS> telemetry(fakeReader, 10);
+	telemetry.watch(4, true);
+	telemetry.watch(5, true);
+	levels[5] = 1;
+
+	TEST_ASSERT_EQUAL(2, telemetry.update(0));
+	TEST_ASSERT_EQUAL_STRING("{\"t\":0,\"p\":[[4,0],[5,1]]}",
+							 diff(telemetry, 0));
+
+	TEST_ASSERT_EQUAL(0, telemetry.update(10));
+
+	levels[4] = 1;
+	TEST_ASSERT_EQUAL(1, telemetry.update(20));
+	TEST_ASSERT_EQUAL_STRING("{\"t\":20,\"p\":[[4,1]]}", diff(telemetry, 20));
+	TEST_ASSERT_EQUAL(1, telemetry.getValue(4));
+}
+
+void test_interval_and_unwatch() {
+	PinTelemetry<PINS> telemetry(fakeReader, 50);
+	telemetry.watch(12, true);
+	TEST_ASSERT_EQUAL(1, telemetry.update(100));
+
+	levels[12] = 1;
+	TEST_ASSERT_EQUAL(0, telemetry.update(149));
+	TEST_ASSERT_EQUAL(1, telemetry.update(150));
+
+	telemetry.watch(12, false);
+	TEST_ASSERT_FALSE(telemetry.isWatched(12));
+	TEST_ASSERT_EQUAL(1, telemetry.update(200));
+	TEST_ASSERT_EQUAL_STRING("{\"t\":200,\"p\":[[12,null]]}",
+							 diff(telemetry, 200));
+	TEST_ASSERT_EQUAL(-1, telemetry.getValue(12));
+	TEST_ASSERT_EQUAL(0, telemetry.update(250));
+
+	// Out of range pins are ignored
+	telemetry.watch(-1, true);
+	telemetry.watch(PINS, true);
+	TEST_ASSERT_EQUAL(0, telemetry.update(300));
+}
+
+void test_invalidate_reports_everything() {
+	PinTelemetry<PINS> telemetry(fakeReader, 10);
+	for (int pin = 0; pin < (int)PINS; pin++) {
+		telemetry.watch(pin, true);
+	}
+	TEST_ASSERT_EQUAL(PINS, telemetry.update(0));
+	TEST_ASSERT_EQUAL(0, telemetry.update(10));
+
+	telemetry.invalidate();
+	TEST_ASSERT_EQUAL(PINS, telemetry.update(20));
+
+	// A diff that does not fit is dropped rather than truncated
+	char small[32];
+	TEST_ASSERT_EQUAL(0, telemetry.format(small, sizeof(small), 20));
+}
+
+int main(int argc, char **argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_digital_pins_report_flips);
+	RUN_TEST(test_interval_and_unwatch);
+	RUN_TEST(test_invalidate_reports_everything);
+	return UNITY_END();
+}
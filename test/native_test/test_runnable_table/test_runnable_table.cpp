@@ -0,0 +1,188 @@
+/**
+ * Runnable Table Native Test
+ *
+ * This test runs on the host (pio test -e native) and validates the flat
+ * table behind StepperRunner and NeopixelRunner.
+ *
+ * Test Steps:
+ * 1. Validate only active runnables run, also wrapped, and activity changes
+ * 2. Validate handles survive swaps and removal
+ * 3. Validate runnables deactivating themselves inside run()
+ * 4. Benchmark runAll() per runnable against shared_ptr polling
+ */
+
+#include <unity.h>
+
+#include "../../../src/manager/RunnableTable.h"
+
+#include <chrono>
+#include <memory>
+#include <stdio.h>
+#include <vector>
+
+struct FakeRunnable {
+	virtual ~FakeRunnable() = default;
+	virtual void run() { runs++; }
+	virtual bool isActive() const { return active; }
+	int runs = 0;
+	bool active = true;
+};
+
+typedef RunnableTable<FakeRunnable, 8> Table;
+
+void setUp() {}
+void tearDown() {}
+
+void test_only_active_run() {
+	Table table;
+	FakeRunnable runnables[4];
+	Table::Handle handles[4];
+	for (int i = 0; i < 4; i++) {
+		handles[i] = table.add(&runnables[i], i % 2 == 0);
+	}
+	table.runAll();
+	TEST_ASSERT_EQUAL(2, table.activeCount());
+	TEST_ASSERT_EQUAL(1, runnables[0].runs);
+	TEST_ASSERT_EQUAL(0, runnables[1].runs);
+
+	table.setActive(handles[1], true);
+	table.setActive(handles[0], false);
+	table.setActive(handles[0], false);
+	table.runAll();
+	TEST_ASSERT_EQUAL(1, runnables[0].runs);
+	TEST_ASSERT_EQUAL(1, runnables[1].runs);
+	TEST_ASSERT_EQUAL(2, runnables[2].runs);
+	TEST_ASSERT_EQUAL(0, runnables[3].runs);
+	TEST_ASSERT_TRUE(table.isActive(handles[1]));
+	TEST_ASSERT_FALSE(table.isActive(handles[0]));
+
+	// A wrapped runAll() sees the handle of every entry it runs
+	int visited = 0;
+	table.runAll([&](Table::Handle handle, FakeRunnable *item) {
+		TEST_ASSERT_TRUE(table.get(handle) == item);
+		TEST_ASSERT_TRUE(table.isActive(handle));
+		item->run();
+		visited++;
+	});
+	TEST_ASSERT_EQUAL(2, visited);
+	TEST_ASSERT_EQUAL(3, runnables[2].runs);
+}
+
+void test_handles_and_removal() {
+	Table table;
+	FakeRunnable runnables[9];
+	Table::Handle handles[8];
+	for (int i = 0; i < 8; i++) {
+		handles[i] = table.add(&runnables[i], true);
+		TEST_ASSERT_EQUAL(i, handles[i]);
+	}
+	TEST_ASSERT_EQUAL(-1, table.add(&runnables[8], true));
+	TEST_ASSERT_EQUAL(-1, Table().add(nullptr, true));
+
+	table.setActive(handles[2], false);
+	table.setActive(handles[5], false);
+	TEST_ASSERT_TRUE(table.remove(handles[0]));
+	TEST_ASSERT_FALSE(table.remove(handles[0]));
+	TEST_ASSERT_TRUE(table.remove(handles[5]));
+	for (int i = 0; i < 8; i++) {
+		TEST_ASSERT_TRUE(table.get(handles[i]) ==
+						 (i == 0 || i == 5 ? nullptr : &runnables[i]));
+	}
+	TEST_ASSERT_EQUAL(6, table.size());
+	TEST_ASSERT_EQUAL(5, table.activeCount());
+
+	// A removed handle is given out again
+	TEST_ASSERT_EQUAL(0, table.add(&runnables[8], false));
+	table.runAll();
+	TEST_ASSERT_EQUAL(0, runnables[8].runs);
+	TEST_ASSERT_EQUAL(0, runnables[2].runs);
+	TEST_ASSERT_EQUAL(1, runnables[7].runs);
+
+	table.clear();
+	TEST_ASSERT_EQUAL(0, table.size());
+	TEST_ASSERT_FALSE(table.isValid(handles[1]));
+}
+
+Table *selfTable = nullptr;
+Table::Handle selfHandles[3];
+
+struct SelfStopping : FakeRunnable {
+	int index = 0;
+	void run() override {
+		runs++;
+		selfTable->setActive(selfHandles[index], false);
+	}
+};
+
+void test_deactivation_inside_run() {
+	Table table;
+	selfTable = &table;
+	SelfStopping runnables[3];
+	for (int i = 0; i < 3; i++) {
+		runnables[i].index = i;
+		selfHandles[i] = table.add(&runnables[i], true);
+	}
+	table.runAll();
+	for (int i = 0; i < 3; i++) {
+		TEST_ASSERT_EQUAL(1, runnables[i].runs);
+	}
+	TEST_ASSERT_EQUAL(0, table.activeCount());
+	selfTable = nullptr;
+}
+
+template <typename F> double nsPerRunnable(int runnables, F runAll) {
+	const int passes = 200000;
+	auto start = std::chrono::steady_clock::now();
+	for (int pass = 0; pass < passes; pass++) {
+		runAll();
+	}
+	auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - start);
+	return static_cast<double>(elapsed.count()) / passes / runnables;
+}
+
+void test_benchmark_run_all() {
+	const int count = 8;
+	std::vector<FakeRunnable> runnables(count);
+	for (int i = 0; i < count; i++) {
+		runnables[i].active = i < count / 2;
+	}
+
+	// Former runners: shared_ptr with a no-op deleter, isActive() then run()
+	std::vector<std::shared_ptr<FakeRunnable>> shared;
+	for (FakeRunnable &runnable : runnables) {
+		shared.push_back(
+			std::shared_ptr<FakeRunnable>(&runnable, [](FakeRunnable *) {}));
+	}
+	double polled = nsPerRunnable(count, [&shared]() {
+		for (auto &runnable : shared) {
+			if (runnable && runnable->isActive()) {
+				runnable->run();
+			}
+		}
+	});
+
+	Table table;
+	for (FakeRunnable &runnable : runnables) {
+		table.add(&runnable, runnable.active);
+	}
+	double flat = nsPerRunnable(count, [&table]() { table.runAll(); });
+
+	char report[100];
+	snprintf(report, sizeof(report),
+			 "%d runnables, half active: %.2f ns polled, %.2f ns flat per "
+			 "runnable",
+			 count, polled, flat);
+	TEST_MESSAGE(report);
+	TEST_ASSERT_EQUAL(runnables[0].runs, runnables[count / 2 - 1].runs);
+	TEST_ASSERT_EQUAL(0, runnables[count - 1].runs);
+}
+
+int main(int argc, char **argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_only_active_run);
+	RUN_TEST(test_handles_and_removal);
+	RUN_TEST(test_deactivation_inside_run);
+	RUN_TEST(test_benchmark_run_all);
+	return UNITY_END();
+}
@@ -0,0 +1,141 @@
+/**
+ * Scheduler Native Test
+ *
+ * This test runs on the host (pio test -e native) and validates the
+ * cooperative loop scheduler against a fake microsecond clock.
+ *
+ * Test Steps:
+ * 1. Validate motion runs before and between every other task
+ * 2. Validate periodic tasks keep their period and count late runs
+ * 3. Validate earliest deadline first ordering
+ * 4. Validate tasks over the pass budget are deferred, never starved
+ * 5. Validate overrun statistics and task removal
+ */
+
+#include <unity.h>
+
+#include "../../../src/manager/Scheduler.h"
+
+#include <string>
+
+uint32_t fakeNow = 0;
+uint32_t fakeClock() { return fakeNow; }
+
+std::string trace;
+
+void setUp() {
+	fakeNow = 1000;
+	trace.clear();
+}
+void tearDown() {}
+
+void test_motion_runs_between_tasks() {
+	Scheduler scheduler(fakeClock);
+	scheduler.addTask("motion", TaskClass::Motion, []() { trace += "M"; });
+	scheduler.addTask("leds", TaskClass::Animation, []() {
+		trace += "A";
+		fakeNow += 3000; // strip.show()
+	});
+	scheduler.addTask("ui", TaskClass::Background, []() { trace += "B"; });
+
+	scheduler.run();
+	TEST_ASSERT_EQUAL_STRING("MAMBM", trace.c_str());
+	TEST_ASSERT_EQUAL(3000, scheduler.getStats().maxMotionGap);
+	TEST_ASSERT_EQUAL(1, scheduler.getStats().passes);
+}
+
+void test_periodic_tasks() {
+	Scheduler scheduler(fakeClock);
+	Scheduler::TaskHandle tick = scheduler.addTask(
+		"tick", TaskClass::Background, []() { trace += "T"; }, 1000);
+
+	for (int i = 0; i < 10; i++) {
+		scheduler.run();
+		fakeNow += 250;
+	}
+	// Due at 1000, 2000 and 3000 within 1000..3250, next at 4000
+	TEST_ASSERT_EQUAL_STRING("TTT", trace.c_str());
+	TEST_ASSERT_EQUAL(0, scheduler.getTaskStats(tick).missed);
+	TEST_ASSERT_EQUAL(500, scheduler.timeUntilNextTask());
+
+	// Two periods late: one run, counted as missed, back on a new grid
+	fakeNow += 2750;
+	scheduler.run();
+	TEST_ASSERT_EQUAL(1, scheduler.getTaskStats(tick).missed);
+	TEST_ASSERT_EQUAL(2250, scheduler.getTaskStats(tick).maxLateness);
+	TEST_ASSERT_EQUAL(1000, scheduler.timeUntilNextTask());
+}
+
+void test_earliest_deadline_first() {
+	Scheduler scheduler(fakeClock);
+	scheduler.addTask(
+		"slow", TaskClass::Background, []() { trace += "S"; }, 5000);
+	scheduler.addTask(
+		"fast", TaskClass::Background, []() { trace += "F"; }, 1000);
+	scheduler.addTask("every", TaskClass::Background, []() { trace += "E"; });
+
+	scheduler.run();
+	TEST_ASSERT_EQUAL_STRING("EFS", trace.c_str());
+}
+
+void test_budget_defers_without_starving() {
+	Scheduler scheduler(fakeClock, 5000);
+	scheduler.addTask("heavy", TaskClass::Animation, []() {
+		trace += "H";
+		fakeNow += 4000;
+	});
+	Scheduler::TaskHandle storage = scheduler.addTask(
+		"storage", TaskClass::Background,
+		[]() {
+			trace += "S";
+			fakeNow += 2000;
+		},
+		0, 2000);
+
+	scheduler.run();
+	TEST_ASSERT_EQUAL_STRING("H", trace.c_str());
+	TEST_ASSERT_EQUAL(1, scheduler.getTaskStats(storage).deferred);
+
+	// Deferred once, it runs on the next pass even over budget
+	scheduler.run();
+	TEST_ASSERT_EQUAL_STRING("HHS", trace.c_str());
+	TEST_ASSERT_EQUAL(1, scheduler.getStats().overBudget);
+}
+
+void test_overruns_and_removal() {
+	Scheduler scheduler(fakeClock);
+	Scheduler::TaskHandle slow = scheduler.addTask(
+		"slow", TaskClass::Background, []() { fakeNow += 700; }, 0, 500);
+	scheduler.run();
+	scheduler.run();
+	TEST_ASSERT_EQUAL(2, scheduler.getTaskStats(slow).runs);
+	TEST_ASSERT_EQUAL(2, scheduler.getTaskStats(slow).overruns);
+	TEST_ASSERT_EQUAL(700, scheduler.getTaskStats(slow).maxRun);
+
+	scheduler.removeTask(slow);
+	TEST_ASSERT_FALSE(scheduler.isValid(slow));
+	scheduler.run();
+
+	Scheduler::TaskHandle reused = scheduler.addTask(
+		"reused", TaskClass::Background, []() { trace += "R"; });
+	TEST_ASSERT_EQUAL(slow, reused);
+	scheduler.run();
+	TEST_ASSERT_EQUAL_STRING("R", trace.c_str());
+
+	for (int i = 1; i < SCHEDULER_MAX_TASKS; i++) {
+		TEST_ASSERT_TRUE(scheduler.addTask("filler", TaskClass::Background,
+										   []() {}) >= 0);
+	}
+	TEST_ASSERT_EQUAL(-1, scheduler.addTask("full", TaskClass::Background,
+											[]() {}));
+}
+
+int main(int argc, char **argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_motion_runs_between_tasks);
+	RUN_TEST(test_periodic_tasks);
+	RUN_TEST(test_earliest_deadline_first);
+	RUN_TEST(test_budget_defers_without_starving);
+	RUN_TEST(test_overruns_and_removal);
+	return UNITY_END();
+}
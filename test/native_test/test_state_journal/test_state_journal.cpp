@@ -0,0 +1,185 @@
+/**
+ * State Journal Native Test
+ *
+ * This test runs on the host (pio test -e native) and validates the
+ * append-only runtime state journal on a host file standing in for LittleFS.
+ * It also benchmarks journal appends against rewriting the whole state blob
+ * on every change, which is how the configuration is persisted today.
+ *
+ * Test Steps:
+ * 1. Put values and read them back
+ * 2. Replay the log in a new journal, as on reboot
+ * 3. Append a torn record and validate replay drops it
+ * 4. Validate compaction keeps the log bounded
+ * 5. Benchmark journal appends against full rewrites
+ */
+
+#include <unity.h>
+
+#include "../../../src/manager/StateJournal.h"
+
+#include <chrono>
+
+const char *journalPath = "state_journal_test.bin";
+const char *rewritePath = "state_rewrite_test.bin";
+
+void setUp() {}
+void tearDown() {}
+
+void test_put_and_get() {
+	HostJournalFile file(journalPath);
+	StateJournal journal(file);
+	journal.clear();
+
+	int32_t position = 1200;
+	uint32_t color = 0xFF8800;
+	TEST_ASSERT_TRUE(journal.put("STEPPER1/pos", position));
+	TEST_ASSERT_TRUE(journal.put("STRIP/color", color));
+
+	int32_t readPosition = 0;
+	TEST_ASSERT_TRUE(journal.get("STEPPER1/pos", readPosition));
+	TEST_ASSERT_EQUAL_INT32(1200, readPosition);
+	TEST_ASSERT_FALSE(journal.get("UNKNOWN", readPosition));
+	TEST_ASSERT_EQUAL_UINT32(2, journal.size());
+
+	// Same value again is not written
+	size_t logBytes = journal.getLogBytes();
+	TEST_ASSERT_TRUE(journal.put("STEPPER1/pos", position));
+	TEST_ASSERT_EQUAL_UINT32(logBytes, journal.getLogBytes());
+}
+
+void test_replay_after_reboot() {
+	{
+		HostJournalFile file(journalPath);
+		StateJournal journal(file);
+		journal.replay();
+		int32_t position = 1500;
+		journal.put("STEPPER1/pos", position);
+		journal.erase("STRIP/color");
+	}
+
+	HostJournalFile file(journalPath);
+	StateJournal rebooted(file);
+	TEST_ASSERT_EQUAL_UINT32(4, rebooted.replay());
+
+	int32_t position = 0;
+	TEST_ASSERT_TRUE(rebooted.get("STEPPER1/pos", position));
+	TEST_ASSERT_EQUAL_INT32(1500, position);
+	TEST_ASSERT_FALSE(rebooted.contains("STRIP/color"));
+}
+
+void test_torn_record_is_dropped() {
+	FILE *raw = fopen(journalPath, "ab");
+	const uint8_t torn[] = {STATE_JOURNAL_RECORD, 12, 4, 'S', 'T', 'E'};
+	fwrite(torn, 1, sizeof(torn), raw);
+	fclose(raw);
+
+	HostJournalFile file(journalPath);
+	StateJournal journal(file);
+	journal.replay();
+	TEST_ASSERT_EQUAL_UINT32(1, journal.getCompactions());
+
+	int32_t position = 1600;
+	TEST_ASSERT_TRUE(journal.put("STEPPER1/pos", position));
+
+	HostJournalFile rebootFile(journalPath);
+	StateJournal rebooted(rebootFile);
+	rebooted.replay();
+	TEST_ASSERT_TRUE(rebooted.get("STEPPER1/pos", position));
+	TEST_ASSERT_EQUAL_INT32(1600, position);
+}
+
+void test_compaction_bounds_log() {
+	HostJournalFile file(journalPath);
+	StateJournal journal(file, 512);
+	journal.clear();
+
+	for (int32_t position = 0; position < 1000; position++) {
+		journal.put("STEPPER1/pos", position);
+		journal.update();
+		TEST_ASSERT_LESS_OR_EQUAL_UINT32(512 + 32, journal.getLogBytes());
+	}
+	TEST_ASSERT_GREATER_THAN_UINT32(0, journal.getCompactions());
+
+	HostJournalFile rebootFile(journalPath);
+	StateJournal rebooted(rebootFile);
+	rebooted.replay();
+	int32_t position = 0;
+	TEST_ASSERT_TRUE(rebooted.get("STEPPER1/pos", position));
+	TEST_ASSERT_EQUAL_INT32(999, position);
+}
+
+/**
+ * Each update changes one of eight keys, as a loop would do for steppers,
+ * LED colors, DC speed and GPIO levels.
+ */
+void test_benchmark_journal_vs_full_rewrite() {
+	const int updates = 2000;
+	const char *keys[] = {"STEPPER1/pos", "STEPPER2/pos", "STEPPER3/pos",
+						  "STEPPER4/pos", "STRIP1/color", "STRIP2/color",
+						  "DC1/speed",	  "GPIO5/level"};
+	const int numKeys = sizeof(keys) / sizeof(keys[0]);
+
+	HostJournalFile file(journalPath);
+	StateJournal journal(file);
+	journal.clear();
+	uint32_t journalStartBytes = journal.getBytesWritten();
+
+	auto journalStart = std::chrono::steady_clock::now();
+	for (int32_t i = 0; i < updates; i++) {
+		journal.put(keys[i % numKeys], i);
+		journal.update();
+	}
+	auto journalTime = std::chrono::steady_clock::now() - journalStart;
+	uint32_t journalBytes = journal.getBytesWritten() - journalStartBytes;
+
+	// Full rewrite: serialize every key and replace the file on each change
+	HostJournalFile rewriteFile(rewritePath);
+	StateJournal snapshot(rewriteFile);
+	snapshot.clear();
+	uint32_t rewriteBytes = 0;
+	auto rewriteStart = std::chrono::steady_clock::now();
+	for (int32_t i = 0; i < updates; i++) {
+		std::vector<uint8_t> blob;
+		for (int k = 0; k < numKeys; k++) {
+			int32_t value = (k == i % numKeys) ? i : 0;
+			blob.insert(blob.end(), keys[k], keys[k] + strlen(keys[k]));
+			const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&value);
+			blob.insert(blob.end(), bytes, bytes + sizeof(value));
+		}
+		rewriteFile.rewrite(blob.data(), blob.size());
+		rewriteBytes += blob.size();
+	}
+	auto rewriteTime = std::chrono::steady_clock::now() - rewriteStart;
+
+	double journalUs =
+		std::chrono::duration<double, std::micro>(journalTime).count();
+	double rewriteUs =
+		std::chrono::duration<double, std::micro>(rewriteTime).count();
+
+	char report[200];
+	snprintf(report, sizeof(report),
+			 "journal: %.1f us/update %u bytes | full rewrite: %.1f "
+			 "us/update %u bytes",
+			 journalUs / updates, journalBytes, rewriteUs / updates,
+			 rewriteBytes);
+	TEST_MESSAGE(report);
+
+	TEST_ASSERT_LESS_THAN_UINT32(rewriteBytes, journalBytes);
+
+	journal.clear();
+	rewriteFile.remove();
+}
+
+int main(int argc, char **argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_put_and_get);
+	RUN_TEST(test_replay_after_reboot);
+	RUN_TEST(test_torn_record_is_dropped);
+	RUN_TEST(test_compaction_bounds_log);
+	RUN_TEST(test_benchmark_journal_vs_full_rewrite);
+
+	HostJournalFile file(journalPath);
+	file.remove();
+	return UNITY_END();
+}
@@ -0,0 +1,130 @@
+/**
+ * Step Admission Native Test
+ *
+ * This test runs on the host (pio test -e native) and validates the
+ * admission control of the aggregate step rate behind StepperRunner.
+ *
+ * Test Steps:
+ * 1. Validate Clamp grants what the other slots leave, keeping the sign
+ * 2. Validate Warn grants the speed and counts the overload
+ * 3. Validate released and stopped slots free their share
+ * 4. Validate preview grants like request without holding the speed
+ * 5. Validate the capacity search against a synthetic loop
+ */
+
+#include <unity.h>
+
+#include "../../../src/manager/StepAdmission.h"
+
+#include <initializer_list>
+
+void setUp() {}
+void tearDown() {}
+
+void test_clamp_to_capacity_left() {
+	StepAdmission<4> admission(3000, AdmissionPolicy::Clamp);
+	Admission first = admission.request(0, 1000);
+	TEST_ASSERT_FALSE(first.overCapacity);
+	TEST_ASSERT_EQUAL_FLOAT(1000, first.granted);
+	admission.request(1, -1000);
+	TEST_ASSERT_EQUAL_FLOAT(2000, admission.getTotal());
+
+	Admission third = admission.request(2, -1500);
+	TEST_ASSERT_TRUE(third.overCapacity);
+	TEST_ASSERT_EQUAL_FLOAT(-1500, third.requested);
+	TEST_ASSERT_EQUAL_FLOAT(-1000, third.granted);
+	TEST_ASSERT_EQUAL_FLOAT(3000, third.total);
+
+	// Nothing left: granted 0
+	Admission fourth = admission.request(3, 500);
+	TEST_ASSERT_TRUE(fourth.overCapacity);
+	TEST_ASSERT_EQUAL_FLOAT(0, fourth.granted);
+	TEST_ASSERT_EQUAL(2, admission.getOverloads());
+
+	// A slot changing its speed only counts the others
+	Admission again = admission.request(0, 1000);
+	TEST_ASSERT_FALSE(again.overCapacity);
+	TEST_ASSERT_EQUAL_FLOAT(3000, admission.getTotal());
+}
+
+void test_warn_grants_speed() {
+	StepAdmission<2> admission(1000, AdmissionPolicy::Warn);
+	admission.request(0, 800);
+	Admission over = admission.request(1, 800);
+	TEST_ASSERT_TRUE(over.overCapacity);
+	TEST_ASSERT_EQUAL_FLOAT(800, over.granted);
+	TEST_ASSERT_EQUAL_FLOAT(1600, admission.getTotal());
+	TEST_ASSERT_EQUAL(1, admission.getOverloads());
+
+	// Slots out of range are not accounted
+	Admission outside = admission.request(2, 5000);
+	TEST_ASSERT_FALSE(outside.overCapacity);
+	TEST_ASSERT_EQUAL_FLOAT(1600, admission.getTotal());
+}
+
+void test_release_frees_share() {
+	StepAdmission<2> admission(1000, AdmissionPolicy::Clamp);
+	admission.request(0, 1000);
+	TEST_ASSERT_EQUAL_FLOAT(0, admission.request(1, 500).granted);
+
+	admission.request(0, 0);
+	TEST_ASSERT_EQUAL_FLOAT(500, admission.request(1, 500).granted);
+
+	admission.release(1);
+	TEST_ASSERT_EQUAL_FLOAT(0, admission.getTotal());
+	TEST_ASSERT_EQUAL_FLOAT(1000, admission.request(0, 1000).granted);
+}
+
+void test_preview_holds_nothing() {
+	StepAdmission<2> admission(1000, AdmissionPolicy::Clamp);
+	admission.request(0, 600);
+	Admission preview = admission.preview(1, 800);
+	TEST_ASSERT_TRUE(preview.overCapacity);
+	TEST_ASSERT_EQUAL_FLOAT(400, preview.granted);
+	TEST_ASSERT_EQUAL_FLOAT(600, admission.getTotal());
+	TEST_ASSERT_EQUAL_FLOAT(0, admission.getSpeed(1));
+	TEST_ASSERT_EQUAL(0, admission.getOverloads());
+
+	Admission granted = admission.request(1, 800);
+	TEST_ASSERT_EQUAL_FLOAT(preview.granted, granted.granted);
+	TEST_ASSERT_EQUAL_FLOAT(400, admission.getSpeed(1));
+	TEST_ASSERT_EQUAL(1, admission.getOverloads());
+}
+
+void test_measure_capacity_search() {
+	// Loop delivering 2500 steps/s split between the steppers
+	const float sustained = 2500;
+	for (size_t steppers : {1, 2, 4}) {
+		int trials = 0;
+		float capacity = measureStepCapacity(
+			steppers, 10000,
+			[&](float speed) {
+				trials++;
+				float share = sustained / steppers;
+				return speed <= share ? 1.0f : share / speed;
+			},
+			1.0f, 12);
+		TEST_ASSERT_FLOAT_WITHIN(sustained * 0.01f, sustained, capacity);
+		TEST_ASSERT_TRUE(capacity <= sustained);
+		TEST_ASSERT_EQUAL(13, trials);
+	}
+
+	// Sustained at the highest speed tried: a single trial
+	int trials = 0;
+	float capacity = measureStepCapacity(3, 100, [&](float) {
+		trials++;
+		return 1.0f;
+	});
+	TEST_ASSERT_EQUAL_FLOAT(300, capacity);
+	TEST_ASSERT_EQUAL(1, trials);
+}
+
+int main(int argc, char **argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_clamp_to_capacity_left);
+	RUN_TEST(test_warn_grants_speed);
+	RUN_TEST(test_release_frees_share);
+	RUN_TEST(test_preview_holds_nothing);
+	RUN_TEST(test_measure_capacity_search);
+	return UNITY_END();
+}
@@ -0,0 +1,102 @@
+/**
+ * Storage Backends Native Test
+ *
+ * This test runs on the host (pio test -e native) and validates the memory
+ * and host file storage backends, then benchmarks both with configuration
+ * sized payloads.
+ *
+ * Test Steps:
+ * 1. Write, read and remove a key on each backend
+ * 2. Validate usage introspection
+ * 3. Validate a memory backend with a capacity rejects oversized writes
+ * 4. Benchmark read and write latency per backend and payload size
+ */
+
+#include <unity.h>
+
+#include "../../utils/storage_benchmark.h"
+
+#include <chrono>
+#include <unistd.h>
+
+const char *storageDir = "storage_backend_test";
+
+uint32_t hostMicros() {
+	return static_cast<uint32_t>(
+		std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now().time_since_epoch())
+			.count());
+}
+
+void setUp() {}
+void tearDown() {}
+
+void check_roundtrip(IStorageBackend &backend) {
+	TEST_ASSERT_TRUE(backend.begin());
+	TEST_ASSERT_TRUE(backend.write("espinners_a", std::string("[1,2,3]")));
+
+	std::string value;
+	TEST_ASSERT_TRUE(backend.read("espinners_a", value));
+	TEST_ASSERT_EQUAL_STRING("[1,2,3]", value.c_str());
+	TEST_ASSERT_TRUE(backend.exists("espinners_a"));
+
+	StorageUsage info = backend.usage();
+	TEST_ASSERT_EQUAL_UINT32(1, info.entries);
+	TEST_ASSERT_GREATER_OR_EQUAL_UINT32(7, info.usedBytes);
+
+	TEST_ASSERT_TRUE(backend.remove("espinners_a"));
+	TEST_ASSERT_FALSE(backend.read("espinners_a", value));
+	TEST_ASSERT_EQUAL_UINT32(0, backend.usage().entries);
+}
+
+void test_memory_roundtrip() {
+	MemoryStorageBackend backend;
+	check_roundtrip(backend);
+}
+
+void test_hostfile_roundtrip() {
+	HostFileStorageBackend backend(storageDir);
+	check_roundtrip(backend);
+}
+
+void test_memory_capacity() {
+	MemoryStorageBackend backend(64);
+	TEST_ASSERT_TRUE(backend.write("a", std::string(40, 'x')));
+	TEST_ASSERT_FALSE(backend.write("b", std::string(40, 'x')));
+
+	// Replacing a value only counts the difference
+	TEST_ASSERT_TRUE(backend.write("a", std::string(60, 'x')));
+	StorageUsage info = backend.usage();
+	TEST_ASSERT_EQUAL_UINT32(64, info.totalBytes);
+	TEST_ASSERT_EQUAL_UINT32(61, info.usedBytes);
+}
+
+void test_benchmark_backends() {
+	MemoryStorageBackend memory;
+	HostFileStorageBackend hostFile(storageDir);
+	hostFile.begin();
+	IStorageBackend *backends[] = {&memory, &hostFile};
+
+	for (IStorageBackend *backend : backends) {
+		for (size_t i = 0; i < storageBenchmarkSizeCount; i++) {
+			StorageBenchmarkResult result = benchmarkStorage(
+				*backend, storageBenchmarkSizes[i], 200, hostMicros);
+			char report[160];
+			formatStorageBenchmark(report, sizeof(report), backend->name(),
+								   result);
+			TEST_MESSAGE(report);
+			TEST_ASSERT_TRUE(result.valid);
+		}
+	}
+}
+
+int main(int argc, char **argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_memory_roundtrip);
+	RUN_TEST(test_hostfile_roundtrip);
+	RUN_TEST(test_memory_capacity);
+	RUN_TEST(test_benchmark_backends);
+
+	rmdir(storageDir);
+	return UNITY_END();
+}
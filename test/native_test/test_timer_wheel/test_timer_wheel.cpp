@@ -0,0 +1,239 @@
+/**
+ * Timer Wheel Native Test
+ *
+ * This test runs on the host (pio test -e native) and validates the
+ * hierarchical timer wheel that drives the tickers of the main loop.
+ *
+ * Test Steps:
+ * 1. Validate one shot timers fire once at their expiry
+ * 2. Validate periodic timers keep their period across every level
+ * 3. Validate callbacks can stop, re-arm and release timers
+ * 4. Validate far timers and clock wrap around
+ * 5. Compare random workloads against a brute force model
+ * 6. Validate an exhausted pool refuses and counts create() calls
+ */
+
+#include <unity.h>
+
+#include "../../../src/manager/TimerWheel.h"
+
+#include <vector>
+
+uint32_t fakeNow = 0;
+uint32_t fakeClock() { return fakeNow; }
+
+int fires[TIMER_WHEEL_MAX_TIMERS];
+
+TimerWheel::TimerCallback counter(int slot) {
+	return [slot]() { fires[slot]++; };
+}
+
+void setUp() {
+	fakeNow = 1000;
+	for (int i = 0; i < TIMER_WHEEL_MAX_TIMERS; i++) {
+		fires[i] = 0;
+	}
+}
+void tearDown() {}
+
+void test_one_shot() {
+	TimerWheel wheel(fakeClock);
+	TimerWheel::TimerHandle timer = wheel.create(counter(0));
+	TEST_ASSERT_EQUAL(TimerWheel::NONE, wheel.timeUntilNext());
+
+	wheel.start(timer, 150);
+	TEST_ASSERT_EQUAL(150, wheel.timeUntilNext());
+	fakeNow += 149;
+	TEST_ASSERT_EQUAL(0, wheel.advance());
+	TEST_ASSERT_EQUAL(1, wheel.timeUntilNext());
+	fakeNow += 1;
+	TEST_ASSERT_EQUAL(1, wheel.advance());
+	TEST_ASSERT_FALSE(wheel.isArmed(timer));
+	fakeNow += 1000;
+	TEST_ASSERT_EQUAL(0, wheel.advance());
+	TEST_ASSERT_EQUAL(1, fires[0]);
+}
+
+void test_periodic_levels() {
+	TimerWheel wheel(fakeClock);
+	const uint32_t periods[] = {1, 50, 200, 5000, 70000};
+	for (int i = 0; i < 5; i++) {
+		TimerWheel::TimerHandle timer = wheel.create(counter(i));
+		wheel.start(timer, periods[i], periods[i]);
+	}
+	for (int ms = 0; ms < 140000; ms++) {
+		fakeNow++;
+		wheel.advance();
+	}
+	for (int i = 0; i < 5; i++) {
+		TEST_ASSERT_EQUAL(140000 / periods[i], fires[i]);
+	}
+	TEST_ASSERT_EQUAL(5, wheel.armedCount());
+}
+
+TimerWheel *activeWheel = nullptr;
+TimerWheel::TimerHandle victim = -1;
+
+void test_callbacks_change_timers() {
+	TimerWheel wheel(fakeClock);
+	activeWheel = &wheel;
+	// Both due together; the first one stops the second
+	TimerWheel::TimerHandle killer = wheel.create([]() {
+		fires[0]++;
+		activeWheel->stop(victim);
+	});
+	victim = wheel.create(counter(1));
+	wheel.start(victim, 10);
+	wheel.start(killer, 10);
+	fakeNow += 10;
+	wheel.advance();
+	TEST_ASSERT_EQUAL(1, fires[0] + fires[1]);
+
+	// A one shot timer re-arming itself, then releasing itself
+	static TimerWheel::TimerHandle self = -1;
+	self = wheel.create([]() {
+		if (++fires[2] < 3) {
+			activeWheel->start(self, 5);
+		} else {
+			activeWheel->release(self);
+		}
+	});
+	wheel.start(self, 5);
+	for (int i = 0; i < 30; i++) {
+		fakeNow++;
+		wheel.advance();
+	}
+	TEST_ASSERT_EQUAL(3, fires[2]);
+	TEST_ASSERT_EQUAL(0, wheel.armedCount());
+	activeWheel = nullptr;
+}
+
+void test_far_timers_and_wrap() {
+	fakeNow = 0xFFFFFF00u;
+	TimerWheel wheel(fakeClock);
+	TimerWheel::TimerHandle near = wheel.create(counter(0));
+	TimerWheel::TimerHandle far = wheel.create(counter(1));
+	wheel.start(near, 0x200);	 // Across the wrap
+	wheel.start(far, 600000); // Overflow list
+	fakeNow += 0x1FF;
+	wheel.advance();
+	TEST_ASSERT_EQUAL(0, fires[0]);
+	fakeNow += 1;
+	wheel.advance();
+	TEST_ASSERT_EQUAL(1, fires[0]);
+
+	TEST_ASSERT_EQUAL(600000 - 0x200, wheel.timeUntilNext());
+	// Big jumps, as after a long blocking call
+	fakeNow += 300000;
+	wheel.advance();
+	fakeNow += 299487;
+	wheel.advance();
+	TEST_ASSERT_EQUAL(0, fires[1]);
+	TEST_ASSERT_EQUAL(1, wheel.timeUntilNext());
+	fakeNow += 1;
+	wheel.advance();
+	TEST_ASSERT_EQUAL(1, fires[1]);
+}
+
+struct ModelTimer {
+	bool armed = false;
+	uint32_t expiry = 0;
+	uint32_t period = 0;
+	int fires = 0;
+};
+
+void test_random_against_model() {
+	TimerWheel wheel(fakeClock);
+	const int count = 16;
+	std::vector<ModelTimer> model(count);
+	TimerWheel::TimerHandle handles[count];
+	for (int i = 0; i < count; i++) {
+		handles[i] = wheel.create(counter(i));
+	}
+
+	uint32_t seed = 2024;
+	auto random = [&seed](uint32_t range) {
+		seed = seed * 1103515245u + 12345u;
+		return (seed >> 8) % range;
+	};
+	const uint32_t delays[] = {1, 40, 500, 9000, 300000};
+
+	for (int round = 0; round < 20000; round++) {
+		int i = random(count);
+		switch (random(8)) {
+		case 0: {
+			uint32_t delay = random(delays[random(5)]);
+			uint32_t period = random(2) ? random(delays[random(4)]) + 1 : 0;
+			wheel.start(handles[i], delay, period);
+			model[i].armed = true;
+			model[i].expiry = fakeNow + delay;
+			model[i].period = period;
+			break;
+		}
+		case 1:
+			wheel.stop(handles[i]);
+			model[i].armed = false;
+			break;
+		default:
+			fakeNow += random(random(4) ? 20 : 5000);
+			wheel.advance();
+			for (ModelTimer &timer : model) {
+				if (!timer.armed ||
+					static_cast<int32_t>(fakeNow - timer.expiry) < 0) {
+					continue;
+				}
+				timer.fires++;
+				if (timer.period == 0) {
+					timer.armed = false;
+					continue;
+				}
+				timer.expiry += timer.period;
+				if (static_cast<int32_t>(fakeNow - timer.expiry) >= 0) {
+					timer.expiry = fakeNow + timer.period;
+				}
+			}
+			break;
+		}
+
+		uint32_t next = TimerWheel::NONE;
+		for (ModelTimer &timer : model) {
+			if (timer.armed) {
+				uint32_t wait = static_cast<int32_t>(timer.expiry - fakeNow) > 0
+									? timer.expiry - fakeNow
+									: 0;
+				next = wait < next ? wait : next;
+			}
+		}
+		TEST_ASSERT_EQUAL(next, wheel.timeUntilNext());
+	}
+	for (int i = 0; i < count; i++) {
+		TEST_ASSERT_EQUAL(model[i].fires, fires[i]);
+		TEST_ASSERT_EQUAL(model[i].armed, wheel.isArmed(handles[i]));
+	}
+}
+
+void test_pool_exhausted() {
+	TimerWheel wheel(fakeClock);
+	for (int i = 0; i < TIMER_WHEEL_MAX_TIMERS; i++) {
+		TEST_ASSERT_EQUAL(i, wheel.create(counter(i)));
+	}
+	TEST_ASSERT_EQUAL(0, wheel.getExhausted());
+	TEST_ASSERT_EQUAL(-1, wheel.create(counter(0)));
+	TEST_ASSERT_EQUAL(1, wheel.getExhausted());
+
+	// A released timer is handed out again
+	wheel.release(3);
+	TEST_ASSERT_EQUAL(3, wheel.create(counter(3)));
+	TEST_ASSERT_EQUAL(1, wheel.getExhausted());
+}
+
+int main(int argc, char **argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_one_shot);
+	RUN_TEST(test_periodic_levels);
+	RUN_TEST(test_callbacks_change_timers);
+	RUN_TEST(test_far_timers_and_wrap);
+	RUN_TEST(test_random_against_model);
+	RUN_TEST(test_pool_exhausted);
+	return UNITY_END();
+}
@@ -0,0 +1,237 @@
+#ifndef _ESPALLON_SIM_ACCELSTEPPER_H
+#define _ESPALLON_SIM_ACCELSTEPPER_H
+
+#include <Arduino.h>
+
+/**
+ * AccelStepper stand-in of the host simulation
+ *
+ * Follows the stepping of AccelStepper for DRIVER interfaces: the same
+ * runSpeed() timing from micros(), the same per step speed recomputation
+ * in double precision, and the same pin writes (direction and step on each
+ * step, a minimum pulse width of busy wait). Step pulses therefore land in
+ * getGpioTrace() where the library would put them on the pins. The
+ * FUNCTION interface calls its step functions instead and writes no pin.
+ */
+class AccelStepper {
+  public:
+	enum MotorInterfaceType { FUNCTION = 0, DRIVER = 1 };
+
+	AccelStepper(uint8_t interface = DRIVER, uint8_t stepPin = 2,
+				 uint8_t dirPin = 3)
+		: stepPin(stepPin), dirPin(dirPin) {
+		enableOutputs();
+		setAcceleration(1);
+		setMaxSpeed(1);
+	}
+
+	AccelStepper(void (*forward)(), void (*backward)())
+		: stepPin(0), dirPin(0), forward(forward), backward(backward) {
+		setAcceleration(1);
+		setMaxSpeed(1);
+	}
+
+	void moveTo(long absolute) {
+		if (targetPos != absolute) {
+			targetPos = absolute;
+			computeNewSpeed();
+		}
+	}
+	void move(long relative) { moveTo(currentPos + relative); }
+
+	/**
+	 * Steps once if the step interval elapsed
+	 * @return True if it stepped
+	 */
+	bool runSpeed() {
+		if (!stepInterval) {
+			return false;
+		}
+		unsigned long time = micros();
+		if (time - lastStepTime >= stepInterval) {
+			currentPos += direction ? 1 : -1;
+			step();
+			lastStepTime = time;
+			return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Steps with acceleration towards the target
+	 * @return True while the motor is still moving
+	 */
+	bool run() {
+		if (runSpeed()) {
+			computeNewSpeed();
+		}
+		return currentSpeed != 0.0 || distanceToGo() != 0;
+	}
+
+	void setMaxSpeed(float speed) {
+		if (speed < 0.0) {
+			speed = -speed;
+		}
+		if (maximumSpeed != speed) {
+			maximumSpeed = speed;
+			cmin = 1000000.0 / speed;
+			if (n > 0) {
+				n = (long)((currentSpeed * currentSpeed) /
+						   (2.0 * acceleration));
+				computeNewSpeed();
+			}
+		}
+	}
+	float maxSpeed() const { return maximumSpeed; }
+
+	void setAcceleration(float value) {
+		if (value == 0.0) {
+			return;
+		}
+		if (value < 0.0) {
+			value = -value;
+		}
+		if (acceleration != value) {
+			n = n * (acceleration / value);
+			c0 = 0.676 * sqrt(2.0 / value) * 1000000.0;
+			acceleration = value;
+			computeNewSpeed();
+		}
+	}
+
+	void setSpeed(float speed) {
+		if (speed == currentSpeed) {
+			return;
+		}
+		speed = constrain(speed, -maximumSpeed, maximumSpeed);
+		if (speed == 0.0) {
+			stepInterval = 0;
+		} else {
+			stepInterval = fabs(1000000.0 / speed);
+			direction = speed > 0.0;
+		}
+		currentSpeed = speed;
+	}
+	float speed() const { return currentSpeed; }
+
+	/** Decelerates to a stop as fast as the acceleration allows */
+	void stop() {
+		if (currentSpeed != 0.0) {
+			long stepsToStop = (long)((currentSpeed * currentSpeed) /
+									  (2.0 * acceleration)) +
+							   1;
+			move(currentSpeed > 0 ? stepsToStop : -stepsToStop);
+		}
+	}
+
+	void setCurrentPosition(long position) {
+		targetPos = currentPos = position;
+		n = 0;
+		stepInterval = 0;
+		currentSpeed = 0.0;
+	}
+	long currentPosition() const { return currentPos; }
+	long targetPosition() const { return targetPos; }
+	long distanceToGo() const { return targetPos - currentPos; }
+	bool isRunning() const {
+		return !(currentSpeed == 0.0 && targetPos == currentPos);
+	}
+
+	void setMinPulseWidth(unsigned int width) { minPulseWidth = width; }
+
+	void disableOutputs() {
+		digitalWrite(stepPin, LOW);
+		digitalWrite(dirPin, LOW);
+	}
+	void enableOutputs() {
+		pinMode(stepPin, OUTPUT);
+		pinMode(dirPin, OUTPUT);
+	}
+
+  private:
+	uint8_t stepPin;
+	uint8_t dirPin;
+	void (*forward)() = nullptr; // FUNCTION interface
+	void (*backward)() = nullptr;
+	bool direction = false; // true = clockwise
+	long currentPos = 0;
+	long targetPos = 0;
+	float currentSpeed = 0.0;
+	float maximumSpeed = 0.0;
+	float acceleration = 0.0;
+	unsigned long stepInterval = 0;
+	unsigned long lastStepTime = 0;
+	unsigned int minPulseWidth = 1;
+	long n = 0;		   // Step counter of the ramp
+	float c0 = 0.0;	   // Initial step interval, us
+	float cn = 0.0;	   // Last step interval, us
+	float cmin = 1.0;  // Interval at max speed, us
+
+	void setOutputPins(bool stepLevel) {
+		digitalWrite(stepPin, stepLevel ? HIGH : LOW);
+		digitalWrite(dirPin, direction ? HIGH : LOW);
+	}
+
+	void step() {
+		if (forward != nullptr) {
+			direction ? forward() : backward();
+			return;
+		}
+		setOutputPins(false);
+		setOutputPins(true);
+		delayMicroseconds(minPulseWidth);
+		setOutputPins(false);
+	}
+
+	unsigned long computeNewSpeed() {
+		long distanceTo = distanceToGo();
+		long stepsToStop =
+			(long)((currentSpeed * currentSpeed) / (2.0 * acceleration));
+
+		if (distanceTo == 0 && stepsToStop <= 1) {
+			stepInterval = 0;
+			currentSpeed = 0.0;
+			n = 0;
+			return stepInterval;
+		}
+
+		if (distanceTo > 0) {
+			if (n > 0) {
+				if (stepsToStop >= distanceTo || !direction) {
+					n = -stepsToStop;
+				}
+			} else if (n < 0) {
+				if (stepsToStop < distanceTo && direction) {
+					n = -n;
+				}
+			}
+		} else if (distanceTo < 0) {
+			if (n > 0) {
+				if (stepsToStop >= -distanceTo || direction) {
+					n = -stepsToStop;
+				}
+			} else if (n < 0) {
+				if (stepsToStop < -distanceTo && !direction) {
+					n = -n;
+				}
+			}
+		}
+
+		if (n == 0) {
+			cn = c0;
+			direction = distanceTo > 0;
+		} else {
+			cn = cn - ((2.0 * cn) / ((4.0 * n) + 1));
+			cn = cn > cmin ? cn : cmin;
+		}
+		n++;
+		stepInterval = cn;
+		currentSpeed = 1000000.0 / cn;
+		if (!direction) {
+			currentSpeed = -currentSpeed;
+		}
+		return stepInterval;
+	}
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef _ESPALLON_SIM_ADAFRUIT_NEOPIXEL_H
+#define _ESPALLON_SIM_ADAFRUIT_NEOPIXEL_H
+
+#include <Arduino.h>
+
+#include <vector>
+
+#define NEO_GRB 0x52
+#define NEO_KHZ800 0x0000
+
+// Data time of one LED at 800 kHz: 24 bits of 1.25 us
+#ifndef SIM_NEOPIXEL_US_PER_LED
+#define SIM_NEOPIXEL_US_PER_LED 30
+#endif
+
+/**
+ * Adafruit_NeoPixel stand-in of the host simulation
+ *
+ * show() blocks like the real one, which sends the strip with interrupts
+ * off: the data pin goes high in getGpioTrace() and the virtual clock
+ * moves by SIM_NEOPIXEL_US_PER_LED per LED before it goes low again.
+ */
+class Adafruit_NeoPixel {
+  public:
+	Adafruit_NeoPixel(uint16_t count = 0, int16_t pin = 6,
+					  uint16_t type = NEO_GRB + NEO_KHZ800)
+		: pixels(count, 0), pin(pin) {}
+
+	void begin() { pinMode(pin, OUTPUT); }
+
+	void show() {
+		shows++;
+		digitalWrite(pin, HIGH);
+		getVirtualClock().advance((uint64_t)SIM_NEOPIXEL_US_PER_LED *
+								  pixels.size());
+		digitalWrite(pin, LOW);
+	}
+
+	void setPixelColor(uint16_t index, uint32_t color) {
+		if (index < pixels.size()) {
+			pixels[index] = color;
+		}
+	}
+	void setPixelColor(uint16_t index, uint8_t r, uint8_t g, uint8_t b) {
+		setPixelColor(index, Color(r, g, b));
+	}
+	uint32_t getPixelColor(uint16_t index) const {
+		return index < pixels.size() ? pixels[index] : 0;
+	}
+	void fill(uint32_t color = 0) {
+		for (uint32_t &pixel : pixels) {
+			pixel = color;
+		}
+	}
+	void clear() { fill(0); }
+	void setBrightness(uint8_t value) { brightness = value; }
+	uint8_t getBrightness() const { return brightness; }
+
+	uint16_t numPixels() const { return pixels.size(); }
+	int16_t getPin() const { return pin; }
+	void setPin(int16_t value) { pin = value; }
+	void updateLength(uint16_t count) { pixels.assign(count, 0); }
+
+	static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) {
+		return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+	}
+
+	/** show() calls so far */
+	uint32_t getShows() const { return shows; }
+
+  private:
+	std::vector<uint32_t> pixels;
+	int16_t pin;
+	uint8_t brightness = 255;
+	uint32_t shows = 0;
+};
+
+#endif
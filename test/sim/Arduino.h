@@ -0,0 +1,69 @@
+#ifndef _ESPALLON_SIM_ARDUINO_H
+#define _ESPALLON_SIM_ARDUINO_H
+
+/**
+ * Arduino core of the host simulation (pio test -e native_sim)
+ *
+ * Just enough of the core for the runners, tickers and their stand-in
+ * libraries: time reads the injected clock (see Clock.h), delays advance
+ * the virtual clock, and pin writes go to getGpioTrace(). ARDUINO stays
+ * undefined, so the headers keep their host code paths.
+ */
+
+#include "../../src/manager/Clock.h"
+#include "SimGpio.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#define LOW 0x0
+#define HIGH 0x1
+#define INPUT 0x0
+#define OUTPUT 0x1
+
+typedef bool boolean;
+
+inline unsigned long micros() { return clockMicros(); }
+inline unsigned long millis() { return clockMillis(); }
+
+/** Busy waits cost their whole duration of virtual time */
+inline void delayMicroseconds(unsigned int us) {
+	getVirtualClock().advance(us);
+}
+inline void delay(unsigned long ms) { getVirtualClock().advance(ms * 1000); }
+
+inline void pinMode(uint8_t pin, uint8_t mode) {
+	getGpioTrace().setMode(pin, mode);
+}
+inline void digitalWrite(uint8_t pin, uint8_t level) {
+	getGpioTrace().write(pin, level ? HIGH : LOW);
+}
+inline int digitalRead(uint8_t pin) { return getGpioTrace().read(pin); }
+
+template <typename T> T constrain(T value, T low, T high) {
+	return value < low ? low : (value > high ? high : value);
+}
+
+/**
+ * Arduino String over std::string, for the IDs of the runnables
+ */
+class String : public std::string {
+  public:
+	String() {}
+	String(const char *text) : std::string(text ? text : "") {}
+	String(const std::string &text) : std::string(text) {}
+	String(int value) : std::string(std::to_string(value)) {}
+	String(unsigned int value) : std::string(std::to_string(value)) {}
+	String(long value) : std::string(std::to_string(value)) {}
+	String(unsigned long value) : std::string(std::to_string(value)) {}
+
+	bool equals(const String &other) const { return *this == other; }
+	unsigned int length() const { return size(); }
+	int toInt() const { return atoi(c_str()); }
+};
+
+#endif
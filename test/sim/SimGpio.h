@@ -0,0 +1,132 @@
+#ifndef _ESPALLON_SIM_GPIO_H
+#define _ESPALLON_SIM_GPIO_H
+
+#include "../../src/manager/Clock.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * One pin write of the simulation, time from the virtual clock in ns
+ */
+struct GpioEvent {
+	uint64_t time;
+	uint8_t pin;
+	uint8_t level;
+};
+
+/**
+ * Step pulse timing of one pin, times in us
+ */
+struct PulseStats {
+	size_t pulses = 0;
+	double rate = 0;	// Pulses per second over the first to last pulse
+	double meanInterval = 0;
+	double minInterval = 0;
+	double maxInterval = 0;
+	double jitter = 0; // Standard deviation of the interval
+};
+
+/**
+ * GPIO of the host simulation
+ *
+ * The digitalWrite() of the simulated Arduino core lands here: every write
+ * is recorded with its virtual time, and may charge the virtual clock a
+ * fixed cost to model the write itself.
+ */
+class GpioTrace {
+  private:
+	static constexpr uint8_t PINS = 64;
+
+	std::vector<GpioEvent> log;
+	uint8_t levels[PINS] = {};
+	uint8_t modes[PINS] = {};
+	uint32_t writeCostNs = 0;
+
+  public:
+	void write(uint8_t pin, uint8_t level) {
+		getVirtualClock().advanceNanos(writeCostNs);
+		log.push_back({getVirtualClock().nowNanos(), pin, level});
+		if (pin < PINS) {
+			levels[pin] = level;
+		}
+	}
+	uint8_t read(uint8_t pin) const { return pin < PINS ? levels[pin] : 0; }
+
+	void setMode(uint8_t pin, uint8_t mode) {
+		if (pin < PINS) {
+			modes[pin] = mode;
+		}
+	}
+	uint8_t getMode(uint8_t pin) const { return pin < PINS ? modes[pin] : 0; }
+
+	/** Virtual time charged per write */
+	void setWriteCost(uint32_t ns) { writeCostNs = ns; }
+
+	const std::vector<GpioEvent> &events() const { return log; }
+
+	/**
+	 * Times of the low to high transitions of a pin, in ns
+	 * @param from, to Only transitions in [from, to)
+	 */
+	std::vector<uint64_t> risingEdges(uint8_t pin, uint64_t from = 0,
+									  uint64_t to = UINT64_MAX) const {
+		std::vector<uint64_t> edges;
+		uint8_t last = 0;
+		for (const GpioEvent &event : log) {
+			if (event.pin != pin) {
+				continue;
+			}
+			if (event.level && !last && event.time >= from &&
+				event.time < to) {
+				edges.push_back(event.time);
+			}
+			last = event.level;
+		}
+		return edges;
+	}
+
+	PulseStats pulseStats(uint8_t pin, uint64_t from = 0,
+						  uint64_t to = UINT64_MAX) const {
+		return analyzePulses(risingEdges(pin, from, to));
+	}
+
+	/**
+	 * Interval statistics of pulse times given in ns
+	 */
+	static PulseStats analyzePulses(const std::vector<uint64_t> &edges) {
+		PulseStats stats;
+		stats.pulses = edges.size();
+		if (edges.size() < 2) {
+			return stats;
+		}
+		size_t intervals = edges.size() - 1;
+		double sum = 0;
+		double squares = 0;
+		stats.minInterval = INFINITY;
+		for (size_t i = 1; i < edges.size(); i++) {
+			double interval = (edges[i] - edges[i - 1]) / 1000.0;
+			sum += interval;
+			squares += interval * interval;
+			stats.minInterval = fmin(stats.minInterval, interval);
+			stats.maxInterval = fmax(stats.maxInterval, interval);
+		}
+		stats.meanInterval = sum / intervals;
+		double variance =
+			squares / intervals - stats.meanInterval * stats.meanInterval;
+		stats.jitter = variance > 0 ? sqrt(variance) : 0;
+		stats.rate = 1e6 / stats.meanInterval;
+		return stats;
+	}
+
+	/** Forgets the events, keeps levels and modes */
+	void clear() { log.clear(); }
+};
+
+inline GpioTrace &getGpioTrace() {
+	static GpioTrace trace;
+	return trace;
+}
+
+#endif
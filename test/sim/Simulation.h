@@ -0,0 +1,255 @@
+#ifndef _ESPALLON_SIMULATION_H
+#define _ESPALLON_SIMULATION_H
+
+/**
+ * Host simulation of the loop runners (pio test -e native_sim)
+ *
+ * Runs the real StepperRunner, NeopixelRunner, WheelTicker, TimerWheel and
+ * Scheduler on a virtual clock, with stand-ins for the Arduino core,
+ * AccelStepper and Adafruit_NeoPixel from this directory. Nothing here
+ * costs virtual time unless it says so: pin writes (GpioTrace write cost),
+ * busy waits, strip.show(), the run cost of a SimStepper and the cost of a
+ * load task. Pin writes are recorded with their virtual time, so step rate
+ * and jitter come from the pulses the pins would carry.
+ */
+
+#ifndef STEPPER_MAX_STEPPERS
+#define STEPPER_MAX_STEPPERS 8
+#endif
+#ifndef STEPPER_COMMAND_QUEUE_SIZE
+#define STEPPER_COMMAND_QUEUE_SIZE 16
+#endif
+#ifndef STEPPER_STEP_CAPACITY
+#define STEPPER_STEP_CAPACITY 0
+#endif
+#ifndef STEPPER_ADMISSION_CLAMP
+#define STEPPER_ADMISSION_CLAMP 1
+#endif
+#ifndef STEPPER_CAPACITY_SHARE
+#define STEPPER_CAPACITY_SHARE 0.5f
+#endif
+
+#include <AccelStepper.h>
+#include <Adafruit_NeoPixel.h>
+#include <Arduino.h>
+
+#include "../../src/controllers/WheelTicker.h"
+#include "../../src/manager/Clock.h"
+#include "../../src/manager/MotionCommandQueue.h"
+#include "../../src/manager/Scheduler.h"
+#include "../../src/manager/TimerWheel.h"
+#include "../../src/mods/ESPinner_NeoPixel/NeopixelRunner.h"
+#include "../../src/mods/ESPinner_Stepper/StepperMotionState.h"
+#include "../../src/mods/ESPinner_Stepper/StepperRunner.h"
+
+#include <functional>
+
+// The loop singletons read the virtual clock from their first use on
+static const bool simulationClockInstalled = (useVirtualClock(), true);
+
+/**
+ * Stepper of the simulation, run by the StepperRunner
+ *
+ * Runs the StepperMotionState of AccelStepperAdapter: commands queue while
+ * registered and apply at the top of run(), enabled steppers step with
+ * AccelStepper::run(), disabled ones leave the active set, and moves are
+ * admitted with the StepperRunner while they last. run() charges virtual
+ * time for the target's cost of the AccelStepper code, which host time
+ * does not show: runCostNs on every call, plus stepCostNs when it steps
+ * and recomputes the speed.
+ */
+class SimStepper : public IRunnable {
+  public:
+	SimStepper(uint8_t stepPin, uint8_t dirPin, float maxSpeed,
+			   float acceleration, uint32_t runCostNs = 0,
+			   uint32_t stepCostNs = 0)
+		: stepper(AccelStepper::DRIVER, stepPin, dirPin), stepPin(stepPin),
+		  runCostNs(runCostNs), stepCostNs(stepCostNs),
+		  motion(stepper, maxSpeed) {
+		stepper.setMaxSpeed(maxSpeed);
+		stepper.setAcceleration(acceleration);
+		motion.setHandle(StepperRunner::getInstance().registerRunnable(this));
+	}
+
+	SimStepper(const SimStepper &) = delete;
+	SimStepper &operator=(const SimStepper &) = delete;
+
+	~SimStepper() {
+		StepperRunner::getInstance().unregisterRunnable(motion.getHandle());
+	}
+
+	void run() override {
+		getVirtualClock().advanceNanos(runCostNs);
+		motion.drain();
+		if (afterDrain) {
+			std::function<void()> hook = afterDrain;
+			afterDrain = nullptr;
+			hook();
+		}
+		long position = stepper.currentPosition();
+		motion.step(enabled);
+		if (stepper.currentPosition() != position) {
+			getVirtualClock().advanceNanos(stepCostNs);
+		}
+	}
+
+	bool isActive() const override { return motion.isActive(enabled); }
+	String getID() const override {
+		return String("sim ") + String(motion.getHandle());
+	}
+	String getDriverName() const override { return "SIMULATION"; }
+
+	void enable(bool on) {
+		enabled = on;
+		StepperRunner::getInstance().wake(motion.getHandle());
+	}
+
+	bool send(const MotionCommand &command) {
+		return motion.send(command, enabled);
+	}
+
+	/**
+	 * Runs once in the next run(), right after the drain: stands in for a
+	 * UI task sending or enabling while the runner is at that point
+	 */
+	void interleaveAfterDrain(std::function<void()> hook) {
+		afterDrain = hook;
+	}
+
+	/** Read only while the simulation runs */
+	const AccelStepper &getStepper() const { return stepper; }
+	uint8_t getStepPin() const { return stepPin; }
+	bool isRegistered() const { return motion.getHandle() >= 0; }
+
+  private:
+	AccelStepper stepper;
+	uint8_t stepPin;
+	uint32_t runCostNs;
+	uint32_t stepCostNs;
+	bool enabled = false;
+	std::function<void()> afterDrain;
+	StepperMotionState motion;
+};
+
+/**
+ * NeoPixel strip of the simulation, registered with the NeopixelRunner
+ *
+ * Like ESPinner_Neopixel, animation steps fire from a WheelTicker while
+ * the strip is enabled; each step moves a lit pixel and shows the strip.
+ */
+class SimNeopixel : public INeopixelRunnable {
+  public:
+	SimNeopixel(int16_t pin, uint16_t count, uint32_t intervalMs)
+		: strip(count, pin),
+		  ticker([this]() { this->animate(); }, intervalMs, 0, MILLIS) {
+		strip.begin();
+		handle = NeopixelRunner::getInstance().registerRunnable(this);
+	}
+
+	SimNeopixel(const SimNeopixel &) = delete;
+	SimNeopixel &operator=(const SimNeopixel &) = delete;
+
+	~SimNeopixel() { NeopixelRunner::getInstance().unregisterRunnable(handle); }
+
+	void run() override {}
+	bool isActive() const override { return isEnabled(); }
+
+	void enable(bool on) override {
+		INeopixelRunnable::enable(on);
+		if (on) {
+			ticker.start();
+		} else {
+			ticker.stop();
+		}
+	}
+
+	const Adafruit_NeoPixel &getStrip() const { return strip; }
+	uint32_t getSteps() const { return ticker.counter(); }
+
+  private:
+	Adafruit_NeoPixel strip;
+	WheelTicker ticker;
+	NeopixelRunner::Handle handle = -1;
+	uint16_t lit = 0;
+
+	void animate() {
+		if (!isActive()) {
+			return;
+		}
+#if LOOP_PROFILER_ENABLED
+		LoopProfiler::Scope scope(&getLoopProfiler(),
+								  NeopixelRunner::getInstance().getStage(handle));
+#endif
+		strip.clear();
+		strip.setPixelColor(lit, Adafruit_NeoPixel::Color(255, 0, 0));
+		lit = (lit + 1) % (strip.numPixels() > 0 ? strip.numPixels() : 1);
+		strip.show();
+	}
+};
+
+/**
+ * Main loop of the simulation
+ *
+ * A scheduler laid out like registerLoopTasks(): the steppers as the
+ * motion task and the timer wheel as an animation task, plus the load
+ * tasks of a test. Every pass charges passCostNs, the loop overhead of the
+ * core, so virtual time always moves. Admission control is off: a test of
+ * it sets the capacity of the StepperRunner.
+ */
+class Simulation {
+  public:
+	explicit Simulation(uint32_t passCostNs = 1000)
+		: scheduler(clockMicros), passCostNs(passCostNs > 0 ? passCostNs : 1) {
+		useVirtualClock();
+		getGpioTrace().clear();
+		StepperRunner::getInstance().getAdmission().setCapacity(INFINITY);
+		startNanos = getVirtualClock().nowNanos();
+		scheduler.addTask("steppers", TaskClass::Motion,
+						  []() { StepperRunner::getInstance().runAll(); });
+		scheduler.addTask(
+			"timers", TaskClass::Animation,
+			[]() { getTimerWheel().advance(); }, 0, 3000);
+	}
+
+	/**
+	 * Background task that busies the loop, e.g. a websocket burst
+	 * @param costUs Virtual time of one run
+	 * @param periodUs Time between runs, 0 for every pass
+	 */
+	Scheduler::TaskHandle addLoad(const char *name, uint32_t costUs,
+								  uint32_t periodUs) {
+		return scheduler.addTask(
+			name, TaskClass::Background,
+			[costUs]() { getVirtualClock().advance(costUs); }, periodUs,
+			costUs);
+	}
+
+	/**
+	 * Runs loop passes for a duration of virtual time
+	 */
+	void run(uint64_t durationUs) {
+		uint64_t end = getVirtualClock().nowNanos() + durationUs * 1000;
+		while (getVirtualClock().nowNanos() < end) {
+			scheduler.run();
+			getVirtualClock().advanceNanos(passCostNs);
+		}
+	}
+
+	/** Virtual time since the simulation started, in us */
+	uint64_t elapsedMicros() const {
+		return (getVirtualClock().nowNanos() - startNanos) / 1000;
+	}
+	/** Virtual time of a point of the simulation, for GpioTrace queries */
+	uint64_t nanosAt(uint64_t elapsedUs) const {
+		return startNanos + elapsedUs * 1000;
+	}
+
+	Scheduler &getLoop() { return scheduler; }
+
+  private:
+	Scheduler scheduler;
+	uint32_t passCostNs;
+	uint64_t startNanos = 0;
+};
+
+#endif
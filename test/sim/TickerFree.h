@@ -0,0 +1,10 @@
+#ifndef _ESPALLON_SIM_TICKERFREE_H
+#define _ESPALLON_SIM_TICKERFREE_H
+
+/**
+ * TickerFree types used by WheelTicker, for the host simulation
+ */
+enum resolution_t { MICROS, MILLIS, MICROS_MICROS };
+enum status_t { STOPPED, RUNNING, PAUSED };
+
+#endif
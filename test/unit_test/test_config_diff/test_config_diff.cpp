@@ -0,0 +1,97 @@
+/**
+ * Config Diff Unit Test
+ *
+ * This test validates that ESPinner_Manager applies project configurations as
+ * a diff: unchanged ESPinners keep their instance, changed ones are rebuilt
+ * and missing ones are removed.
+ *
+ * Test Steps:
+ * 1. Load a configuration with two GPIO ESPinners
+ * 2. Reload the same configuration and validate no ESPinner is rebuilt
+ * 3. Change one GPIO and validate only that ESPinner is rebuilt
+ * 4. Drop one GPIO and validate it is removed and its pin released
+ */
+
+#include "../../config.h"
+
+#include "../../../src/manager/ESPinner_Manager.h"
+
+String baseConfig = R"([
+	{"ESPinner_Mod": "ESPINNER_GPIO", "ID": "DIFF LED", "ESPINNER_GPIO": 5,
+	 "IO": "OUTPUT"},
+	{"ESPinner_Mod": "ESPINNER_GPIO", "ID": "DIFF BUTTON", "ESPINNER_GPIO": 18,
+	 "IO": "INPUT"}
+])";
+
+String changedConfig = R"([
+	{"ESPinner_Mod": "ESPINNER_GPIO", "ID": "DIFF LED", "ESPINNER_GPIO": 5,
+	 "IO": "OUTPUT"},
+	{"ESPinner_Mod": "ESPINNER_GPIO", "ID": "DIFF BUTTON", "ESPINNER_GPIO": 19,
+	 "IO": "INPUT"}
+])";
+
+String reducedConfig = R"([
+	{"ESPinner_Mod": "ESPINNER_GPIO", "ID": "DIFF LED", "ESPINNER_GPIO": 5,
+	 "IO": "OUTPUT"}
+])";
+
+ESPinner *ledInstance = nullptr;
+ESPinner *buttonInstance = nullptr;
+
+void test_initial_load() {
+	ESPinner_Manager &manager = ESPinner_Manager::getInstance();
+	TEST_ASSERT_TRUE(manager.loadFromJSON(baseConfig));
+	TEST_ASSERT_EQUAL_UINT32(2, manager.espinnerSize());
+
+	ledInstance = manager.findESPinnerById("DIFF LED");
+	buttonInstance = manager.findESPinnerById("DIFF BUTTON");
+	TEST_ASSERT_NOT_NULL(ledInstance);
+	TEST_ASSERT_NOT_NULL(buttonInstance);
+}
+
+void test_same_config_keeps_instances() {
+	ESPinner_Manager &manager = ESPinner_Manager::getInstance();
+	TEST_ASSERT_TRUE(manager.loadFromJSON(baseConfig));
+	TEST_ASSERT_EQUAL_UINT32(2, manager.espinnerSize());
+	TEST_ASSERT_TRUE(ledInstance == manager.findESPinnerById("DIFF LED"));
+	TEST_ASSERT_TRUE(buttonInstance == manager.findESPinnerById("DIFF BUTTON"));
+}
+
+void test_changed_espinner_is_rebuilt() {
+	ESPinner_Manager &manager = ESPinner_Manager::getInstance();
+	TEST_ASSERT_TRUE(manager.loadFromJSON(changedConfig));
+	TEST_ASSERT_EQUAL_UINT32(2, manager.espinnerSize());
+	TEST_ASSERT_TRUE(ledInstance == manager.findESPinnerById("DIFF LED"));
+
+	ESPinner_GPIO *button = static_cast<ESPinner_GPIO *>(
+		manager.findESPinnerById("DIFF BUTTON"));
+	TEST_ASSERT_NOT_NULL(button);
+	TEST_ASSERT_EQUAL_UINT8(19, button->getGPIO());
+}
+
+void test_missing_espinner_is_removed() {
+	ESPinner_Manager &manager = ESPinner_Manager::getInstance();
+	TEST_ASSERT_TRUE(manager.loadFromJSON(reducedConfig));
+	TEST_ASSERT_EQUAL_UINT32(1, manager.espinnerSize());
+	TEST_ASSERT_NULL(manager.findESPinnerById("DIFF BUTTON"));
+	TEST_ASSERT_TRUE(ledInstance == manager.findESPinnerById("DIFF LED"));
+	TEST_ASSERT_FALSE(ESPAllOnPinManager::getInstance().isPinAttached(19));
+}
+
+void setup() {
+	Serial.begin(115200);
+	UNITY_BEGIN();
+
+	ESPinner_Manager::getInstance().clearESPinners();
+
+	RUN_TEST(test_initial_load);
+	RUN_TEST(test_same_config_keeps_instances);
+	RUN_TEST(test_changed_espinner_is_rebuilt);
+	RUN_TEST(test_missing_espinner_is_removed);
+
+	ESPinner_Manager::getInstance().clearESPinners();
+	ESPinner_Manager::getInstance().clearPinConfigInStorage();
+	UNITY_END();
+}
+
+void loop() {}
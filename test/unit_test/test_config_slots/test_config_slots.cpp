@@ -0,0 +1,117 @@
+/**
+ * Config Slots Unit Test
+ *
+ * This test validates the A/B configuration slots used by ESPinner_Manager
+ * to commit the ESPinner configuration without ever overwriting the last
+ * good copy.
+ *
+ * Test Steps:
+ * 1. Validate CRC-32 against the standard check value
+ * 2. Commit twice and validate slots alternate with increasing sequence
+ * 3. Corrupt the active slot and validate boot falls back to the other one
+ * 4. Validate a configuration stored by older firmware is still loaded
+ * 5. Validate a large configuration is stored compressed and loads back
+ */
+
+#include "../../config.h"
+
+#include "../../../src/manager/ESPinner_Manager.h"
+
+String slotTestPath = "slottest";
+IStorageBackend &slotBackend = getStorageBackend();
+
+void test_crc32_check_value() {
+	const char *check = "123456789";
+	TEST_ASSERT_EQUAL_HEX32(
+		0xCBF43926,
+		crc32(reinterpret_cast<const uint8_t *>(check), strlen(check)));
+}
+
+void test_commits_alternate_slots() {
+	ConfigSlots slots(slotBackend, slotTestPath);
+	slots.clear();
+
+	TEST_ASSERT_TRUE(slots.commit("[1]"));
+	int8_t firstSlot = slots.getActiveSlot();
+	TEST_ASSERT_EQUAL_UINT32(1, slots.getSequence());
+
+	TEST_ASSERT_TRUE(slots.commit("[2]"));
+	TEST_ASSERT_NOT_EQUAL(firstSlot, slots.getActiveSlot());
+	TEST_ASSERT_EQUAL_UINT32(2, slots.getSequence());
+
+	ConfigSlots rebooted(slotBackend, slotTestPath);
+	TEST_ASSERT_EQUAL_STRING("[2]", rebooted.load().c_str());
+	TEST_ASSERT_EQUAL_UINT32(2, rebooted.getSequence());
+}
+
+void test_torn_slot_falls_back() {
+	ConfigSlots slots(slotBackend, slotTestPath);
+	slots.load();
+	String activePath = slotTestPath + (slots.getActiveSlot() == 0 ? "_a" : "_b");
+
+	// Simulate a write cut short by a power loss
+	slotBackend.write(activePath.c_str(), std::string("EAS1;3;1234abcd;3;[3"));
+
+	ConfigSlots rebooted(slotBackend, slotTestPath);
+	TEST_ASSERT_EQUAL_STRING("[1]", rebooted.load().c_str());
+	TEST_ASSERT_EQUAL_UINT32(1, rebooted.getSequence());
+
+	// Next commit goes over the torn slot, never over the good one
+	TEST_ASSERT_TRUE(rebooted.commit("[4]"));
+	TEST_ASSERT_EQUAL_UINT32(2, rebooted.getSequence());
+	TEST_ASSERT_EQUAL_STRING("[4]", rebooted.load().c_str());
+}
+
+void test_legacy_configuration_is_loaded() {
+	ConfigSlots slots(slotBackend, slotTestPath);
+	slots.clear();
+	slotBackend.write(slotTestPath.c_str(), std::string("[\"legacy\"]"));
+
+	TEST_ASSERT_EQUAL_STRING("[\"legacy\"]", slots.load().c_str());
+	TEST_ASSERT_EQUAL_INT8(-1, slots.getActiveSlot());
+
+	TEST_ASSERT_TRUE(slots.commit("[5]"));
+	ConfigSlots rebooted(slotBackend, slotTestPath);
+	TEST_ASSERT_EQUAL_STRING("[5]", rebooted.load().c_str());
+}
+
+void test_large_configuration_is_compressed() {
+	String config = "[";
+	for (int i = 0; i < 10; i++) {
+		config += String(i == 0 ? "" : ",") +
+				  "{\"ESPinner_Mod\":\"ESPINNER_GPIO\",\"ID\":\"GPIO" +
+				  String(i) + "\",\"GPIO\":" + String(i + 12) +
+				  ",\"MODE\":\"OUTPUT\"}";
+	}
+	config += "]";
+
+	ConfigSlots slots(slotBackend, slotTestPath);
+	slots.clear();
+	TEST_ASSERT_TRUE(slots.commit(config));
+
+	std::string record;
+	slotBackend.read((slotTestPath + (slots.getActiveSlot() == 0 ? "_a" : "_b"))
+						 .c_str(),
+					 record);
+	TEST_ASSERT_EQUAL_STRING_LEN(CONFIGSLOT_MAGIC_LZSS, record.c_str(), 4);
+	TEST_ASSERT_LESS_THAN_UINT32(config.length(), record.size());
+
+	ConfigSlots rebooted(slotBackend, slotTestPath);
+	TEST_ASSERT_EQUAL_STRING(config.c_str(), rebooted.load().c_str());
+}
+
+void setup() {
+	Serial.begin(115200);
+	UNITY_BEGIN();
+
+	RUN_TEST(test_crc32_check_value);
+	RUN_TEST(test_commits_alternate_slots);
+	RUN_TEST(test_torn_slot_falls_back);
+	RUN_TEST(test_legacy_configuration_is_loaded);
+	RUN_TEST(test_large_configuration_is_compressed);
+
+	ConfigSlots(slotBackend, slotTestPath).clear();
+	UNITY_END();
+}
+
+void loop() {}
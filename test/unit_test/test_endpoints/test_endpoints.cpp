@@ -9,8 +9,10 @@
  * 1. Establish WiFi connection
  * 2. Start web server
  * 3. Send HTTP POST request to /api/config/load with JSON configuration
- * 4. Verify HTTP response is successful
- * 5. Verify ESPinners are loaded correctly
+ * 4. Verify HTTP response is successful and returns a load job id
+ * 5. Run the load job and poll /api/config/status until it finishes
+ * 6. Verify ESPinners are loaded correctly
+ * 7. Verify /api/pins answers 304 while the pin state is unchanged
  */
 
 #include "../../../src/config.h"
@@ -20,6 +22,7 @@
 
 #include "../../../src/controllers/ESPAllOn_Wifi.h"
 #include "../../../src/controllers/Wifi_Controller.h"
+#include "../../../src/manager/ConfigLoad_Manager.h"
 #include "../../../src/mods/ESPinner_Stepper/ESPinner_Stepper.h"
 #include "../../utils/testTicker.h"
 
@@ -63,6 +66,30 @@ void runEndpointsTest() {
 
 TickerFree<> test_runTicker(runEndpointsTest, 3000, 0, MILLIS);
 
+/**
+ * Run a configuration load job as loop() would and read its final status
+ * @param job Job id returned by /api/config/load
+ * @param status Document filled with the /api/config/status response
+ * @return HTTP response code of the status request
+ */
+int runConfigJob(uint32_t job, JsonDocument &status) {
+	while (ConfigLoad_Manager::getInstance().isBusy()) {
+		ConfigLoad_Manager::getInstance().update();
+	}
+
+	String url = "http://" + WiFi.localIP().toString() +
+				 "/api/config/status?job=" + String(job);
+	HTTPClient http;
+	http.begin(url);
+	int httpResponseCode = http.GET();
+	String response = http.getString();
+	DUMPLN("Status response: ", response);
+	http.end();
+
+	deserializeJson(status, response);
+	return httpResponseCode;
+}
+
 /**
  * Test WiFi disconnected state
  * Validates that WiFi is initially disconnected
@@ -124,9 +151,15 @@ void test_endpoint_config_load() {
 	// Verify response indicates success
 	TEST_ASSERT_TRUE_MESSAGE(doc["success"].as<bool>(),
 							 "Response should indicate success");
+	uint32_t job = doc["job"].as<uint32_t>();
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(0, job, "Response should carry a job id");
 
-	// Small delay to ensure configuration is processed
-	delay(500);
+	// Configuration is loaded by the job, not inside the request
+	JsonDocument status;
+	TEST_ASSERT_EQUAL_INT_MESSAGE(200, runConfigJob(job, status),
+								  "Status response should be 200 OK");
+	TEST_ASSERT_EQUAL_STRING_MESSAGE("done", status["stage"].as<const char *>(),
+									 "Load job should finish");
 
 	// Verify ESPinners were loaded
 
@@ -240,10 +273,9 @@ void test_endpoint_invalid_pins() {
 
 	DUMPLN("HTTP Response code: ", httpResponseCode);
 
-	// Should return 400 Bad Request for invalid pins
-	TEST_ASSERT_EQUAL_INT_MESSAGE(
-		400, httpResponseCode,
-		"HTTP response should be 400 Bad Request for invalid pins");
+	// Pins are validated by the load job, the request itself is accepted
+	TEST_ASSERT_EQUAL_INT_MESSAGE(200, httpResponseCode,
+								  "HTTP response should be 200 OK");
 
 	String response = http.getString();
 	DUMPLN("Response: ", response);
@@ -253,23 +285,61 @@ void test_endpoint_invalid_pins() {
 	// Parse response
 	JsonDocument doc;
 	deserializeJson(doc, response);
+	uint32_t job = doc["job"].as<uint32_t>();
 
-	// Verify response indicates failure
-	TEST_ASSERT_FALSE_MESSAGE(doc["success"].as<bool>(),
-							  "Response should indicate failure");
+	// Verify the job fails at the validation stage
+	JsonDocument status;
+	runConfigJob(job, status);
+	TEST_ASSERT_FALSE_MESSAGE(status["success"].as<bool>(),
+							  "Load job should indicate failure");
+	TEST_ASSERT_EQUAL_STRING("failed", status["stage"].as<const char *>());
 
 	// Verify error message mentions pin validation
-	String errorMsg = doc["error"].as<String>();
+	String errorMsg = status["error"].as<String>();
 	TEST_ASSERT_TRUE_MESSAGE(errorMsg.indexOf("Pin validation") >= 0,
 							 "Error message should mention pin validation");
 
 	DUMPSLN("Invalid pins test completed");
 }
 
+/**
+ * Test the pin snapshot ETag
+ * Verifies an unchanged pin state is answered with 304 Not Modified and a
+ * pin change produces a new snapshot
+ */
+void test_endpoint_pins_etag() {
+	String url = "http://" + WiFi.localIP().toString() + "/api/pins";
+	const char *headers[] = {"ETag"};
+
+	HTTPClient http;
+	http.begin(url);
+	http.collectHeaders(headers, 1);
+	TEST_ASSERT_EQUAL_INT(200, http.GET());
+	String etag = http.header("ETag");
+	JsonDocument doc;
+	deserializeJson(doc, http.getString());
+	http.end();
+	TEST_ASSERT_TRUE(etag.length() > 0);
+	TEST_ASSERT_EQUAL_UINT32(ESP_BoardConf::NUM_PINS, doc["pins"].size());
+
+	http.begin(url);
+	http.addHeader("If-None-Match", etag);
+	TEST_ASSERT_EQUAL_INT(304, http.GET());
+	http.end();
+
+	ESPAllOnPinManager::getInstance().reservePin(2);
+	http.begin(url);
+	http.addHeader("If-None-Match", etag);
+	TEST_ASSERT_EQUAL_INT(200, http.GET());
+	http.end();
+	ESPAllOnPinManager::getInstance().releasePin(2);
+}
+
 void isWifiConnected() { RUN_TEST(test_wifi); }
 void testConfigLoadEndpoint() { RUN_TEST(test_endpoint_config_load); }
 void testInvalidJsonEndpoint() { RUN_TEST(test_endpoint_invalid_json); }
 void testInvalidPinsEndpoint() { RUN_TEST(test_endpoint_invalid_pins); }
+void testPinsEndpoint() { RUN_TEST(test_endpoint_pins_etag); }
 
 void setup() {
 	Serial.begin(115200);
@@ -294,6 +364,7 @@ void setup() {
 	testFunctions.push_back(testConfigLoadEndpoint);
 	testFunctions.push_back(testInvalidJsonEndpoint);
 	testFunctions.push_back(testInvalidPinsEndpoint);
+	testFunctions.push_back(testPinsEndpoint);
 
 	// Start WiFi connection and test ticker
 	ESPALLON_Wifi::getInstance().start();
@@ -0,0 +1,151 @@
+/**
+ * Pin Validation Unit Test
+ *
+ * This test validates the schema driven pin validation of project
+ * configurations run before a project is loaded.
+ *
+ * Test Steps:
+ * 1. Validate a project with distinct, capable pins is accepted
+ * 2. Validate two ESPinners claiming one GPIO are rejected
+ * 3. Validate an input only GPIO used as stepper STEP is rejected
+ * 4. Validate an input only GPIO is rejected only as a GPIO OUTPUT
+ * 5. Validate every error of a project is reported at once
+ * 6. Validate "auto" pins are assigned around the fixed ones
+ * 7. Validate a project needing more GPIOs than free is rejected
+ */
+
+#include "../../config.h"
+
+#include "../../../src/manager/ConfigLoad_Manager.h"
+
+bool validate(const char *config, std::vector<String> &errors) {
+	JsonDocument doc;
+	TEST_ASSERT_FALSE(deserializeJson(doc, config));
+	errors.clear();
+	return validateProjectPins(doc.as<JsonArrayConst>(), errors);
+}
+
+void test_valid_project() {
+	std::vector<String> errors;
+	TEST_ASSERT_TRUE(validate(R"([
+		{"ESPinner_Mod": "ESPINNER_GPIO", "ID": "LED", "ESPINNER_GPIO": 5},
+		{"ESPinner_Mod": "ESPINNER_STEPPER", "ID": "AXIS", "STEP": 12,
+		 "DIR": 14, "EN": 27}
+	])", errors));
+	TEST_ASSERT_EQUAL_UINT32(0, errors.size());
+}
+
+void test_shared_gpio_is_rejected() {
+	std::vector<String> errors;
+	TEST_ASSERT_FALSE(validate(R"([
+		{"ESPinner_Mod": "ESPINNER_GPIO", "ID": "LED", "ESPINNER_GPIO": 12},
+		{"ESPinner_Mod": "ESPINNER_STEPPER", "ID": "AXIS", "STEP": 12,
+		 "DIR": 14, "EN": 27}
+	])", errors));
+	TEST_ASSERT_EQUAL_UINT32(1, errors.size());
+	TEST_ASSERT_TRUE(errors[0].indexOf("AXIS") >= 0);
+	TEST_ASSERT_TRUE(errors[0].indexOf("'LED'") >= 0);
+}
+
+void test_input_only_step_is_rejected() {
+#if defined(ESP32) && !defined(CONFIG_IDF_TARGET_ESP32S3) &&                   \
+	!defined(CONFIG_IDF_TARGET_ESP32C3)
+	std::vector<String> errors;
+	TEST_ASSERT_FALSE(validate(R"([
+		{"ESPinner_Mod": "ESPINNER_STEPPER", "ID": "AXIS", "STEP": 34,
+		 "DIR": 14, "EN": 27}
+	])", errors));
+	TEST_ASSERT_EQUAL_UINT32(1, errors.size());
+	TEST_ASSERT_TRUE(errors[0].indexOf("input only") >= 0);
+#endif
+}
+
+void test_input_only_gpio_output_is_rejected() {
+#if defined(ESP32) && !defined(CONFIG_IDF_TARGET_ESP32S3) &&                   \
+	!defined(CONFIG_IDF_TARGET_ESP32C3)
+	std::vector<String> errors;
+	TEST_ASSERT_FALSE(validate(R"([
+		{"ESPinner_Mod": "ESPINNER_GPIO", "ID": "LED", "ESPINNER_GPIO": 35,
+		 "IO": "OUTPUT"}
+	])", errors));
+	TEST_ASSERT_EQUAL_UINT32(1, errors.size());
+	TEST_ASSERT_TRUE(errors[0].indexOf("input only") >= 0);
+
+	TEST_ASSERT_TRUE(validate(R"([
+		{"ESPinner_Mod": "ESPINNER_GPIO", "ID": "BUTTON", "ESPINNER_GPIO": 35,
+		 "IO": "INPUT"}
+	])", errors));
+#endif
+}
+
+void test_all_errors_are_reported() {
+	std::vector<String> errors;
+	TEST_ASSERT_FALSE(validate(R"([
+		{"ESPinner_Mod": "ESPINNER_GPIO", "ID": "FLASH", "ESPINNER_GPIO": 6},
+		{"ESPinner_Mod": "ESPINNER_GPIO", "ID": "ZERO", "ESPINNER_GPIO": 0},
+		{"ESPinner_Mod": "ESPINNER_GPIO", "ID": "FAR", "ESPINNER_GPIO": 99},
+		{"ESPinner_Mod": "ESPINNER_GPIO", "ID": "OK", "ESPINNER_GPIO": 5}
+	])", errors));
+	TEST_ASSERT_EQUAL_UINT32(3, errors.size());
+
+	String joined;
+	JsonDocument doc;
+	deserializeJson(doc, R"([
+		{"ESPinner_Mod": "ESPINNER_GPIO", "ID": "A", "ESPINNER_GPIO": 6},
+		{"ESPinner_Mod": "ESPINNER_GPIO", "ID": "B", "ESPINNER_GPIO": 0}
+	])");
+	TEST_ASSERT_FALSE(validatePinsInConfig(doc.as<JsonArrayConst>(), joined));
+	TEST_ASSERT_TRUE(joined.indexOf("; ") > 0);
+}
+
+void test_auto_pins_are_assigned() {
+	JsonDocument doc;
+	TEST_ASSERT_FALSE(deserializeJson(doc, R"([
+		{"ESPinner_Mod": "ESPINNER_GPIO", "ID": "LED", "ESPINNER_GPIO": 5},
+		{"ESPinner_Mod": "ESPINNER_STEPPER", "ID": "AXIS", "STEP": "auto",
+		 "DIR": "OUTPUT", "EN": 27},
+		{"ESPinner_Mod": "ESPINNER_DC", "ID": "FAN", "ESPINNER_DCA": "PWM",
+		 "ESPINNER_DCB": "auto"}
+	])"));
+	std::vector<String> errors;
+	TEST_ASSERT_TRUE(resolveAutoPins(doc.as<JsonArray>(), errors));
+	TEST_ASSERT_EQUAL_UINT32(0, errors.size());
+	TEST_ASSERT_TRUE(doc[1]["STEP"].is<int>());
+	TEST_ASSERT_TRUE(doc[2]["ESPINNER_DCB"].is<int>());
+	String resolved;
+	serializeJson(doc, resolved);
+	TEST_ASSERT_TRUE(validate(resolved.c_str(), errors));
+}
+
+void test_auto_pins_overflow_is_rejected() {
+	String config = "[";
+	for (int i = 0; i < ESP_BoardConf::NUM_PINS; i++) {
+		config += String(i ? "," : "") +
+				  "{\"ESPinner_Mod\":\"ESPINNER_GPIO\",\"ID\":\"G" +
+				  String(i) + "\",\"ESPINNER_GPIO\":\"auto\"}";
+	}
+	config += "]";
+	JsonDocument doc;
+	TEST_ASSERT_FALSE(deserializeJson(doc, config));
+	std::vector<String> errors;
+	TEST_ASSERT_FALSE(resolveAutoPins(doc.as<JsonArray>(), errors));
+	TEST_ASSERT_TRUE(errors.size() > 0);
+	TEST_ASSERT_TRUE(errors[0].indexOf("no free GPIO") >= 0);
+}
+
+void setup() {
+	Serial.begin(115200);
+	UNITY_BEGIN();
+
+	RUN_TEST(test_valid_project);
+	RUN_TEST(test_shared_gpio_is_rejected);
+	RUN_TEST(test_input_only_step_is_rejected);
+	RUN_TEST(test_input_only_gpio_output_is_rejected);
+	RUN_TEST(test_all_errors_are_reported);
+	RUN_TEST(test_auto_pins_are_assigned);
+	RUN_TEST(test_auto_pins_overflow_is_rejected);
+
+	UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,123 @@
+/**
+ * ESPinner Registry Unit Test
+ *
+ * This test validates the hash-indexed ESPinner registry used by
+ * ESPinner_Manager: ID lookups, handle stability across push replacement and
+ * handle invalidation after detach.
+ *
+ * Test Steps:
+ * 1. Push GPIO and DC ESPinners and validate size and lookups by ID
+ * 2. Replace an ESPinner by pushing the same ID and validate the handle
+ * 3. Detach an ESPinner and validate its handle becomes stale
+ * 4. Push a new ESPinner into the recycled slot and validate old handles
+ * 5. Validate typed views follow push, replacement and detach
+ */
+
+#include "../../config.h"
+
+#include "../../../src/manager/ESPinner_Manager.h"
+
+ESPinnerHandle gpioHandle;
+ESPinnerHandle dcHandle;
+
+void test_push_and_find() {
+	auto espinnerGPIO = std::make_unique<ESPinner_GPIO>();
+	espinnerGPIO->setGPIO(5);
+	espinnerGPIO->setID("REGISTRY GPIO");
+
+	auto espinnerDC = std::make_unique<ESPinner_DC>();
+	espinnerDC->setGPIOA(11);
+	espinnerDC->setGPIOB(12);
+	espinnerDC->setID("REGISTRY DC");
+
+	gpioHandle = ESPinner_Manager::getInstance().push(std::move(espinnerGPIO));
+	dcHandle = ESPinner_Manager::getInstance().push(std::move(espinnerDC));
+
+	TEST_ASSERT_EQUAL_UINT32(2, ESPinner_Manager::getInstance().espinnerSize());
+	TEST_ASSERT_TRUE(gpioHandle.isValid());
+	TEST_ASSERT_TRUE(dcHandle != gpioHandle);
+
+	ESPinner *espinner =
+		ESPinner_Manager::getInstance().findESPinnerById("REGISTRY DC");
+	TEST_ASSERT_NOT_NULL(espinner);
+	TEST_ASSERT_TRUE(espinner->getType() == ESPinner_Mod::DC);
+	TEST_ASSERT_NULL(
+		ESPinner_Manager::getInstance().findESPinnerById("UNKNOWN"));
+}
+
+void test_handle_survives_push_replacement() {
+	auto espinnerGPIO = std::make_unique<ESPinner_GPIO>();
+	espinnerGPIO->setGPIO(18);
+	espinnerGPIO->setID("REGISTRY GPIO");
+	ESPinnerHandle replaced =
+		ESPinner_Manager::getInstance().push(std::move(espinnerGPIO));
+
+	TEST_ASSERT_TRUE(replaced == gpioHandle);
+	TEST_ASSERT_EQUAL_UINT32(2, ESPinner_Manager::getInstance().espinnerSize());
+
+	ESPinner_GPIO *gpio = static_cast<ESPinner_GPIO *>(
+		ESPinner_Manager::getInstance().getESPinner(gpioHandle));
+	TEST_ASSERT_NOT_NULL(gpio);
+	TEST_ASSERT_EQUAL_UINT8(18, gpio->getGPIO());
+}
+
+void test_handle_stale_after_detach() {
+	ESPinner_Manager::getInstance().detach("REGISTRY DC");
+
+	TEST_ASSERT_EQUAL_UINT32(1, ESPinner_Manager::getInstance().espinnerSize());
+	TEST_ASSERT_NULL(ESPinner_Manager::getInstance().getESPinner(dcHandle));
+	TEST_ASSERT_FALSE(
+		ESPinner_Manager::getInstance().findHandleById("REGISTRY DC").isValid());
+}
+
+void test_recycled_slot_keeps_old_handle_stale() {
+	auto espinnerGPIO = std::make_unique<ESPinner_GPIO>();
+	espinnerGPIO->setGPIO(19);
+	espinnerGPIO->setID("REGISTRY GPIO 2");
+	ESPinnerHandle recycled =
+		ESPinner_Manager::getInstance().push(std::move(espinnerGPIO));
+
+	TEST_ASSERT_EQUAL_UINT16(dcHandle.index, recycled.index);
+	TEST_ASSERT_NULL(ESPinner_Manager::getInstance().getESPinner(dcHandle));
+	TEST_ASSERT_NOT_NULL(ESPinner_Manager::getInstance().getESPinner(recycled));
+}
+
+void test_typed_views() {
+	ESPinner_Manager &manager = ESPinner_Manager::getInstance();
+	TEST_ASSERT_EQUAL_UINT32(2, manager.getGPIOs().size());
+	TEST_ASSERT_EQUAL_UINT32(0, manager.getDCs().size());
+
+	auto espinnerDC = std::make_unique<ESPinner_DC>();
+	espinnerDC->setGPIOA(21);
+	espinnerDC->setGPIOB(22);
+	espinnerDC->setID("REGISTRY DC");
+	manager.push(std::move(espinnerDC));
+	TEST_ASSERT_EQUAL_UINT32(1, manager.getDCs().size());
+
+	for (ESPinner_GPIO *gpio : manager.getGPIOs()) {
+		TEST_ASSERT_TRUE(gpio->getType() == ESPinner_Mod::GPIO);
+	}
+
+	manager.detach("REGISTRY GPIO");
+	TEST_ASSERT_EQUAL_UINT32(1, manager.getGPIOs().size());
+	TEST_ASSERT_NULL(manager.findStepperById("REGISTRY DC"));
+}
+
+void setup() {
+	Serial.begin(115200);
+	UNITY_BEGIN();
+
+	ESPinner_Manager::getInstance().clearESPinners();
+
+	RUN_TEST(test_push_and_find);
+	RUN_TEST(test_handle_survives_push_replacement);
+	RUN_TEST(test_handle_stale_after_detach);
+	RUN_TEST(test_recycled_slot_keeps_old_handle_stale);
+	RUN_TEST(test_typed_views);
+
+	ESPinner_Manager::getInstance().clearESPinners();
+	ESPinner_Manager::getInstance().clearPinConfigInStorage();
+	UNITY_END();
+}
+
+void loop() {}
@@ -28,7 +28,7 @@ std::list<std::unique_ptr<ESPinner>> ESPinnerTestList;
  * Validates that previously saved ESPinner configurations are present
  */
 void test_is_there_espinner_in_file() {
-	bool isThereAnyESPinner = isThereAnyInfoInNVS(ESPinner_Path);
+	bool isThereAnyESPinner = ESPinner_Manager::getInstance().hasConfigInStorage();
 	TEST_ASSERT_TRUE(isThereAnyESPinner);
 }
 
@@ -37,7 +37,7 @@ void test_is_there_espinner_in_file() {
  * Validates that storage is empty after cleanup operations
  */
 void test_not_any_espinner_in_file() {
-	bool isThereAnyESPinner = isThereAnyInfoInNVS(ESPinner_Path);
+	bool isThereAnyESPinner = ESPinner_Manager::getInstance().hasConfigInStorage();
 	TEST_ASSERT_FALSE(isThereAnyESPinner);
 }
 
@@ -0,0 +1,78 @@
+/**
+ * Storage Backends Unit Test
+ *
+ * This test validates the NVS, LittleFS and memory storage backends on the
+ * board and benchmarks them with configuration sized payloads, so the
+ * backend of a deployment (-D STORAGE_BACKEND=...) can be chosen on data.
+ *
+ * Test Steps:
+ * 1. Write, read and remove a key on each backend
+ * 2. Validate usage introspection reports a capacity
+ * 3. Benchmark read and write latency per backend and payload size
+ */
+
+#include "../../config.h"
+
+#include "../../../src/manager/ESPinner_Manager.h"
+
+#include "../../utils/storage_benchmark.h"
+
+NVSStorageBackend nvsBackend;
+LittleFSStorageBackend littleFSBackend;
+MemoryStorageBackend memoryBackend;
+IStorageBackend *backends[] = {&nvsBackend, &littleFSBackend, &memoryBackend};
+
+uint32_t boardMicros() { return micros(); }
+
+void test_backends_roundtrip() {
+	for (IStorageBackend *backend : backends) {
+		TEST_ASSERT_TRUE_MESSAGE(backend->begin(), backend->name());
+		TEST_ASSERT_TRUE(backend->write("roundtrip", std::string("[1,2,3]")));
+
+		std::string value;
+		TEST_ASSERT_TRUE(backend->read("roundtrip", value));
+		TEST_ASSERT_EQUAL_STRING("[1,2,3]", value.c_str());
+
+		backend->remove("roundtrip");
+		TEST_ASSERT_FALSE(backend->exists("roundtrip"));
+	}
+}
+
+void test_flash_backends_report_capacity() {
+#if defined(ESP32)
+	StorageUsage nvsInfo = nvsBackend.usage();
+	TEST_ASSERT_GREATER_THAN_UINT32(0, nvsInfo.totalBytes);
+	TEST_ASSERT_LESS_OR_EQUAL_UINT32(nvsInfo.totalBytes, nvsInfo.usedBytes);
+#endif
+
+	StorageUsage fsInfo = littleFSBackend.usage();
+	TEST_ASSERT_GREATER_THAN_UINT32(0, fsInfo.totalBytes);
+	TEST_ASSERT_LESS_OR_EQUAL_UINT32(fsInfo.totalBytes, fsInfo.usedBytes);
+}
+
+void test_benchmark_backends() {
+	for (IStorageBackend *backend : backends) {
+		for (size_t i = 0; i < storageBenchmarkSizeCount; i++) {
+			StorageBenchmarkResult result = benchmarkStorage(
+				*backend, storageBenchmarkSizes[i], 20, boardMicros);
+			char report[160];
+			formatStorageBenchmark(report, sizeof(report), backend->name(),
+								   result);
+			TEST_MESSAGE(report);
+			TEST_ASSERT_TRUE_MESSAGE(result.valid, report);
+		}
+	}
+}
+
+void setup() {
+	Serial.begin(115200);
+	UNITY_BEGIN();
+
+	RUN_TEST(test_backends_roundtrip);
+	RUN_TEST(test_flash_backends_report_capacity);
+	RUN_TEST(test_benchmark_backends);
+
+	UNITY_END();
+}
+
+void loop() {}
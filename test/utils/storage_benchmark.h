@@ -0,0 +1,102 @@
+/**
+ * Storage Benchmark Utilities
+ *
+ * Measures write and read latency and throughput of an IStorageBackend for
+ * configuration sized payloads. Shared by the native and on-device storage
+ * backend tests; the caller provides the microsecond clock.
+ */
+
+#ifndef _ESPALLON_STORAGE_BENCHMARK_H
+#define _ESPALLON_STORAGE_BENCHMARK_H
+
+#include "../../src/manager/StorageBackend.h"
+
+#include <stdio.h>
+#include <string>
+
+// Typical serialized configurations: one ESPinner, a small and a full project
+const size_t storageBenchmarkSizes[] = {256, 1024, 3072};
+const size_t storageBenchmarkSizeCount =
+	sizeof(storageBenchmarkSizes) / sizeof(storageBenchmarkSizes[0]);
+
+struct StorageBenchmarkResult {
+	size_t size = 0;
+	uint16_t iterations = 0;
+	uint32_t writeUs = 0; // Total time spent writing
+	uint32_t readUs = 0;  // Total time spent reading
+	bool valid = false;	  // Every write succeeded and read back equal
+};
+
+/**
+ * Build a JSON array shaped like a stored configuration
+ */
+std::string makeBenchmarkPayload(size_t size) {
+	const char *entry = "{\"ESPinner_Mod\":\"ESPINNER_GPIO\",\"ID\":\"GPIO\","
+						"\"GPIO\":5,\"MODE\":\"OUTPUT\"},";
+	std::string payload = "[";
+	while (payload.size() < size) {
+		payload += entry;
+	}
+	payload.resize(size - 1);
+	payload += "]";
+	return payload;
+}
+
+StorageBenchmarkResult benchmarkStorage(IStorageBackend &backend, size_t size,
+										uint16_t iterations,
+										uint32_t (*clockMicros)()) {
+	StorageBenchmarkResult result;
+	result.size = size;
+	result.iterations = iterations;
+	result.valid = true;
+
+	const char *key = "bench";
+	std::string payload = makeBenchmarkPayload(size);
+	std::string readBack;
+
+	uint32_t start = clockMicros();
+	for (uint16_t i = 0; i < iterations; i++) {
+		// Change one byte so backends cannot skip unchanged writes
+		payload[1] = 'a' + (i % 26);
+		result.valid &= backend.write(key, payload);
+	}
+	result.writeUs = clockMicros() - start;
+
+	start = clockMicros();
+	for (uint16_t i = 0; i < iterations; i++) {
+		result.valid &= backend.read(key, readBack);
+	}
+	result.readUs = clockMicros() - start;
+
+	result.valid &= readBack == payload;
+	backend.remove(key);
+	return result;
+}
+
+double storageLatency(const StorageBenchmarkResult &result, uint32_t totalUs) {
+	return static_cast<double>(totalUs) / result.iterations;
+}
+
+/**
+ * Throughput in KiB/s over all iterations
+ */
+double storageThroughput(const StorageBenchmarkResult &result,
+						 uint32_t totalUs) {
+	if (totalUs == 0) {
+		return 0;
+	}
+	return (result.size * result.iterations / 1024.0) / (totalUs / 1000000.0);
+}
+
+void formatStorageBenchmark(char *out, size_t capacity, const char *name,
+							const StorageBenchmarkResult &result) {
+	snprintf(out, capacity,
+			 "%s %u B: write %.1f us (%.0f KiB/s) read %.1f us (%.0f KiB/s)",
+			 name, static_cast<unsigned>(result.size),
+			 storageLatency(result, result.writeUs),
+			 storageThroughput(result, result.writeUs),
+			 storageLatency(result, result.readUs),
+			 storageThroughput(result, result.readUs));
+}
+
+#endif
@@ -0,0 +1,53 @@
+"""
+PlatformIO pre script: store LittleFS web assets gzip compressed.
+
+When the filesystem image is built (buildfs / uploadfs), data/ is staged in
+the build directory. Text assets are replaced by "<name>.gz" and the image is
+built from the staging directory. AsyncWebServer serves "<name>.gz" with
+"Content-Encoding: gzip" when "<name>" is requested, both from ESPUI's static
+handler and from the ESPAllOn asset routes.
+
+Usage in platformio.ini:
+    extra_scripts = pre:tools/compress_data.py
+"""
+
+import gzip
+import os
+import shutil
+
+Import("env")  # noqa: F821
+
+COMPRESSED_TYPES = (".htm", ".html", ".css", ".js", ".json", ".svg")
+FS_TARGETS = ("buildfs", "uploadfs", "uploadfsota")
+
+
+def stage_data(source, target):
+    if os.path.isdir(target):
+        shutil.rmtree(target)
+    saved = 0
+    for root, _, files in os.walk(source):
+        destination = os.path.join(target, os.path.relpath(root, source))
+        os.makedirs(destination, exist_ok=True)
+        for name in files:
+            path = os.path.join(root, name)
+            if not name.lower().endswith(COMPRESSED_TYPES):
+                shutil.copy2(path, destination)
+                continue
+            with open(path, "rb") as original:
+                content = original.read()
+            compressed = gzip.compress(content, compresslevel=9, mtime=0)
+            if len(compressed) >= len(content):
+                shutil.copy2(path, destination)
+                continue
+            with open(os.path.join(destination, name + ".gz"), "wb") as out:
+                out.write(compressed)
+            saved += len(content) - len(compressed)
+    return saved
+
+
+if any(target in FS_TARGETS for target in COMMAND_LINE_TARGETS):  # noqa: F821
+    data_dir = env.subst("$PROJECT_DATA_DIR")  # noqa: F821
+    staging_dir = os.path.join(env.subst("$BUILD_DIR"), "data_gz")  # noqa: F821
+    saved = stage_data(data_dir, staging_dir)
+    print("Compressed web assets into %s (%d bytes saved)" % (staging_dir, saved))
+    env.Replace(PROJECT_DATA_DIR=staging_dir)  # noqa: F821